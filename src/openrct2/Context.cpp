@@ -207,6 +207,7 @@ namespace OpenRCT2
 #endif
 
             GameActions::ClearQueue();
+            ScenarioWaitForAutosave();
             _replayManager->StopRecording(true);
 #ifndef DISABLE_NETWORK
             _network.Close();
@@ -1280,6 +1281,8 @@ namespace OpenRCT2
             {
                 RunFixedFrame(deltaTime);
             }
+
+            Profiling::EndFrame();
         }
 
         void UpdateTimeAccumulators(float deltaTime)
@@ -82,6 +82,7 @@ uint16_t gCurrentDeltaTime;
 uint8_t gGamePaused = 0;
 int32_t gGameSpeed = 1;
 bool gDoSingleUpdate = false;
+bool gFastForward = false;
 float gDayNightCycle = 0;
 bool gInUpdateCode = false;
 bool gInMapInitCode = false;
@@ -280,9 +281,10 @@ static void FixInvalidSurfaces()
     // Fixes broken saves where a surface element could be null
     // and broken saves with incorrect invisible map border tiles
 
-    for (int32_t y = 0; y < kMaximumMapSizeTechnical; y++)
+    const auto mapSize = GetGameState().MapSize;
+    for (int32_t y = 0; y < mapSize.y; y++)
     {
-        for (int32_t x = 0; x < kMaximumMapSizeTechnical; x++)
+        for (int32_t x = 0; x < mapSize.x; x++)
         {
             auto* surfaceElement = MapGetSurfaceElementAt(TileCoordsXY{ x, y });
 
@@ -565,14 +567,15 @@ static void LimitAutosaveCount(const size_t numberOfFilesToKeep, bool processLan
 
 void GameAutosave()
 {
+    // The previous autosave may still be written to one of the files that are about to be removed or copied.
+    ScenarioWaitForAutosave();
+
     auto subDirectory = DIRID::SAVE;
     const char* fileExtension = ".park";
-    uint32_t saveFlags = 0x80000000;
     if (gScreenFlags & SCREEN_FLAGS_EDITOR)
     {
         subDirectory = DIRID::LANDSCAPE;
         fileExtension = ".park";
-        saveFlags |= 2;
     }
 
     // Retrieve current time
@@ -602,7 +605,7 @@ void GameAutosave()
 
     auto& gameState = GetGameState();
 
-    if (!ScenarioSave(gameState, path, saveFlags))
+    if (!ScenarioAutosave(gameState, path))
         Console::Error::WriteLine("Could not autosave the scenario. Is the save folder writeable?");
 }
 
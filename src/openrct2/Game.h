@@ -139,6 +139,8 @@ extern uint16_t gCurrentDeltaTime;
 extern uint8_t gGamePaused;
 extern int32_t gGameSpeed;
 extern bool gDoSingleUpdate;
+// Skips the parts of the update that only feed the audio and the user interface.
+extern bool gFastForward;
 extern float gDayNightCycle;
 extern bool gInUpdateCode;
 extern bool gInMapInitCode;
@@ -16,11 +16,14 @@
 #include "ReplayManager.h"
 #include "actions/GameAction.h"
 #include "config/Config.h"
+#include "core/TickArena.h"
+#include "entity/EntityList.h"
 #include "entity/EntityTweener.h"
 #include "entity/PatrolArea.h"
 #include "interface/Screenshot.h"
 #include "platform/Platform.h"
 #include "profiling/Profiling.h"
+#include "profiling/TickTimeline.h"
 #include "ride/Vehicle.h"
 #include "scenes/title/TitleScene.h"
 #include "scenes/title/TitleSequencePlayer.h"
@@ -28,6 +31,7 @@
 #include "ui/UiContext.h"
 #include "windows/Intent.h"
 #include "world/Scenery.h"
+#include "world/TileChanges.h"
 
 using namespace OpenRCT2::Scripting;
 
@@ -177,6 +181,7 @@ namespace OpenRCT2
 
                 // Post-tick game actions.
                 GameActions::ProcessQueue();
+                TileChanges::Publish();
             }
         }
 
@@ -242,7 +247,12 @@ namespace OpenRCT2
     {
         PROFILED_FUNCTION();
 
+        using namespace Profiling;
+        TickTimeline::BeginTick(GetGameState().CurrentTicks);
+        TickTimeline::BeginPhase(TickTimeline::Phase::Network);
+
         gInUpdateCode = true;
+        TickArena::BeginTick();
 
         gScreenAge++;
         if (gScreenAge == 0)
@@ -269,6 +279,7 @@ namespace OpenRCT2
             // Don't run past the server, this condition can happen during map changes.
             if (NetworkGetServerTick() == gameState.CurrentTicks)
             {
+                TickArena::EndTick();
                 gInUpdateCode = false;
                 return;
             }
@@ -295,43 +306,67 @@ namespace OpenRCT2
         auto day = gameState.Date.GetDay();
 #endif
 
+        TickTimeline::BeginPhase(TickTimeline::Phase::Date);
         DateUpdate(gameState);
 
         ScenarioUpdate(gameState);
+        TickTimeline::BeginPhase(TickTimeline::Phase::Climate);
         ClimateUpdate();
+        TickTimeline::BeginPhase(TickTimeline::Phase::MapTiles);
+        MapCompactTileElementsStep();
         MapUpdateTiles();
 
         // Temporarily remove provisional paths to prevent peep from interacting with them
-        auto removeProvisionalIntent = Intent(INTENT_ACTION_REMOVE_PROVISIONAL_ELEMENTS);
-        ContextBroadcastIntent(&removeProvisionalIntent);
+        TickTimeline::BeginPhase(TickTimeline::Phase::Peeps);
+        // The intents are kept around as constructing them can allocate.
+        static auto removeProvisionalIntent = Intent(INTENT_ACTION_REMOVE_PROVISIONAL_ELEMENTS);
+        static auto restoreProvisionalIntent = Intent(INTENT_ACTION_RESTORE_PROVISIONAL_ELEMENTS);
+        if (!gFastForward)
+        {
+            ContextBroadcastIntent(&removeProvisionalIntent);
+        }
 
         MapUpdatePathWideFlags();
         PeepUpdateAll();
-        auto restoreProvisionalIntent = Intent(INTENT_ACTION_RESTORE_PROVISIONAL_ELEMENTS);
-        ContextBroadcastIntent(&restoreProvisionalIntent);
+        if (!gFastForward)
+        {
+            ContextBroadcastIntent(&restoreProvisionalIntent);
+        }
+        TickTimeline::BeginPhase(TickTimeline::Phase::Vehicles);
         VehicleUpdateAll();
+        TickTimeline::BeginPhase(TickTimeline::Phase::MiscEntities);
         UpdateAllMiscEntities();
+        TickTimeline::BeginPhase(TickTimeline::Phase::Rides);
         Ride::UpdateAll();
 
+        TickTimeline::BeginPhase(TickTimeline::Phase::Park);
         if (!(gScreenFlags & SCREEN_FLAGS_EDITOR))
         {
             Park::Update(gameState, gameState.Date);
         }
 
+        TickTimeline::BeginPhase(TickTimeline::Phase::Research);
         ResearchUpdate();
+        TickTimeline::BeginPhase(TickTimeline::Phase::RideRatings);
         RideRatingsUpdateAll();
         RideMeasurementsUpdate();
+        TickTimeline::BeginPhase(TickTimeline::Phase::Presentation);
         News::UpdateCurrentItem();
 
+        // Map animations also advance clocks, photo timeouts and wall frames, so they run even when fast-forwarding.
         MapAnimationInvalidateAll();
-        VehicleSoundsUpdate();
-        PeepUpdateCrowdNoise();
-        ClimateUpdateSound();
-        EditorOpenWindowsForCurrentStep();
+        if (!gFastForward)
+        {
+            VehicleSoundsUpdate();
+            PeepUpdateCrowdNoise();
+            ClimateUpdateSound();
+            EditorOpenWindowsForCurrentStep();
+        }
 
         // Update windows
         // WindowDispatchUpdateAll();
 
+        TickTimeline::BeginPhase(TickTimeline::Phase::SpatialIndex);
         UpdateEntitiesSpatialIndex();
 
         // Start autosave timer after update
@@ -340,6 +375,7 @@ namespace OpenRCT2
             gLastAutoSaveUpdate = Platform::GetTicks();
         }
 
+        TickTimeline::BeginPhase(TickTimeline::Phase::GameActions);
         GameActions::ProcessQueue();
 
         NetworkProcessPending();
@@ -348,6 +384,7 @@ namespace OpenRCT2
         gameState.CurrentTicks++;
 
 #ifdef ENABLE_SCRIPTING
+        TickTimeline::BeginPhase(TickTimeline::Phase::Scripting);
         auto& hookEngine = GetContext()->GetScriptEngine().GetHookEngine();
         hookEngine.Call(HOOK_TYPE::INTERVAL_TICK, true);
 
@@ -357,6 +394,15 @@ namespace OpenRCT2
         }
 #endif
 
+        if (TickTimeline::IsRecording())
+        {
+            TickTimeline::EndTick({ GetEntityListCount(EntityType::Guest), GetEntityListCount(EntityType::Staff),
+                                    GetEntityListCount(EntityType::Vehicle), GetMiscEntityCount() });
+        }
+
+        TileChanges::Publish();
+
+        TickArena::EndTick();
         gInUpdateCode = false;
     }
 } // namespace OpenRCT2
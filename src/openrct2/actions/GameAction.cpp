@@ -27,6 +27,7 @@
 #include "../scripting/ScriptEngine.h"
 #include "../ui/UiContext.h"
 #include "../ui/WindowManager.h"
+#include "../world/Map.h"
 #include "../world/Park.h"
 #include "../world/Scenery.h"
 
@@ -357,6 +358,7 @@ namespace OpenRCT2::GameActions
 
             // Execute the action, changing the game state
             result = action->Execute();
+            MapInvalidateElementCaches();
 #ifdef ENABLE_SCRIPTING
             if (result.Error == GameActions::Status::Ok)
             {
@@ -17,6 +17,8 @@
 #include "../windows/Intent.h"
 #include "../world/Park.h"
 
+#include <algorithm>
+
 using namespace OpenRCT2;
 
 MapChangeSizeAction::MapChangeSizeAction(const TileCoordsXY& targetSize)
@@ -60,7 +62,9 @@ GameActions::Result MapChangeSizeAction::Query() const
 GameActions::Result MapChangeSizeAction::Execute() const
 {
     auto& gameState = GetGameState();
-    // Expand map
+    // Expand map, the new tiles have to be stored before the boundary is extended into them
+    ResizeTileElements(
+        { std::max(_targetSize.x, gameState.MapSize.x), std::max(_targetSize.y, gameState.MapSize.y) });
     while (_targetSize.x > gameState.MapSize.x)
     {
         gameState.MapSize.x++;
@@ -80,6 +84,7 @@ GameActions::Result MapChangeSizeAction::Execute() const
     {
         gameState.MapSize = _targetSize;
         MapRemoveOutOfRangeElements();
+        ResizeTileElements(_targetSize);
     }
 
     auto* ctx = OpenRCT2::GetContext();
@@ -11,6 +11,7 @@
 
 #include "../Diagnostic.h"
 #include "../interface/Window.h"
+#include "../ride/RideOccupancy.h"
 
 using namespace OpenRCT2;
 
@@ -61,6 +62,7 @@ GameActions::Result RideFreezeRatingAction::Execute() const
     {
         case RideRatingType::Excitement:
             ride->ratings.excitement = _value;
+            RideOccupancy::InvalidateTallRides();
             break;
         case RideRatingType::Intensity:
             ride->ratings.intensity = _value;
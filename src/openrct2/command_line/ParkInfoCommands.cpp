@@ -9,13 +9,19 @@
 
 #include "../Context.h"
 #include "../FileClassifier.h"
+#include "../OpenRCT2.h"
 #include "../ParkImporter.h"
 #include "../core/Console.hpp"
 #include "../core/FileStream.h"
 #include "../core/Path.hpp"
 #include "../object/ObjectRepository.h"
+#include "../ride/Ride.h"
+#include "../ride/RideData.h"
+#include "../ride/RideRatings.h"
 #include "CommandLine.hpp"
 
+#include <vector>
+
 using namespace OpenRCT2;
 
 // clang-format off
@@ -25,10 +31,12 @@ static constexpr CommandLineOptionDefinition NoOptions[]
 };
 
 static exitcode_t HandleObjectsInfo(CommandLineArgEnumerator *argEnumerator);
+static exitcode_t HandleRatingsInfo(CommandLineArgEnumerator *argEnumerator);
 
 const CommandLineCommand CommandLine::ParkInfoCommands[]{
     // Main commands
     DefineCommand("objects", "<savefile>", NoOptions, HandleObjectsInfo),
+    DefineCommand("ratings", "<savefile>", NoOptions, HandleRatingsInfo),
 
     kCommandTableEnd
 };
@@ -145,3 +153,54 @@ static exitcode_t HandleObjectsInfo(CommandLineArgEnumerator* argEnumerator)
     }
     return EXITCODE_OK;
 }
+
+static exitcode_t HandleRatingsInfo(CommandLineArgEnumerator* argEnumerator)
+{
+    exitcode_t result = CommandLine::HandleCommandDefault();
+    if (result != EXITCODE_CONTINUE)
+    {
+        return result;
+    }
+
+    const utf8* rawSourcePath;
+    if (!argEnumerator->TryPopString(&rawSourcePath))
+    {
+        Console::Error::WriteLine("Expected a source save file path.");
+        return EXITCODE_FAIL;
+    }
+
+    auto sourcePath = Path::GetAbsolute(rawSourcePath);
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    auto context = OpenRCT2::CreateContext();
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+
+    if (!context->LoadParkFromFile(sourcePath))
+    {
+        Console::Error::WriteLine("Unable to load park.");
+        return EXITCODE_FAIL;
+    }
+
+    // Recalculate instead of trusting the ratings stored in the park, they may have been made by an older version.
+    std::vector<RideId> rides;
+    for (const auto& ride : GetRideManager())
+    {
+        rides.push_back(ride.id);
+    }
+    RideRatingsUpdateRides(rides);
+
+    for (const auto& ride : GetRideManager())
+    {
+        Console::WriteLine(
+            "%d|%s|%s|%d|%d|%d", ride.id.ToUnderlying(), ride.GetName().c_str(), ride.GetRideTypeDescriptor().EnumName,
+            static_cast<int>(ride.ratings.excitement), static_cast<int>(ride.ratings.intensity),
+            static_cast<int>(ride.ratings.nausea));
+    }
+    return EXITCODE_OK;
+}
@@ -18,6 +18,7 @@
 #include "../core/Memory.hpp"
 #include "../core/Path.hpp"
 #include "../core/String.hpp"
+#include "../entity/EntityRegistry.h"
 #include "../localisation/Language.h"
 #include "../network/network.h"
 #include "../object/ObjectRepository.h"
@@ -57,6 +58,7 @@ static bool _about = false;
 static bool _verbose = false;
 static bool _headless = false;
 static bool _silentReplays = false;
+static bool _parallelUpdate = false;
 static u8string _password = {};
 static u8string _userDataPath = {};
 static u8string _openrct2DataPath = {};
@@ -75,6 +77,7 @@ static constexpr CommandLineOptionDefinition StandardOptions[]
     { CMDLINE_TYPE_SWITCH,  &_verbose,          NAC, "verbose",            "log verbose messages"                                       },
     { CMDLINE_TYPE_SWITCH,  &_headless,         NAC, "headless",           "run " OPENRCT2_NAME " headless" IMPLIES_SILENT_BREAKPAD     },
     { CMDLINE_TYPE_SWITCH,  &_silentReplays,    NAC, "silent-replays",     "use unobtrusive replays"                                    },
+    { CMDLINE_TYPE_SWITCH,  &_parallelUpdate,   NAC, "parallel-update",    "update entities on multiple threads"                        },
 #ifndef DISABLE_NETWORK
     { CMDLINE_TYPE_INTEGER, &_port,             NAC, "port",               "port to use for hosting or joining a server"                },
     { CMDLINE_TYPE_STRING,  &_address,          NAC, "address",            "address to listen on when hosting a server"                 },
@@ -201,6 +204,11 @@ exitcode_t CommandLine::HandleCommandDefault()
     gOpenRCT2NoGraphics = _headless;
     gOpenRCT2SilentBreakpad = _silentBreakpad || _headless;
 
+    if (_parallelUpdate)
+    {
+        EntitySetUpdateMode(EntityUpdateMode::Parallel);
+    }
+
     if (!_userDataPath.empty())
     {
         gCustomUserDataPath = Path::GetAbsolute(_userDataPath);
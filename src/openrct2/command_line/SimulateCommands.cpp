@@ -13,23 +13,136 @@
 #include "../OpenRCT2.h"
 #include "../config/ConfigTypes.h"
 #include "../core/Console.hpp"
+#include "../core/Path.hpp"
 #include "../entity/EntityRegistry.h"
 #include "../network/network.h"
 #include "../platform/Platform.h"
+#include "../profiling/TickTimeline.h"
+#include "../scenario/Scenario.h"
 #include "CommandLine.hpp"
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
+#include <string>
+#include <vector>
 
 using namespace OpenRCT2;
 
+static bool _fast = false;
+static int32_t _saveEvery = 0;
+static u8string _saveDirectory = {};
+static int32_t _reportEvery = 0;
+static u8string _timelinePath = {};
+static bool _parallel = false;
+static bool _compare = false;
+
+// clang-format off
+static constexpr CommandLineOptionDefinition SimulateOptions[]
+{
+    { CMDLINE_TYPE_SWITCH,  &_fast,          NAC, "fast",         "skip the work that only feeds the audio and the user interface"               },
+    { CMDLINE_TYPE_INTEGER, &_saveEvery,     NAC, "save-every",   "save the park every given number of ticks"                                    },
+    { CMDLINE_TYPE_STRING,  &_saveDirectory, NAC, "save-dir",     "directory to write the periodic saves to"                                     },
+    { CMDLINE_TYPE_INTEGER, &_reportEvery,   NAC, "report-every", "print the simulation speed every given number of ticks"                       },
+    { CMDLINE_TYPE_STRING,  &_timelinePath,  NAC, "timeline",     "write the time spent in each phase of the last ticks to a .json or .csv file" },
+    { CMDLINE_TYPE_SWITCH,  &_parallel,      NAC, "parallel",     "update entities on multiple threads"                                          },
+    { CMDLINE_TYPE_SWITCH,  &_compare,       NAC, "compare",      "run the serial and the parallel update and compare the entity checksums"      },
+    kOptionTableEnd
+};
+// clang-format on
+
 static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator);
 
 const CommandLineCommand CommandLine::SimulateCommands[]{ // Main commands
-                                                          DefineCommand("", "<ticks>", nullptr, HandleSimulate),
+                                                          DefineCommand("", "<ticks>", SimulateOptions, HandleSimulate),
                                                           kCommandTableEnd
 };
 
+static void ReportSpeed(uint32_t ticks, uint32_t elapsedMs)
+{
+    const auto seconds = std::max(elapsedMs, 1u) / 1000.0;
+    const auto ticksPerSecond = ticks / seconds;
+    Console::WriteLine(
+        "%u ticks in %.2f s: %.0f ticks/s, %.1fx realtime", ticks, seconds, ticksPerSecond, ticksPerSecond / kGameUpdateFPS);
+}
+
+static bool SavePark(const char* inputPath, uint32_t tick)
+{
+    auto name = Path::GetFileNameWithoutExtension(inputPath) + "-" + std::to_string(tick) + ".park";
+    auto path = name;
+    if (!_saveDirectory.empty())
+    {
+        Path::CreateDirectory(_saveDirectory);
+        path = Path::Combine(_saveDirectory, name);
+    }
+
+    // Save the same way autosaves do.
+    uint32_t saveFlags = 0x80000000;
+    if (!ScenarioSave(GetGameState(), path, saveFlags))
+    {
+        Console::Error::WriteLine("Could not save the park to %s.", path.c_str());
+        return false;
+    }
+    Console::WriteLine("Saved %s", path.c_str());
+    return true;
+}
+
+/**
+ * Loads the park and runs it for the given number of ticks, the entity checksum after every tick is added to checksums
+ * if given.
+ */
+static bool Simulate(
+    IContext& context, const char* inputPath, uint32_t ticks, EntityUpdateMode mode,
+    std::vector<EntitiesChecksum>* checksums)
+{
+    EntitySetUpdateMode(mode);
+    if (!context.LoadParkFromFile(inputPath))
+    {
+        return false;
+    }
+
+    if (!_timelinePath.empty())
+    {
+        Profiling::TickTimeline::Start();
+    }
+
+    Console::WriteLine("Running %d ticks...", ticks);
+    const auto startTime = Platform::GetTicks();
+    auto reportTime = startTime;
+    for (uint32_t i = 1; i <= ticks; i++)
+    {
+        gameStateUpdateLogic();
+        if (checksums != nullptr)
+        {
+            checksums->push_back(GetAllEntitiesChecksum());
+        }
+
+        if (_saveEvery > 0 && i % _saveEvery == 0 && !SavePark(inputPath, i))
+        {
+            return false;
+        }
+        if (_reportEvery > 0 && i % _reportEvery == 0)
+        {
+            const auto now = Platform::GetTicks();
+            ReportSpeed(_reportEvery, now - reportTime);
+            reportTime = now;
+        }
+    }
+    ReportSpeed(ticks, Platform::GetTicks() - startTime);
+
+    if (!_timelinePath.empty())
+    {
+        Profiling::TickTimeline::Stop();
+        if (!Profiling::TickTimeline::Export(_timelinePath))
+        {
+            Console::Error::WriteLine("Could not write the tick timeline to %s.", _timelinePath.c_str());
+            return false;
+        }
+        Console::WriteLine("Wrote the tick timeline to %s", _timelinePath.c_str());
+    }
+    return true;
+}
+
 static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator)
 {
     const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
@@ -45,6 +158,7 @@ static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator)
     uint32_t ticks = atol(argv[1]);
 
     gOpenRCT2Headless = true;
+    gFastForward = _fast;
 
 #ifndef DISABLE_NETWORK
     gNetworkStart = NETWORK_MODE_SERVER;
@@ -53,15 +167,38 @@ static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator)
     std::unique_ptr<IContext> context(CreateContext());
     if (context->Initialise())
     {
-        if (!context->LoadParkFromFile(inputPath))
+        if (!_compare)
         {
-            return EXITCODE_FAIL;
+            const auto mode = _parallel ? EntityUpdateMode::Parallel : EntityUpdateMode::Serial;
+            const bool simulated = Simulate(*context, inputPath, ticks, mode, nullptr);
+            EntitySetUpdateMode(EntityUpdateMode::Serial);
+            if (!simulated)
+            {
+                return EXITCODE_FAIL;
+            }
         }
-
-        Console::WriteLine("Running %d ticks...", ticks);
-        for (uint32_t i = 0; i < ticks; i++)
+        else
         {
-            gameStateUpdateLogic();
+            std::vector<EntitiesChecksum> serialChecksums;
+            std::vector<EntitiesChecksum> parallelChecksums;
+            const bool simulated = Simulate(*context, inputPath, ticks, EntityUpdateMode::Serial, &serialChecksums)
+                && Simulate(*context, inputPath, ticks, EntityUpdateMode::Parallel, &parallelChecksums);
+            EntitySetUpdateMode(EntityUpdateMode::Serial);
+            if (!simulated)
+            {
+                return EXITCODE_FAIL;
+            }
+
+            for (uint32_t i = 0; i < ticks; i++)
+            {
+                if (serialChecksums[i].raw != parallelChecksums[i].raw)
+                {
+                    Console::Error::WriteLine(
+                        "Parallel update diverged at tick %u: %s (serial) != %s (parallel)", i + 1,
+                        serialChecksums[i].ToString().c_str(), parallelChecksums[i].ToString().c_str());
+                    return EXITCODE_FAIL;
+                }
+            }
         }
         Console::WriteLine("Completed: %s", GetAllEntitiesChecksum().ToString().c_str());
     }
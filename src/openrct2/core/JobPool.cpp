@@ -10,26 +10,75 @@
 #include "JobPool.h"
 
 #include <cassert>
+#include <limits>
 
-JobPool::TaskData::TaskData(std::function<void()> workFn, std::function<void()> completionFn)
-    : WorkFn(workFn)
-    , CompletionFn(completionFn)
+static constexpr size_t kNoQueue = std::numeric_limits<size_t>::max();
+
+// Identifies the pool and queue owned by the current thread, external threads have no queue.
+static thread_local const JobPool* _currentPool = nullptr;
+static thread_local size_t _currentQueue = kNoQueue;
+
+bool JobPool::WorkerQueue::PushBack(Task& task)
+{
+    std::lock_guard lock(Mutex);
+    if (Count == Slots.size())
+    {
+        return false;
+    }
+    Slots[(Head + Count) % Slots.size()] = std::move(task);
+    Count++;
+    return true;
+}
+
+bool JobPool::WorkerQueue::PopBack(Task& task)
+{
+    std::lock_guard lock(Mutex);
+    if (Count == 0)
+    {
+        return false;
+    }
+    Count--;
+    task = std::move(Slots[(Head + Count) % Slots.size()]);
+    return true;
+}
+
+bool JobPool::WorkerQueue::PopFront(Task& task)
 {
+    std::lock_guard lock(Mutex);
+    if (Count == 0)
+    {
+        return false;
+    }
+    task = std::move(Slots[Head]);
+    Head = (Head + 1) % Slots.size();
+    Count--;
+    return true;
 }
 
 JobPool::JobPool(size_t maxThreads)
 {
     maxThreads = std::min<size_t>(maxThreads, std::thread::hardware_concurrency());
+    maxThreads = std::max<size_t>(maxThreads, 1);
     for (size_t n = 0; n < maxThreads; n++)
     {
-        _threads.emplace_back(&JobPool::ProcessQueue, this);
+        _queues.push_back(std::make_unique<WorkerQueue>());
     }
+    for (size_t n = 0; n < maxThreads; n++)
+    {
+        _threads.emplace_back(&JobPool::ProcessQueue, this, n);
+    }
+}
+
+JobPool& JobPool::GetShared()
+{
+    static JobPool sharedPool;
+    return sharedPool;
 }
 
 JobPool::~JobPool()
 {
     {
-        unique_lock lock(_mutex);
+        unique_lock lock(_sleepMutex);
         _shouldStop = true;
         _condPending.notify_all();
     }
@@ -41,91 +90,139 @@ JobPool::~JobPool()
     }
 }
 
-void JobPool::AddTask(std::function<void()> workFn, std::function<void()> completionFn)
+void JobPool::Submit(Task& task)
 {
-    unique_lock lock(_mutex);
-    _pending.emplace_back(workFn, completionFn);
-    _condPending.notify_one();
+    // Tasks created by a worker stay on its own queue so nested work is processed depth first,
+    // tasks from other threads are spread over all queues.
+    size_t queueIndex = _currentQueue;
+    if (_currentPool != this || queueIndex == kNoQueue)
+    {
+        queueIndex = _nextQueue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+    }
+
+    _queued++;
+    if (!_queues[queueIndex]->PushBack(task))
+    {
+        // Queue is full, run it directly rather than allocating more space.
+        _processing++;
+        _queued--;
+        RunTask(task);
+        return;
+    }
+
+    if (_sleeping > 0)
+    {
+        unique_lock lock(_sleepMutex);
+        _condPending.notify_one();
+    }
 }
 
-void JobPool::Join(std::function<void()> reportFn)
+bool JobPool::TryRunOne(size_t queueIndex)
 {
-    unique_lock lock(_mutex);
-    while (true)
+    Task task;
+    bool found = false;
+    if (queueIndex != kNoQueue)
     {
-        // Wait for the queue to become empty or having completed tasks.
-        _condComplete.wait(lock, [this]() { return (_pending.empty() && _processing == 0) || !_completed.empty(); });
+        found = _queues[queueIndex]->PopBack(task);
+    }
 
-        // Dispatch all completion callbacks if there are any.
-        while (!_completed.empty())
+    const size_t numQueues = _queues.size();
+    const size_t start = queueIndex == kNoQueue ? 0 : queueIndex + 1;
+    for (size_t n = 0; n < numQueues && !found; n++)
+    {
+        const size_t victim = (start + n) % numQueues;
+        if (victim != queueIndex)
         {
-            auto taskData = _completed.front();
-            _completed.pop_front();
+            found = _queues[victim]->PopFront(task);
+        }
+    }
+
+    if (!found)
+    {
+        return false;
+    }
 
-            if (taskData.CompletionFn)
-            {
-                lock.unlock();
+    _processing++;
+    _queued--;
+    RunTask(task);
+    return true;
+}
 
-                taskData.CompletionFn();
+void JobPool::RunTask(Task& task)
+{
+    auto* group = task.Group;
 
-                lock.lock();
-            }
-        }
+    task();
+    task.Reset();
 
-        if (reportFn)
-        {
-            lock.unlock();
+    _processing--;
+    group->_pending--;
 
-            reportFn();
+    // The group may be gone as soon as its counter reaches zero, so waiters are woken through the pool.
+    _completed++;
+    _completed.notify_all();
+}
+
+void JobPool::Wait(TaskGroup& group, const std::function<void()>& reportFn)
+{
+    const size_t queueIndex = _currentPool == this ? _currentQueue : kNoQueue;
+    while (true)
+    {
+        const size_t completed = _completed.load();
+        if (group._pending == 0)
+        {
+            break;
+        }
 
-            lock.lock();
+        // Help out while waiting, block only if there is nothing left to steal.
+        if (!TryRunOne(queueIndex))
+        {
+            _completed.wait(completed);
         }
 
-        // If everything is empty and no more work has to be done we can stop waiting.
-        if (_completed.empty() && _pending.empty() && _processing == 0)
+        if (reportFn)
         {
-            break;
+            reportFn();
         }
     }
+
+    if (reportFn)
+    {
+        reportFn();
+    }
+}
+
+void JobPool::Join(const std::function<void()>& reportFn)
+{
+    Wait(_defaultGroup, reportFn);
 }
 
 size_t JobPool::CountPending()
 {
-    unique_lock lock(_mutex);
-    return _pending.size();
+    return _queued;
 }
 
 size_t JobPool::CountProcessing()
 {
-    unique_lock lock(_mutex);
     return _processing;
 }
 
-void JobPool::ProcessQueue()
+void JobPool::ProcessQueue(size_t queueIndex)
 {
-    unique_lock lock(_mutex);
-    do
-    {
-        // Wait for work or cancellation.
-        _condPending.wait(lock, [this]() { return _shouldStop || !_pending.empty(); });
+    _currentPool = this;
+    _currentQueue = queueIndex;
 
-        if (!_pending.empty())
+    while (!_shouldStop)
+    {
+        if (TryRunOne(queueIndex))
         {
-            _processing++;
-
-            auto taskData = _pending.front();
-            _pending.pop_front();
-
-            lock.unlock();
-
-            taskData.WorkFn();
-
-            lock.lock();
-
-            _completed.push_back(std::move(taskData));
-
-            _processing--;
-            _condComplete.notify_one();
+            continue;
         }
-    } while (!_shouldStop);
+
+        // Wait for work or cancellation.
+        unique_lock lock(_sleepMutex);
+        _sleeping++;
+        _condPending.wait(lock, [this]() { return _shouldStop || _queued > 0; });
+        _sleeping--;
+    }
 }
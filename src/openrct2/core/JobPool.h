@@ -9,33 +9,154 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <condition_variable>
-#include <deque>
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+/**
+ * Work-stealing task scheduler. Every worker owns a fixed size deque, the owner pushes and pops
+ * at the back while idle workers steal from the front of other deques. Tasks are stored inline
+ * so submitting work never allocates, if a deque is full the task is executed by the caller.
+ * Threads waiting on a task group help executing pending tasks which allows nested fork/join.
+ */
 class JobPool
 {
+public:
+    static constexpr size_t kTaskStorageSize = 64;
+    static constexpr size_t kQueueCapacity = 1024;
+
+    /**
+     * Counts the outstanding tasks that were submitted to it, can be waited on with JobPool::Wait.
+     */
+    class TaskGroup
+    {
+    public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        size_t CountPending() const
+        {
+            return _pending.load();
+        }
+
+    private:
+        friend class JobPool;
+
+        std::atomic<size_t> _pending = { 0 };
+    };
+
 private:
-    struct TaskData
+    class Task
+    {
+    private:
+        alignas(std::max_align_t) std::byte _storage[kTaskStorageSize];
+        void (*_invoke)(void*) = nullptr;
+        void (*_relocate)(void*, void*) = nullptr;
+        void (*_destroy)(void*) = nullptr;
+
+    public:
+        TaskGroup* Group = nullptr;
+
+        Task() = default;
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        template<typename TFn> Task(TaskGroup& group, TFn&& fn)
+            : Group(&group)
+        {
+            using TCallable = std::decay_t<TFn>;
+            static_assert(sizeof(TCallable) <= kTaskStorageSize, "Task captures too much state, capture by reference instead.");
+            static_assert(alignof(TCallable) <= alignof(std::max_align_t));
+            static_assert(std::is_nothrow_move_constructible_v<TCallable>);
+
+            new (_storage) TCallable(std::forward<TFn>(fn));
+            _invoke = [](void* p) { (*static_cast<TCallable*>(p))(); };
+            _relocate = [](void* dst, void* src) {
+                new (dst) TCallable(std::move(*static_cast<TCallable*>(src)));
+                static_cast<TCallable*>(src)->~TCallable();
+            };
+            _destroy = [](void* p) { static_cast<TCallable*>(p)->~TCallable(); };
+        }
+
+        Task(Task&& other) noexcept
+        {
+            *this = std::move(other);
+        }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                if (other._invoke != nullptr)
+                {
+                    other._relocate(_storage, other._storage);
+                    _invoke = std::exchange(other._invoke, nullptr);
+                    _relocate = std::exchange(other._relocate, nullptr);
+                    _destroy = std::exchange(other._destroy, nullptr);
+                }
+                Group = std::exchange(other.Group, nullptr);
+            }
+            return *this;
+        }
+
+        ~Task()
+        {
+            Reset();
+        }
+
+        void operator()()
+        {
+            _invoke(_storage);
+        }
+
+        void Reset()
+        {
+            if (_destroy != nullptr)
+            {
+                _destroy(_storage);
+            }
+            _invoke = nullptr;
+            _relocate = nullptr;
+            _destroy = nullptr;
+            Group = nullptr;
+        }
+    };
+
+    struct alignas(64) WorkerQueue
     {
-        const std::function<void()> WorkFn;
-        const std::function<void()> CompletionFn;
+        std::mutex Mutex;
+        std::array<Task, kQueueCapacity> Slots;
+        size_t Head = 0;
+        size_t Count = 0;
 
-        TaskData(std::function<void()> workFn, std::function<void()> completionFn);
+        bool PushBack(Task& task);
+        bool PopBack(Task& task);
+        bool PopFront(Task& task);
     };
 
     std::atomic_bool _shouldStop = { false };
+    std::atomic<size_t> _queued = { 0 };
     std::atomic<size_t> _processing = { 0 };
+    std::atomic<size_t> _completed = { 0 };
+    std::atomic<size_t> _sleeping = { 0 };
+    std::atomic<size_t> _nextQueue = { 0 };
+    std::vector<std::unique_ptr<WorkerQueue>> _queues;
     std::vector<std::thread> _threads;
-    std::deque<TaskData> _pending;
-    std::deque<TaskData> _completed;
     std::condition_variable _condPending;
-    std::condition_variable _condComplete;
-    std::mutex _mutex;
+    std::mutex _sleepMutex;
+    TaskGroup _defaultGroup;
 
     using unique_lock = std::unique_lock<std::mutex>;
 
@@ -43,11 +164,64 @@ public:
     JobPool(size_t maxThreads = 255);
     ~JobPool();
 
-    void AddTask(std::function<void()> workFn, std::function<void()> completionFn = nullptr);
-    void Join(std::function<void()> reportFn = nullptr);
+    /**
+     * Process wide pool for work that is split up every frame or tick, created on first use so all
+     * systems share one set of worker threads instead of each spawning one per core.
+     */
+    static JobPool& GetShared();
+
+    template<typename TFn> void AddTask(TFn&& workFn)
+    {
+        AddTask(_defaultGroup, std::forward<TFn>(workFn));
+    }
+
+    template<typename TFn> void AddTask(TaskGroup& group, TFn&& workFn)
+    {
+        group._pending++;
+        Task task(group, std::forward<TFn>(workFn));
+        Submit(task);
+    }
+
+    /**
+     * Calls fn(i) for every i in [begin, end), the range is recursively split in halves until it
+     * is at most grainSize wide. Returns after all iterations completed, can be called from within a task.
+     */
+    template<typename TFn> void ParallelFor(size_t begin, size_t end, size_t grainSize, TFn&& fn)
+    {
+        TaskGroup group;
+        ParallelForRange(group, begin, end, std::max<size_t>(grainSize, 1), fn);
+        Wait(group);
+    }
+
+    /**
+     * Waits for all tasks in the group to complete, the calling thread executes pending tasks meanwhile.
+     */
+    void Wait(TaskGroup& group, const std::function<void()>& reportFn = nullptr);
+
+    /**
+     * Waits for all tasks submitted without an explicit group.
+     */
+    void Join(const std::function<void()>& reportFn = nullptr);
     size_t CountPending();
     size_t CountProcessing();
 
 private:
-    void ProcessQueue();
+    template<typename TFn> void ParallelForRange(TaskGroup& group, size_t begin, size_t end, size_t grainSize, TFn& fn)
+    {
+        while (end - begin > grainSize)
+        {
+            const size_t mid = begin + (end - begin) / 2;
+            AddTask(group, [this, &group, mid, end, grainSize, &fn]() { ParallelForRange(group, mid, end, grainSize, fn); });
+            end = mid;
+        }
+        for (size_t i = begin; i < end; i++)
+        {
+            fn(i);
+        }
+    }
+
+    void Submit(Task& task);
+    bool TryRunOne(size_t queueIndex);
+    void RunTask(Task& task);
+    void ProcessQueue(size_t queueIndex);
 };
@@ -9,15 +9,21 @@
 
 #pragma once
 
+#include "../util/Util.h"
 #include "../world/Location.hpp"
 #include "Crypt.h"
 #include "FileStream.h"
 #include "Identifier.hpp"
+#include "JobPool.h"
 #include "MemoryStream.h"
 
 #include <algorithm>
 #include <array>
 #include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <memory>
 #include <stack>
 #include <type_traits>
 #include <vector>
@@ -35,6 +41,8 @@ namespace OpenRCT2
 
         static constexpr uint32_t COMPRESSION_NONE = 0;
         static constexpr uint32_t COMPRESSION_GZIP = 1;
+        // Every chunk is compressed on its own, the chunk table is followed by the compressed size of each chunk.
+        static constexpr uint32_t COMPRESSION_GZIP_CHUNKS = 2;
 
     private:
 #pragma pack(push, 1)
@@ -60,12 +68,27 @@ namespace OpenRCT2
         };
 #pragma pack(pop)
 
+        // A chunk being compressed or decompressed on the job pool.
+        struct ChunkJob
+        {
+            JobPool::TaskGroup Group;
+            bool Started{};
+            bool Succeeded{};
+            // The compressed data when writing, its position in the compressed data when reading.
+            std::vector<uint8_t> Compressed;
+            uint64_t CompressedOffset{};
+            uint64_t CompressedLength{};
+        };
+
         IStream* _stream;
         Mode _mode;
         Header _header;
         std::vector<ChunkEntry> _chunks;
         MemoryStream _buffer;
         ChunkEntry _currentChunk;
+        std::vector<uint8_t> _compressedData;
+        std::vector<uint8_t> _uncompressedData;
+        std::vector<std::unique_ptr<ChunkJob>> _chunkJobs;
 
     public:
         OrcaStream(IStream& stream, const Mode mode)
@@ -83,6 +106,12 @@ namespace OpenRCT2
                     _chunks.push_back(entry);
                 }
 
+                if (_header.Compression == COMPRESSION_GZIP_CHUNKS)
+                {
+                    ReadCompressedChunks();
+                    return;
+                }
+
                 // Read compressed data into buffer (read in blocks)
                 _buffer = MemoryStream{};
                 uint8_t temp[2048];
@@ -110,7 +139,7 @@ namespace OpenRCT2
             else
             {
                 _header = {};
-                _header.Compression = COMPRESSION_GZIP;
+                _header.Compression = COMPRESSION_GZIP_CHUNKS;
 
                 _buffer = MemoryStream{};
             }
@@ -120,7 +149,20 @@ namespace OpenRCT2
 
         ~OrcaStream()
         {
-            if (_mode == Mode::WRITING)
+            // The jobs refer to the buffers of this stream.
+            for (auto& job : _chunkJobs)
+            {
+                if (job->Started)
+                {
+                    JobPool::GetShared().Wait(job->Group);
+                }
+            }
+
+            if (_mode == Mode::WRITING && _header.Compression == COMPRESSION_GZIP_CHUNKS)
+            {
+                WriteCompressedChunks();
+            }
+            else if (_mode == Mode::WRITING)
             {
                 const void* uncompressedData = _buffer.GetData();
                 const uint64_t uncompressedSize = _buffer.GetLength();
@@ -201,15 +243,177 @@ namespace OpenRCT2
             f(stream);
             _currentChunk.Length = static_cast<uint64_t>(_buffer.GetPosition()) - _currentChunk.Offset;
             _chunks.push_back(_currentChunk);
+
+            // Compress the chunk while the next one is being written.
+            if (_header.Compression == COMPRESSION_GZIP_CHUNKS)
+            {
+                auto& job = *_chunkJobs.emplace_back(std::make_unique<ChunkJob>());
+                job.Compressed.resize(_currentChunk.Length);
+                std::copy_n(
+                    static_cast<const uint8_t*>(_buffer.GetData()) + _currentChunk.Offset, _currentChunk.Length,
+                    job.Compressed.data());
+                StartJob(job, [&job]() {
+                    job.Compressed = Gzip(job.Compressed.data(), job.Compressed.size());
+                    return true;
+                });
+            }
             return true;
         }
 
+        // Starts decompressing all chunks that have not been read yet, rather than each when it is first read.
+        void PrefetchChunks()
+        {
+            for (size_t i = 0; i < _chunkJobs.size(); i++)
+            {
+                StartDecompressingChunk(i);
+            }
+        }
+
+        // Writes the chunks being read to another stream in the same order. This allows a stream to be written without
+        // compression first and compressed later, giving the same bytes as if it was compressed when written.
+        void CopyChunksTo(OrcaStream& dst)
+        {
+            auto& header = dst.GetHeader();
+            header.Magic = _header.Magic;
+            header.TargetVersion = _header.TargetVersion;
+            header.MinVersion = _header.MinVersion;
+
+            for (const auto& chunk : _chunks)
+            {
+                SeekChunk(chunk.Id);
+                const auto* data = static_cast<const uint8_t*>(_buffer.GetData()) + chunk.Offset;
+                dst.ReadWriteChunk(chunk.Id, [data, &chunk](ChunkStream& cs) { cs.Write(data, chunk.Length); });
+            }
+        }
+
     private:
+        template<typename TFn> void StartJob(ChunkJob& job, TFn&& fn)
+        {
+            job.Started = true;
+            JobPool::GetShared().AddTask(job.Group, [&job, fn = std::forward<TFn>(fn)]() mutable {
+                try
+                {
+                    job.Succeeded = fn();
+                }
+                catch (const std::exception&)
+                {
+                    job.Succeeded = false;
+                }
+            });
+        }
+
+        void ReadCompressedChunks()
+        {
+            // All sizes come from the file, check them before anything is allocated or read.
+            const auto tableLength = static_cast<uint64_t>(_chunks.size()) * sizeof(uint64_t);
+            const auto position = _stream->GetPosition();
+            const auto length = _stream->GetLength();
+            if (_header.CompressedSize < tableLength || position > length || _header.CompressedSize > length - position)
+                throw IOException("Invalid chunk table.");
+
+            _compressedData.resize(_header.CompressedSize);
+            _stream->Read(_compressedData.data(), _compressedData.size());
+
+            uint64_t offset = tableLength;
+            for (size_t i = 0; i < _chunks.size(); i++)
+            {
+                const auto& chunk = _chunks[i];
+                auto& job = *_chunkJobs.emplace_back(std::make_unique<ChunkJob>());
+                std::memcpy(&job.CompressedLength, _compressedData.data() + i * sizeof(uint64_t), sizeof(uint64_t));
+                if (job.CompressedLength > _compressedData.size() - offset || chunk.Offset > _header.UncompressedSize
+                    || chunk.Length > _header.UncompressedSize - chunk.Offset)
+                    throw IOException("Invalid chunk table.");
+
+                job.CompressedOffset = offset;
+                offset += job.CompressedLength;
+            }
+
+            _uncompressedData.resize(_header.UncompressedSize);
+            _buffer = MemoryStream(_uncompressedData.data(), _uncompressedData.size());
+        }
+
+        void StartDecompressingChunk(size_t index)
+        {
+            auto& job = *_chunkJobs[index];
+            if (job.Started)
+                return;
+
+            const auto& chunk = _chunks[index];
+            const auto* src = _compressedData.data() + job.CompressedOffset;
+            auto* dst = _uncompressedData.data() + chunk.Offset;
+            StartJob(job, [&job, &chunk, src, dst]() {
+                const auto data = Ungzip(src, job.CompressedLength);
+                if (data.size() != chunk.Length)
+                    return false;
+                std::copy(data.begin(), data.end(), dst);
+                return true;
+            });
+        }
+
+        void WriteCompressedChunks()
+        {
+            const void* uncompressedData = _buffer.GetData();
+            const uint64_t uncompressedSize = _buffer.GetLength();
+
+            _header.NumChunks = static_cast<uint32_t>(_chunks.size());
+            _header.UncompressedSize = uncompressedSize;
+            _header.CompressedSize = static_cast<uint64_t>(_chunks.size()) * sizeof(uint64_t);
+            _header.FNV1a = Crypt::FNV1a(uncompressedData, uncompressedSize);
+
+            const auto succeeded = std::all_of(
+                _chunkJobs.begin(), _chunkJobs.end(), [](const auto& job) { return job->Succeeded; });
+            if (!succeeded)
+            {
+                // Compression failed
+                _header.Compression = COMPRESSION_NONE;
+                _header.CompressedSize = uncompressedSize;
+            }
+            else
+            {
+                for (const auto& job : _chunkJobs)
+                {
+                    _header.CompressedSize += job->Compressed.size();
+                }
+            }
+
+            // Write header and chunk table
+            _stream->WriteValue(_header);
+            for (const auto& chunk : _chunks)
+            {
+                _stream->WriteValue(chunk);
+            }
+
+            // Write chunk data
+            if (!succeeded)
+            {
+                _stream->Write(uncompressedData, uncompressedSize);
+                return;
+            }
+            for (const auto& job : _chunkJobs)
+            {
+                _stream->WriteValue<uint64_t>(job->Compressed.size());
+            }
+            for (const auto& job : _chunkJobs)
+            {
+                _stream->Write(job->Compressed.data(), job->Compressed.size());
+            }
+        }
+
         bool SeekChunk(const uint32_t id)
         {
             const auto result = std::find_if(_chunks.begin(), _chunks.end(), [id](const ChunkEntry& e) { return e.Id == id; });
             if (result != _chunks.end())
             {
+                if (_header.Compression == COMPRESSION_GZIP_CHUNKS)
+                {
+                    const auto index = static_cast<size_t>(std::distance(_chunks.begin(), result));
+                    auto& job = *_chunkJobs[index];
+                    StartDecompressingChunk(index);
+                    JobPool::GetShared().Wait(job.Group);
+                    if (!job.Succeeded)
+                        throw IOException("Unable to decompress chunk.");
+                }
+
                 const auto offset = result->Offset;
                 _buffer.SetPosition(offset);
                 return true;
@@ -0,0 +1,149 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TickArena.h"
+
+#include "../profiling/Profiling.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace OpenRCT2::TickArena
+{
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> Data;
+        size_t Size{};
+    };
+
+    struct Arena
+    {
+        std::vector<Block> Blocks;
+        size_t BlockIndex{};
+        size_t Offset{};
+        size_t BytesUsed{};
+        uint32_t Tick{};
+    };
+
+    static std::atomic<uint32_t> _tick{ 0 };
+    static std::atomic<bool> _inTick{ false };
+    static thread_local Arena _arena;
+
+    static Profiling::Counter _arenaBytes("Tick arena bytes");
+    static Profiling::Counter _arenaBlocks("Tick arena block allocations");
+
+    // Worker threads only notice that a new tick began when they next use their arena.
+    static Arena& GetArena()
+    {
+        const auto tick = _tick.load(std::memory_order_relaxed);
+        if (_arena.Tick != tick)
+        {
+            _arena.BlockIndex = 0;
+            _arena.Offset = 0;
+            _arena.BytesUsed = 0;
+            _arena.Tick = tick;
+        }
+        return _arena;
+    }
+
+    static bool IsHeapAlignment(size_t alignment)
+    {
+        return alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    }
+
+    void BeginTick()
+    {
+        _tick.fetch_add(1, std::memory_order_relaxed);
+        _inTick = true;
+    }
+
+    void EndTick()
+    {
+        _inTick = false;
+    }
+
+    bool IsInTick()
+    {
+        return _inTick;
+    }
+
+    void* Allocate(size_t size, size_t alignment)
+    {
+        if (!_inTick.load(std::memory_order_relaxed))
+        {
+            if (IsHeapAlignment(alignment))
+                return ::operator new(size);
+            return ::operator new(size, std::align_val_t{ alignment });
+        }
+
+        auto& arena = GetArena();
+        for (;;)
+        {
+            for (; arena.BlockIndex < arena.Blocks.size(); arena.BlockIndex++, arena.Offset = 0)
+            {
+                auto& block = arena.Blocks[arena.BlockIndex];
+                const auto base = reinterpret_cast<uintptr_t>(block.Data.get());
+                const auto start = (base + arena.Offset + alignment - 1) & ~(uintptr_t{ alignment } - 1);
+                if (start + size <= base + block.Size)
+                {
+                    arena.Offset = start + size - base;
+                    arena.BytesUsed += size;
+                    _arenaBytes.Add(size);
+                    return reinterpret_cast<void*>(start);
+                }
+            }
+
+            // Blocks are only ever added, so the arena settles at the size of the largest tick.
+            const auto blockSize = std::max(kBlockSize, size + alignment);
+            arena.Blocks.push_back({ std::unique_ptr<std::byte[]>(new std::byte[blockSize]), blockSize });
+            arena.BlockIndex = arena.Blocks.size() - 1;
+            arena.Offset = 0;
+            _arenaBlocks.Add();
+        }
+    }
+
+    void Deallocate(void* ptr, size_t alignment) noexcept
+    {
+        const auto address = reinterpret_cast<uintptr_t>(ptr);
+        for (const auto& block : _arena.Blocks)
+        {
+            const auto base = reinterpret_cast<uintptr_t>(block.Data.get());
+            if (address >= base && address < base + block.Size)
+            {
+                // Released when the next tick begins.
+                return;
+            }
+        }
+
+        if (IsHeapAlignment(alignment))
+            ::operator delete(ptr);
+        else
+            ::operator delete(ptr, std::align_val_t{ alignment });
+    }
+
+    size_t GetBytesUsed()
+    {
+        return GetArena().BytesUsed;
+    }
+
+    size_t GetCapacity()
+    {
+        size_t capacity = 0;
+        for (const auto& block : _arena.Blocks)
+        {
+            capacity += block.Size;
+        }
+        return capacity;
+    }
+} // namespace OpenRCT2::TickArena
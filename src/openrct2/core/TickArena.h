@@ -0,0 +1,67 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Bump allocator for temporary data of the game logic update. Each thread has its own arena whose blocks are kept
+ * between ticks, so once the arena has grown to fit a tick later ticks do not touch the heap. Everything allocated
+ * during a tick is released at once when the next tick begins, memory must therefore not outlive the tick and must
+ * be freed on the thread that allocated it. Outside of a tick allocations go to the heap.
+ */
+namespace OpenRCT2::TickArena
+{
+    void BeginTick();
+    void EndTick();
+    bool IsInTick();
+
+    void* Allocate(size_t size, size_t alignment);
+    void Deallocate(void* ptr, size_t alignment) noexcept;
+
+    // Bytes handed out by the arena of the calling thread during the current tick.
+    size_t GetBytesUsed();
+    // Bytes reserved by the arena of the calling thread.
+    size_t GetCapacity();
+} // namespace OpenRCT2::TickArena
+
+namespace OpenRCT2
+{
+    template<typename T> class TickAllocator
+    {
+    public:
+        using value_type = T;
+
+        TickAllocator() noexcept = default;
+
+        template<typename U> TickAllocator(const TickAllocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(size_t n)
+        {
+            return static_cast<T*>(TickArena::Allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* ptr, size_t) noexcept
+        {
+            TickArena::Deallocate(ptr, alignof(T));
+        }
+
+        template<typename U> bool operator==(const TickAllocator<U>&) const noexcept
+        {
+            return true;
+        }
+    };
+
+    // Vector for use within a single tick, see TickArena.
+    template<typename T> using TickVector = std::vector<T, TickAllocator<T>>;
+} // namespace OpenRCT2
@@ -19,6 +19,7 @@
 #include "../object/Object.h"
 #include "../object/ObjectEntryManager.h"
 #include "../object/WaterEntry.h"
+#include "../paint/Paint.TileCache.h"
 #include "../platform/Platform.h"
 #include "../sprites.h"
 #include "../world/Climate.h"
@@ -778,6 +779,7 @@ void LoadPalette()
  */
 void GfxInvalidateScreen()
 {
+    PaintTileCacheInvalidateAll();
     GfxSetDirtyBlocks({ { 0, 0 }, { ContextGetWidth(), ContextGetHeight() } });
 }
 
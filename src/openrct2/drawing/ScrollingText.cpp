@@ -16,6 +16,7 @@
 #include "../localisation/Formatter.h"
 #include "../localisation/Formatting.h"
 #include "../localisation/LocalisationService.h"
+#include "../paint/Paint.TileCache.h"
 #include "../paint/Paint.h"
 #include "../sprites.h"
 #include "Drawing.h"
@@ -1446,6 +1447,7 @@ ImageId ScrollingTextSetup(
     if (session.DPI.zoom_level > ZoomLevel{ 0 })
         return ImageId(SPR_SCROLLING_TEXT_DEFAULT);
 
+    PaintTileCacheMarkVolatile(session);
     _drawSCrollNextIndex++;
     ft.Rewind();
     uint32_t scrollIndex = ScrollingTextGetMatchingOrOldest(stringId, ft, scroll, scrollingMode, colour);
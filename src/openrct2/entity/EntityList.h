@@ -9,32 +9,40 @@
 
 #pragma once
 
+#include "../core/TickArena.h"
 #include "../rct12/RCT12.h"
 #include "../world/Location.hpp"
+#include "../world/Map.h"
 #include "EntityBase.h"
 #include "EntityRegistry.h"
 
-#include <list>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <optional>
 #include <vector>
 
-const std::list<EntityId>& GetEntityList(const EntityType id);
+const std::vector<EntityId>& GetEntityList(const EntityType id);
 
 uint16_t GetEntityListCount(EntityType list);
 uint16_t GetMiscEntityCount();
 uint16_t GetNumFreeEntities();
-const std::vector<EntityId>& GetEntityTileList(const CoordsXY& spritePos);
+EntityId GetFirstEntityOnTile(const CoordsXY& spritePos);
+// Returns the entity following the given one on its tile in id order, or a null id for the last one.
+EntityId GetNextEntityOnTile(EntityId entityIndex);
+// Entities of the given type that moved since the spatial index was last updated. They can still be listed on the tile
+// they moved away from. The list can contain removed entities and the same entity more than once.
+const std::vector<EntityId>& GetEntitiesMovedOffTile(EntityType type);
 
 template<typename T> class EntityTileIterator
 {
 private:
-    std::vector<EntityId>::const_iterator iter;
-    std::vector<EntityId>::const_iterator end;
+    EntityId next;
     T* Entity = nullptr;
 
 public:
-    EntityTileIterator(std::vector<EntityId>::const_iterator _iter, std::vector<EntityId>::const_iterator _end)
-        : iter(_iter)
-        , end(_end)
+    EntityTileIterator(EntityId first)
+        : next(first)
     {
         ++(*this);
     }
@@ -42,9 +50,12 @@ public:
     {
         Entity = nullptr;
 
-        while (iter != end && Entity == nullptr)
+        while (!next.IsNull() && Entity == nullptr)
         {
-            Entity = GetEntity<T>(*iter++);
+            // Read the next entity before handing out the current one, which may be removed by the caller.
+            const auto current = next;
+            next = GetNextEntityOnTile(current);
+            Entity = GetEntity<T>(current);
         }
         return *this;
     }
@@ -53,7 +64,7 @@ public:
     {
         EntityTileIterator retval = *this;
         ++(*this);
-        return *iter;
+        return retval;
     }
     bool operator==(EntityTileIterator other) const
     {
@@ -78,35 +89,67 @@ public:
 template<typename T = EntityBase> class EntityTileList
 {
 private:
-    const std::vector<EntityId>& vec;
+    EntityId first;
 
 public:
     EntityTileList(const CoordsXY& loc)
-        : vec(GetEntityTileList(loc))
+        : first(GetFirstEntityOnTile(loc))
     {
     }
 
     EntityTileIterator<T> begin()
     {
-        return EntityTileIterator<T>(std::begin(vec), std::end(vec));
+        return EntityTileIterator<T>(first);
     }
     EntityTileIterator<T> end()
     {
-        return EntityTileIterator<T>(std::end(vec), std::end(vec));
+        return EntityTileIterator<T>(EntityId::GetNull());
+    }
+};
+
+/**
+ * Position in an entity list that stays valid when entities are created or removed while iterating. Entities created
+ * with a higher id than the current one are still visited, like they were when the lists were linked lists.
+ */
+class EntityListCursor
+{
+private:
+    const std::vector<EntityId>* list;
+    size_t next;
+    EntityId current = EntityId::GetNull();
+
+public:
+    EntityListCursor(const std::vector<EntityId>& _list, size_t _next)
+        : list(&_list)
+        , next(_next)
+    {
+    }
+
+    // Returns the id following the one returned last, or a null id at the end of the list.
+    EntityId Next()
+    {
+        if (!current.IsNull() && (next == 0 || next > list->size() || (*list)[next - 1] != current))
+        {
+            next = std::upper_bound(std::begin(*list), std::end(*list), current) - std::begin(*list);
+        }
+        if (next >= list->size())
+        {
+            return EntityId::GetNull();
+        }
+        current = (*list)[next++];
+        return current;
     }
 };
 
 template<typename T> class EntityListIterator
 {
 private:
-    std::list<EntityId>::const_iterator iter;
-    std::list<EntityId>::const_iterator end;
+    EntityListCursor cursor;
     T* Entity = nullptr;
 
 public:
-    EntityListIterator(std::list<EntityId>::const_iterator _iter, std::list<EntityId>::const_iterator _end)
-        : iter(_iter)
-        , end(_end)
+    EntityListIterator(const std::vector<EntityId>& list, size_t index)
+        : cursor(list, index)
     {
         ++(*this);
     }
@@ -114,9 +157,13 @@ public:
     {
         Entity = nullptr;
 
-        while (iter != end && Entity == nullptr)
+        for (auto id = cursor.Next(); !id.IsNull(); id = cursor.Next())
         {
-            Entity = GetEntity<T>(*iter++);
+            Entity = GetEntity<T>(id);
+            if (Entity != nullptr)
+            {
+                break;
+            }
         }
         return *this;
     }
@@ -125,7 +172,7 @@ public:
     {
         EntityListIterator retval = *this;
         ++(*this);
-        return *iter;
+        return retval;
     }
     bool operator==(EntityListIterator other) const
     {
@@ -151,7 +198,7 @@ template<typename T = EntityBase> class EntityList
 {
 private:
     using EntityListIterator_t = EntityListIterator<T>;
-    const std::list<EntityId>& vec;
+    const std::vector<EntityId>& vec;
 
 public:
     EntityList()
@@ -161,10 +208,177 @@ public:
 
     EntityListIterator_t begin() const
     {
-        return EntityListIterator_t(std::cbegin(vec), std::cend(vec));
+        return EntityListIterator_t(vec, 0);
     }
     EntityListIterator_t end() const
     {
-        return EntityListIterator_t(std::cend(vec), std::cend(vec));
+        return EntityListIterator_t(vec, vec.size());
     }
 };
+
+namespace OpenRCT2::Detail
+{
+    // The spatial index mirrors negative coordinates, so searches are centred on the mirrored tile as well.
+    inline TileCoordsXY GetSpatialSearchCentre(const CoordsXY& pos)
+    {
+        return { std::abs(pos.x) / kCoordsXYStep, std::abs(pos.y) / kCoordsXYStep };
+    }
+
+    // Calls func for every entity of type T listed on a tile at the given chebyshev distance from centre.
+    template<typename T, typename TFunc> void ForEachEntityOnTileRing(const TileCoordsXY& centre, int32_t ring, TFunc&& func)
+    {
+        const auto visit = [&](int32_t tileX, int32_t tileY) {
+            if (tileX < 0 || tileY < 0 || tileX >= kMaximumMapSizeTechnical || tileY >= kMaximumMapSizeTechnical)
+                return;
+            for (auto* entity : EntityTileList<T>(TileCoordsXY{ tileX, tileY }.ToCoordsXY()))
+            {
+                func(entity);
+            }
+        };
+
+        if (ring == 0)
+        {
+            visit(centre.x, centre.y);
+            return;
+        }
+        for (int32_t offset = -ring; offset <= ring; offset++)
+        {
+            visit(centre.x + offset, centre.y - ring);
+            visit(centre.x + offset, centre.y + ring);
+        }
+        for (int32_t offset = -ring + 1; offset < ring; offset++)
+        {
+            visit(centre.x - ring, centre.y + offset);
+            visit(centre.x + ring, centre.y + offset);
+        }
+    }
+} // namespace OpenRCT2::Detail
+
+/**
+ * Calls func in id order for every entity of type T whose x and y are both within radius of pos. Only the tiles around
+ * pos are searched, entities that moved during the current tick are found at their current position.
+ */
+template<typename T, typename TFunc> void ForEachEntityInRadius(const CoordsXY& pos, int32_t radius, TFunc&& func)
+{
+    OpenRCT2::TickVector<EntityId> found;
+    const auto addIfInRadius = [&](const T* entity) {
+        if (entity->x != kLocationNull && std::abs(entity->x - pos.x) <= radius && std::abs(entity->y - pos.y) <= radius)
+        {
+            found.push_back(entity->Id);
+        }
+    };
+
+    const auto minX = std::max(0, std::abs(pos.x) - radius) / kCoordsXYStep;
+    const auto minY = std::max(0, std::abs(pos.y) - radius) / kCoordsXYStep;
+    const auto maxX = (std::abs(pos.x) + radius) / kCoordsXYStep;
+    const auto maxY = (std::abs(pos.y) + radius) / kCoordsXYStep;
+    for (int32_t tileX = minX; tileX <= std::min<int32_t>(maxX, kMaximumMapSizeTechnical - 1); tileX++)
+    {
+        for (int32_t tileY = minY; tileY <= std::min<int32_t>(maxY, kMaximumMapSizeTechnical - 1); tileY++)
+        {
+            for (auto* entity : EntityTileList<T>(TileCoordsXY{ tileX, tileY }.ToCoordsXY()))
+            {
+                addIfInRadius(entity);
+            }
+        }
+    }
+    // Entities off the edge of the index are all listed under the null location.
+    if (maxX >= kMaximumMapSizeTechnical || maxY >= kMaximumMapSizeTechnical)
+    {
+        for (auto* entity : EntityTileList<T>({ kLocationNull, 0 }))
+        {
+            addIfInRadius(entity);
+        }
+    }
+    for (auto id : GetEntitiesMovedOffTile(T::cEntityType))
+    {
+        auto* entity = GetEntity<T>(id);
+        if (entity != nullptr)
+        {
+            addIfInRadius(entity);
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+    for (auto id : found)
+    {
+        // The callback may have removed entities found later.
+        auto* entity = GetEntity<T>(id);
+        if (entity != nullptr)
+        {
+            func(entity);
+        }
+    }
+}
+
+/**
+ * Returns the entity of type T with the lowest distance no higher than maxDistance, or nullptr if there is none.
+ * distanceFunc returns the distance to an entity, or std::nullopt to skip it. It must never return less than the
+ * manhattan distance on x and y between pos and the entity. Ties go to the entity with the lowest id, so
+ * the result is the same as keeping the first closest entity while iterating EntityList<T>.
+ *
+ * Tiles are searched in rings of increasing distance around pos, which stops once no entity further out can be closer.
+ * When the remaining rings hold more tiles than there are entities of type T, the entity list is scanned instead.
+ */
+template<typename T, typename TDistanceFunc>
+T* FindNearestEntity(const CoordsXY& pos, uint32_t maxDistance, TDistanceFunc&& distanceFunc)
+{
+    T* nearest = nullptr;
+    uint32_t nearestDistance = std::numeric_limits<uint32_t>::max();
+    const auto consider = [&](T* entity) {
+        const std::optional<uint32_t> result = distanceFunc(*entity);
+        if (!result.has_value() || *result > maxDistance)
+            return;
+        const auto distance = *result;
+        if (nearest == nullptr || distance < nearestDistance || (distance == nearestDistance && entity->Id < nearest->Id))
+        {
+            nearest = entity;
+            nearestDistance = distance;
+        }
+    };
+
+    for (auto id : GetEntitiesMovedOffTile(T::cEntityType))
+    {
+        auto* entity = GetEntity<T>(id);
+        if (entity != nullptr)
+        {
+            consider(entity);
+        }
+    }
+
+    const auto centre = OpenRCT2::Detail::GetSpatialSearchCentre(pos);
+    // Entities off the edge of the index, including the ones without a location, are listed under the null location.
+    const auto edgeDistance = std::max<int32_t>(
+        0, kMaximumMapSizeTechnical * kCoordsXYStep - std::max(std::abs(pos.x), std::abs(pos.y)));
+    const auto lastRing = std::max(
+        { centre.x, centre.y, kMaximumMapSizeTechnical - 1 - centre.x, kMaximumMapSizeTechnical - 1 - centre.y });
+    int32_t budget = GetEntityListCount(T::cEntityType);
+    for (int32_t ring = 0; ring <= lastRing; ring++)
+    {
+        // Entities on tiles of this ring are at least this far away on one of the axes.
+        const uint32_t ringDistance = ring == 0 ? 0 : (ring - 1) * kCoordsXYStep + 1;
+        if (ringDistance > maxDistance || ringDistance > nearestDistance)
+            break;
+
+        budget -= ring == 0 ? 1 : ring * 8;
+        if (budget < 0)
+        {
+            for (auto* entity : EntityList<T>())
+            {
+                consider(entity);
+            }
+            return nearest;
+        }
+        OpenRCT2::Detail::ForEachEntityOnTileRing<T>(centre, ring, consider);
+    }
+
+    if (static_cast<uint32_t>(edgeDistance) <= std::min(maxDistance, nearestDistance))
+    {
+        for (auto* entity : EntityTileList<T>({ kLocationNull, 0 }))
+        {
+            consider(entity);
+        }
+    }
+    return nearest;
+}
@@ -30,29 +30,42 @@
 #include "Duck.h"
 #include "EntityTweener.h"
 #include "Fountain.h"
+#include "Guest.h"
+#include "Litter.h"
 #include "MoneyEffect.h"
 #include "Particle.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstring>
+#include <functional>
 #include <iterator>
 #include <numeric>
 #include <vector>
 
 using namespace OpenRCT2;
 
-static std::array<std::list<EntityId>, EnumValue(EntityType::Count)> gEntityLists;
+static std::array<std::vector<EntityId>, EnumValue(EntityType::Count)> gEntityLists;
 static std::vector<EntityId> _freeIdList;
 
 static bool _entityFlashingList[MAX_ENTITIES];
 
+static EntityUpdateMode _entityUpdateMode = EntityUpdateMode::Serial;
+
 static constexpr const uint32_t kSpatialIndexSize = (kMaximumMapSizeTechnical * kMaximumMapSizeTechnical) + 1;
 static constexpr uint32_t kSpatialIndexNullBucket = kSpatialIndexSize - 1;
 
 static constexpr uint32_t kInvalidSpatialIndex = 0xFFFFFFFFu;
 static constexpr uint32_t kSpatialIndexDirtyMask = 1u << 31;
 
-static std::array<std::vector<EntityId>, kSpatialIndexSize> gEntitySpatialIndex;
+// The entities in each cell of the spatial index form a linked list in id order. The previous entry of the first
+// entity in a cell is the last one, so entities with the highest id can be appended directly.
+static std::vector<EntityId> _spatialFirst(kSpatialIndexSize, EntityId::GetNull());
+static std::array<EntityId, MAX_ENTITIES> _spatialNext;
+static std::array<EntityId, MAX_ENTITIES> _spatialPrev;
+// Entities that moved since the spatial index was last updated, per entity type. Entries may be repeated or stale.
+static std::array<std::vector<EntityId>, EnumValue(EntityType::Count)> _spatialDirty;
 
 static void FreeEntity(EntityBase& entity);
 
@@ -95,6 +108,113 @@ constexpr bool EntityTypeIsMiscEntity(const EntityType type)
     }
 }
 
+static constexpr size_t GetEntityPoolIndex(const EntityType type)
+{
+    static_assert(EnumValue(EntityType::Vehicle) < EntityStorage::kMiscPool);
+    static_assert(EnumValue(EntityType::Guest) < EntityStorage::kMiscPool);
+    static_assert(EnumValue(EntityType::Staff) < EntityStorage::kMiscPool);
+    static_assert(EnumValue(EntityType::Litter) < EntityStorage::kMiscPool);
+    return EntityTypeIsMiscEntity(type) ? EntityStorage::kMiscPool : EnumValue(type);
+}
+
+// Slot size for a pool holding the given entity types.
+template<typename... T> static constexpr size_t GetEntitySlotSize()
+{
+    static_assert(((alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) && ...));
+    constexpr size_t alignment = std::max({ alignof(T)... });
+    return (std::max({ sizeof(T)... }) + alignment - 1) / alignment * alignment;
+}
+
+EntityStorage::EntityStorage()
+    : Pools{
+        EntityPool(GetEntitySlotSize<Vehicle>()),
+        EntityPool(GetEntitySlotSize<Guest>()),
+        EntityPool(GetEntitySlotSize<Staff>()),
+        EntityPool(GetEntitySlotSize<Litter>()),
+        EntityPool(GetEntitySlotSize<
+                   SteamParticle, MoneyEffect, VehicleCrashParticle, ExplosionCloud, CrashSplashParticle, ExplosionFlare,
+                   JumpingFountain, Balloon, Duck>()),
+    }
+{
+    static_assert(GetEntityPoolIndex(EntityType::Vehicle) == 0);
+    static_assert(GetEntityPoolIndex(EntityType::Guest) == 1);
+    static_assert(GetEntityPoolIndex(EntityType::Staff) == 2);
+    static_assert(GetEntityPoolIndex(EntityType::Litter) == 3);
+}
+
+EntityPool::EntityPool(size_t slotSize)
+    : _slotSize(slotSize)
+{
+}
+
+uint16_t EntityPool::Allocate()
+{
+    if (_freeSlots.empty())
+    {
+        // Slots are zeroed, like the fixed entity array was.
+        _chunks.emplace_back(std::make_unique<std::byte[]>(kChunkSize * _slotSize));
+        const auto first = GetCapacity() - kChunkSize;
+        for (size_t i = 0; i < kChunkSize; i++)
+        {
+            // Ascending indices already form a valid min-heap.
+            _freeSlots.push_back(static_cast<uint16_t>(first + i));
+        }
+    }
+
+    std::pop_heap(std::begin(_freeSlots), std::end(_freeSlots), std::greater<>());
+    const auto slot = _freeSlots.back();
+    _freeSlots.pop_back();
+    return slot;
+}
+
+void EntityPool::Free(uint16_t slot)
+{
+    _freeSlots.push_back(slot);
+    std::push_heap(std::begin(_freeSlots), std::end(_freeSlots), std::greater<>());
+}
+
+EntityBase* EntityPool::Get(uint16_t slot) const
+{
+    auto* memory = &_chunks[slot / kChunkSize][(slot % kChunkSize) * _slotSize];
+    return reinterpret_cast<EntityBase*>(memory);
+}
+
+void EntityPool::Clear()
+{
+    _chunks.clear();
+    _freeSlots.clear();
+}
+
+size_t EntityPool::GetCapacity() const
+{
+    return _chunks.size() * kChunkSize;
+}
+
+size_t EntityPool::GetSlotSize() const
+{
+    return _slotSize;
+}
+
+size_t GetEntityMemoryUsage()
+{
+    size_t usage = 0;
+    for (const auto& pool : GetGameState().Entities.Pools)
+    {
+        usage += pool.GetCapacity() * pool.GetSlotSize();
+    }
+    return usage;
+}
+
+EntityUpdateMode EntityGetUpdateMode()
+{
+    return _entityUpdateMode;
+}
+
+void EntitySetUpdateMode(EntityUpdateMode mode)
+{
+    _entityUpdateMode = mode;
+}
+
 uint16_t GetEntityListCount(EntityType type)
 {
     return static_cast<uint16_t>(gEntityLists[EnumValue(type)].size());
@@ -114,7 +234,11 @@ EntityBase* TryGetEntity(EntityId entityIndex)
 {
     auto& gameState = GetGameState();
     const auto idx = entityIndex.ToUnderlying();
-    return idx >= MAX_ENTITIES ? nullptr : &gameState.Entities[idx].base;
+    if (idx >= MAX_ENTITIES)
+    {
+        return nullptr;
+    }
+    return gameState.Entities.Slots[idx];
 }
 
 EntityBase* GetEntity(EntityId entityIndex)
@@ -127,9 +251,19 @@ EntityBase* GetEntity(EntityId entityIndex)
     return TryGetEntity(entityIndex);
 }
 
-const std::vector<EntityId>& GetEntityTileList(const CoordsXY& spritePos)
+EntityId GetFirstEntityOnTile(const CoordsXY& spritePos)
+{
+    return _spatialFirst[ComputeSpatialIndex(spritePos)];
+}
+
+EntityId GetNextEntityOnTile(EntityId entityIndex)
 {
-    return gEntitySpatialIndex[ComputeSpatialIndex(spritePos)];
+    return _spatialNext[entityIndex.ToUnderlying()];
+}
+
+const std::vector<EntityId>& GetEntitiesMovedOffTile(EntityType type)
+{
+    return _spatialDirty[EnumValue(type)];
 }
 
 static void ResetEntityLists()
@@ -153,7 +287,7 @@ static void ResetFreeIds()
     });
 }
 
-const std::list<EntityId>& GetEntityList(const EntityType id)
+const std::vector<EntityId>& GetEntityList(const EntityType id)
 {
     return gEntityLists[EnumValue(id)];
 }
@@ -175,22 +309,18 @@ void ResetAllEntities()
         FreeEntity(*spr);
     }
 
+    // Nothing may keep pointing into the released pools.
+    EntityTweener::Get().Reset();
+
     auto& gameState = GetGameState();
-    std::fill(std::begin(gameState.Entities), std::end(gameState.Entities), Entity_t());
-    OpenRCT2::RideUse::GetHistory().Clear();
-    OpenRCT2::RideUse::GetTypeHistory().Clear();
-    for (int32_t i = 0; i < MAX_ENTITIES; ++i)
+    for (auto& pool : gameState.Entities.Pools)
     {
-        auto* spr = GetEntity(EntityId::FromUnderlying(i));
-        if (spr == nullptr)
-        {
-            continue;
-        }
-        spr->Type = EntityType::Null;
-        spr->Id = EntityId::FromUnderlying(i);
-
-        _entityFlashingList[i] = false;
+        pool.Clear();
     }
+    std::fill(std::begin(gameState.Entities.Slots), std::end(gameState.Entities.Slots), nullptr);
+    OpenRCT2::RideUse::GetHistory().Clear();
+    OpenRCT2::RideUse::GetTypeHistory().Clear();
+    std::fill(std::begin(_entityFlashingList), std::end(_entityFlashingList), false);
     ResetEntityLists();
     ResetFreeIds();
     ResetEntitySpatialIndices();
@@ -206,9 +336,12 @@ static void EntitySpatialInsert(EntityBase* entity, const CoordsXY& newLoc);
  */
 void ResetEntitySpatialIndices()
 {
-    for (auto& vec : gEntitySpatialIndex)
+    std::fill(std::begin(_spatialFirst), std::end(_spatialFirst), EntityId::GetNull());
+    std::fill(std::begin(_spatialNext), std::end(_spatialNext), EntityId::GetNull());
+    std::fill(std::begin(_spatialPrev), std::end(_spatialPrev), EntityId::GetNull());
+    for (auto& dirty : _spatialDirty)
     {
-        vec.clear();
+        dirty.clear();
     }
     for (EntityId::UnderlyingType i = 0; i < MAX_ENTITIES; i++)
     {
@@ -254,14 +387,13 @@ EntitiesChecksum GetAllEntitiesChecksum()
 
 #endif // DISABLE_NETWORK
 
-static void EntityReset(EntityBase* entity)
+static void EntityReset(EntityBase* entity, size_t slotSize)
 {
     // Need to retain how the sprite is linked in lists
     auto entityIndex = entity->Id;
     _entityFlashingList[entityIndex.ToUnderlying()] = false;
 
-    Entity_t* tempEntity = reinterpret_cast<Entity_t*>(entity);
-    *tempEntity = Entity_t();
+    std::memset(static_cast<void*>(entity), 0, slotSize);
 
     entity->Id = entityIndex;
     entity->Type = EntityType::Null;
@@ -304,11 +436,19 @@ uint16_t GetMiscEntityCount()
     return count;
 }
 
-static void PrepareNewEntity(EntityBase* base, const EntityType type)
+static EntityBase* PrepareNewEntity(const EntityId index, const EntityType type)
 {
+    auto& storage = GetGameState().Entities;
+    auto& pool = storage.Pools[GetEntityPoolIndex(type)];
+    const auto slot = pool.Allocate();
+    auto* base = pool.Get(slot);
+    storage.Slots[index.ToUnderlying()] = base;
+    storage.SlotIndices[index.ToUnderlying()] = slot;
+
     // Need to reset all sprite data, as the uninitialised values
     // may contain garbage and cause a desync later on.
-    EntityReset(base);
+    base->Id = index;
+    EntityReset(base, pool.GetSlotSize());
 
     base->Type = type;
     AddToEntityList(base);
@@ -323,6 +463,7 @@ static void PrepareNewEntity(EntityBase* base, const EntityType type)
     base->SpatialIndex = kInvalidSpatialIndex;
 
     EntitySpatialInsert(base, { kLocationNull, 0 });
+    return base;
 }
 
 EntityBase* CreateEntity(EntityType type)
@@ -348,16 +489,10 @@ EntityBase* CreateEntity(EntityType type)
         }
     }
 
-    auto* entity = GetEntity(_freeIdList.back());
-    if (entity == nullptr)
-    {
-        return nullptr;
-    }
+    const auto index = _freeIdList.back();
     _freeIdList.pop_back();
 
-    PrepareNewEntity(entity, type);
-
-    return entity;
+    return PrepareNewEntity(index, type);
 }
 
 EntityBase* CreateEntityAt(const EntityId index, const EntityType type)
@@ -368,16 +503,9 @@ EntityBase* CreateEntityAt(const EntityId index, const EntityType type)
         return nullptr;
     }
 
-    auto* entity = GetEntity(index);
-    if (entity == nullptr)
-    {
-        return nullptr;
-    }
-
     _freeIdList.erase(std::next(id).base());
 
-    PrepareNewEntity(entity, type);
-    return entity;
+    return PrepareNewEntity(index, type);
 }
 
 template<typename T> void MiscUpdateAllType()
@@ -415,40 +543,93 @@ void UpdateMoneyEffect()
 static void EntitySpatialInsert(EntityBase* entity, const CoordsXY& newLoc)
 {
     const auto newIndex = ComputeSpatialIndex(newLoc);
+    const auto id = entity->Id;
+    const auto idx = id.ToUnderlying();
+
+    auto& first = _spatialFirst[newIndex];
+    if (first.IsNull())
+    {
+        first = id;
+        _spatialPrev[idx] = id;
+        _spatialNext[idx] = EntityId::GetNull();
+    }
+    else if (_spatialPrev[first.ToUnderlying()] < id)
+    {
+        // Append after the last entity.
+        const auto last = _spatialPrev[first.ToUnderlying()];
+        _spatialNext[last.ToUnderlying()] = id;
+        _spatialPrev[idx] = last;
+        _spatialNext[idx] = EntityId::GetNull();
+        _spatialPrev[first.ToUnderlying()] = id;
+    }
+    else
+    {
+        auto next = first;
+        while (next < id)
+        {
+            next = _spatialNext[next.ToUnderlying()];
+        }
 
-    auto& spatialVector = gEntitySpatialIndex[newIndex];
-    auto index = std::lower_bound(std::begin(spatialVector), std::end(spatialVector), entity->Id);
-    spatialVector.insert(index, entity->Id);
+        const auto prev = _spatialPrev[next.ToUnderlying()];
+        _spatialPrev[idx] = prev;
+        _spatialNext[idx] = next;
+        _spatialPrev[next.ToUnderlying()] = id;
+        if (next == first)
+        {
+            first = id;
+        }
+        else
+        {
+            _spatialNext[prev.ToUnderlying()] = id;
+        }
+    }
 
     entity->SpatialIndex = newIndex;
 }
 
 static void EntitySpatialRemove(EntityBase* entity)
 {
-    const auto currentIndex = GetSpatialIndex(entity);
-
-    auto& spatialVector = gEntitySpatialIndex[currentIndex];
-    auto index = BinaryFind(std::begin(spatialVector), std::end(spatialVector), entity->Id);
-    if (index != std::end(spatialVector))
-    {
-        spatialVector.erase(index, index + 1);
-    }
-    else
+    const auto id = entity->Id;
+    const auto idx = id.ToUnderlying();
+    if (_spatialPrev[idx].IsNull() || GetSpatialIndex(entity) >= kSpatialIndexSize)
     {
         LOG_WARNING("Bad sprite spatial index. Rebuilding the spatial index...");
         ResetEntitySpatialIndices();
     }
 
+    if (!_spatialPrev[idx].IsNull())
+    {
+        auto& first = _spatialFirst[GetSpatialIndex(entity)];
+        const auto prev = _spatialPrev[idx];
+        const auto next = _spatialNext[idx];
+        if (first == id)
+        {
+            first = next;
+            if (!next.IsNull())
+            {
+                _spatialPrev[next.ToUnderlying()] = prev;
+            }
+        }
+        else
+        {
+            _spatialNext[prev.ToUnderlying()] = next;
+            _spatialPrev[next.IsNull() ? first.ToUnderlying() : next.ToUnderlying()] = prev;
+        }
+        _spatialPrev[idx] = EntityId::GetNull();
+        _spatialNext[idx] = EntityId::GetNull();
+    }
+
     entity->SpatialIndex = kInvalidSpatialIndex;
 }
 
 void UpdateEntitiesSpatialIndex()
 {
-    for (auto& entityList : gEntityLists)
+    for (auto& dirty : _spatialDirty)
     {
-        for (auto& entityId : entityList)
+        // Rebuilding the index after a bad entry clears the list, so check its size on every iteration.
+        for (size_t i = 0; i < dirty.size(); i++)
         {
-            auto* entity = GetEntity(entityId);
+            auto* entity = GetEntity(dirty[i]);
             if (entity == nullptr || entity->Type == EntityType::Null)
                 continue;
 
@@ -461,6 +642,7 @@ void UpdateEntitiesSpatialIndex()
                 EntitySpatialInsert(entity, { entity->x, entity->y });
             }
         }
+        dirty.clear();
     }
 }
 
@@ -474,6 +656,10 @@ void EntityBase::SetLocation(const CoordsXYZ& newLocation)
     x = newLocation.x;
     y = newLocation.y;
     z = newLocation.z;
+    if (!(SpatialIndex & kSpatialIndexDirtyMask) && Type < EntityType::Count)
+    {
+        _spatialDirty[EnumValue(Type)].push_back(Id);
+    }
     SpatialIndex |= kSpatialIndexDirtyMask;
 }
 
@@ -545,7 +731,14 @@ void EntityRemove(EntityBase* entity)
     AddToFreeList(entity->Id);
 
     EntitySpatialRemove(entity);
-    EntityReset(entity);
+
+    // The slot keeps its memory so pointers held by the caller can still see the entity has been removed.
+    auto& storage = GetGameState().Entities;
+    auto& pool = storage.Pools[GetEntityPoolIndex(entity->Type)];
+    const auto index = entity->Id.ToUnderlying();
+    EntityReset(entity, pool.GetSlotSize());
+    pool.Free(storage.SlotIndices[index]);
+    storage.Slots[index] = nullptr;
 }
 
 /**
@@ -12,21 +12,55 @@
 #include "EntityBase.h"
 
 #include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+constexpr uint16_t MAX_ENTITIES = 65535;
 
 namespace OpenRCT2
 {
-    union Entity_t
+    /**
+     * Slots for the entities of one group of entity types, each as large as the largest type in the group. Slots are
+     * allocated in chunks which are never moved, so pointers to entities stay valid until the pool is cleared.
+     */
+    class EntityPool
     {
-        uint8_t Pad00[0x200];
-        EntityBase base;
-        Entity_t()
-            : Pad00()
-        {
-        }
+    public:
+        static constexpr size_t kChunkSize = 256;
+
+        explicit EntityPool(size_t slotSize);
+
+        // Returns the index of the lowest free slot, growing the pool if there is none.
+        uint16_t Allocate();
+        void Free(uint16_t slot);
+        EntityBase* Get(uint16_t slot) const;
+        void Clear();
+        size_t GetCapacity() const;
+        size_t GetSlotSize() const;
+
+    private:
+        size_t _slotSize;
+        std::vector<std::unique_ptr<std::byte[]>> _chunks;
+        // Min-heap of free slot indices, so holes left by removed entities are filled lowest first.
+        std::vector<uint16_t> _freeSlots;
     };
-} // namespace OpenRCT2
 
-constexpr uint16_t MAX_ENTITIES = 65535;
+    /**
+     * Guests, staff, vehicles and litter each have their own pool, all other entity types share one.
+     */
+    struct EntityStorage
+    {
+        static constexpr size_t kMiscPool = 4;
+
+        EntityStorage();
+
+        std::array<EntityPool, kMiscPool + 1> Pools;
+        std::array<EntityBase*, MAX_ENTITIES> Slots{};
+        // Index of each entity's slot in its pool.
+        std::array<uint16_t, MAX_ENTITIES> SlotIndices{};
+    };
+} // namespace OpenRCT2
 
 EntityBase* GetEntity(EntityId sprite_idx);
 
@@ -59,6 +93,20 @@ template<typename T> T* CreateEntityAt(const EntityId index)
     return static_cast<T*>(CreateEntityAt(index, T::cEntityType));
 }
 
+// Bytes allocated for entity slots, see OpenRCT2::EntityPool.
+size_t GetEntityMemoryUsage();
+
+enum class EntityUpdateMode : uint8_t
+{
+    Serial,
+    // Guests prepare their pathfinding searches on multiple threads before they update, the result is identical to the
+    // serial update.
+    Parallel,
+};
+
+EntityUpdateMode EntityGetUpdateMode();
+void EntitySetUpdateMode(EntityUpdateMode mode);
+
 void ResetAllEntities();
 void ResetEntitySpatialIndices();
 void UpdateAllMiscEntities();
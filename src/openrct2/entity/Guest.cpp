@@ -42,6 +42,7 @@
 #include "../rct2/RCT2.h"
 #include "../ride/Ride.h"
 #include "../ride/RideData.h"
+#include "../ride/RideOccupancy.h"
 #include "../ride/ShopItem.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
@@ -1898,36 +1899,12 @@ OpenRCT2::BitSet<OpenRCT2::Limits::kMaxRidesInPark> Guest::FindRidesToGoOn()
     else
     {
         // Take nearby rides into consideration
-        constexpr auto radius = 10 * 32;
-        int32_t cx = Floor2(x, 32);
-        int32_t cy = Floor2(y, 32);
-        for (int32_t tileX = cx - radius; tileX <= cx + radius; tileX += kCoordsXYStep)
-        {
-            for (int32_t tileY = cy - radius; tileY <= cy + radius; tileY += kCoordsXYStep)
-            {
-                auto location = CoordsXY{ tileX, tileY };
-                if (!MapIsLocationValid(location))
-                    continue;
-
-                for (auto* trackElement : TileElementsView<TrackElement>(location))
-                {
-                    auto rideIndex = trackElement->GetRideIndex();
-                    if (!rideIndex.IsNull())
-                    {
-                        rideConsideration[rideIndex.ToUnderlying()] = true;
-                    }
-                }
-            }
-        }
+        constexpr auto radius = 10;
+        const TileCoordsXY centre{ Floor2(x, 32) / kCoordsXYStep, Floor2(y, 32) / kCoordsXYStep };
+        RideOccupancy::AddRidesNear(rideConsideration, centre, radius);
 
         // Always take the tall rides into consideration (realistic as you can usually see them from anywhere in the park)
-        for (auto& ride : GetRideManager())
-        {
-            if (ride.highest_drop_height > 66 || ride.ratings.excitement >= RIDE_RATING(8, 00))
-            {
-                rideConsideration[ride.id.ToUnderlying()] = true;
-            }
-        }
+        RideOccupancy::AddTallRides(rideConsideration);
     }
 
     return rideConsideration;
@@ -2453,7 +2430,7 @@ static void PeepRideIsTooIntense(Guest* peep, Ride& ride, bool peepAtRide)
  *
  *  rct2: 0x00691C6E
  */
-static Vehicle* PeepChooseCarFromRide(Peep* peep, const Ride& ride, std::vector<uint8_t>& car_array)
+static Vehicle* PeepChooseCarFromRide(Peep* peep, const Ride& ride, Guest::CarArray& car_array)
 {
     uint8_t chosen_car = ScenarioRand();
     if (ride.GetRideTypeDescriptor().HasFlag(RtdFlag::hasGForces) && ((chosen_car & 0xC) != 0xC))
@@ -2546,7 +2523,7 @@ void Guest::GoToRideEntrance(const Ride& ride)
     RemoveFromQueue();
 }
 
-bool Guest::FindVehicleToEnter(const Ride& ride, std::vector<uint8_t>& car_array)
+bool Guest::FindVehicleToEnter(const Ride& ride, CarArray& car_array)
 {
     uint8_t chosen_train = RideStation::kNoTrain;
 
@@ -3484,7 +3461,7 @@ void Guest::UpdateRideAtEntrance()
         }
     }
 
-    std::vector<uint8_t> carArray;
+    CarArray carArray;
 
     if (ride->GetRideTypeDescriptor().HasFlag(RtdFlag::noVehicles))
     {
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "../core/BitSet.hpp"
+#include "../core/FixedVector.h"
 #include "../management/Finance.h"
 #include "../ride/Ride.h"
 #include "../ride/ShopItem.h"
@@ -260,6 +261,9 @@ struct Guest : Peep
 {
     static constexpr auto cEntityType = EntityType::Guest;
 
+    // Indices of the cars of a train that have a free seat.
+    using CarArray = FixedVector<uint8_t, OpenRCT2::Limits::kMaxCarsPerTrain>;
+
 public:
     uint8_t GuestNumRides;
     EntityId GuestNextInQueue;
@@ -423,7 +427,7 @@ private:
     void GivePassingPeepsIceCream(Guest* passingPeep);
     Ride* FindBestRideToGoOn();
     OpenRCT2::BitSet<OpenRCT2::Limits::kMaxRidesInPark> FindRidesToGoOn();
-    bool FindVehicleToEnter(const Ride& ride, std::vector<uint8_t>& car_array);
+    bool FindVehicleToEnter(const Ride& ride, CarArray& car_array);
     void GoToRideEntrance(const Ride& ride);
 };
 
@@ -4,6 +4,7 @@
 #include "../Game.h"
 #include "../GameState.h"
 #include "../core/DataSerialiser.h"
+#include "../core/TickArena.h"
 #include "../localisation/StringIds.h"
 #include "../paint/Paint.h"
 #include "../profiling/Profiling.h"
@@ -99,7 +100,7 @@ void Litter::Create(const CoordsXYZD& litterPos, Type type)
  */
 void Litter::RemoveAt(const CoordsXYZ& litterPos)
 {
-    std::vector<Litter*> removals;
+    TickVector<Litter*> removals;
     for (auto litter : EntityTileList<Litter>(litterPos))
     {
         if (abs(litter->z - litterPos.z) <= 16)
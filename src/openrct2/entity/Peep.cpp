@@ -206,6 +206,12 @@ void PeepUpdateAll()
     constexpr auto kTicks128Mask = 128u - 1u;
     const auto currentTicksMasked = currentTicks & kTicks128Mask;
 
+    const bool parallel = EntityGetUpdateMode() == EntityUpdateMode::Parallel;
+    if (parallel)
+    {
+        PathFinding::PrepareGuestDirections();
+    }
+
     uint32_t index = 0;
     // Warning this loop can delete peeps
     for (auto peep : EntityList<Guest>())
@@ -224,6 +230,11 @@ void PeepUpdateAll()
         index++;
     }
 
+    if (parallel)
+    {
+        PathFinding::ForgetPreparedDirections();
+    }
+
     for (auto staff : EntityList<Staff>())
     {
         if ((index & kTicks128Mask) == currentTicksMasked)
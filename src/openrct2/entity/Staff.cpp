@@ -334,20 +334,31 @@ bool Staff::HasPatrolArea() const
  */
 Direction Staff::HandymanDirectionToNearestLitter() const
 {
-    uint16_t nearestLitterDist = 0xFFFF;
+    const auto litterDistance = [this](const Litter& litter) -> uint32_t {
+        return static_cast<uint16_t>(abs(litter.x - x) + abs(litter.y - y) + abs(litter.z - z) * 4);
+    };
+
+    // The distance is truncated to 16 bits. On maps this large far away litter can appear to be close, so all of it has
+    // to be checked.
+    const auto mapSize = GetGameState().MapSize;
+    const auto maxDistance = (mapSize.x + mapSize.y) * kCoordsXYStep + 4 * MAX_ELEMENT_HEIGHT * kCoordsZStep;
     Litter* nearestLitter = nullptr;
-    for (auto litter : EntityList<Litter>())
+    if (maxDistance > 0xFFFF)
     {
-        uint16_t distance = abs(litter->x - x) + abs(litter->y - y) + abs(litter->z - z) * 4;
-
-        if (distance < nearestLitterDist)
+        for (auto litter : EntityList<Litter>())
         {
-            nearestLitterDist = distance;
-            nearestLitter = litter;
+            if (nearestLitter == nullptr || litterDistance(*litter) < litterDistance(*nearestLitter))
+            {
+                nearestLitter = litter;
+            }
         }
     }
+    else
+    {
+        nearestLitter = FindNearestEntity<Litter>({ x, y }, MAX_LITTER_DISTANCE, litterDistance);
+    }
 
-    if (nearestLitterDist > MAX_LITTER_DISTANCE)
+    if (nearestLitter == nullptr || litterDistance(*nearestLitter) > MAX_LITTER_DISTANCE)
     {
         return INVALID_DIRECTION;
     }
@@ -47,12 +47,14 @@
 #include "../management/NewsItem.h"
 #include "../management/Research.h"
 #include "../network/network.h"
+#include "../peep/GuestPathfinding.h"
 #include "../object/Object.h"
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../object/ObjectRepository.h"
 #include "../platform/Platform.h"
 #include "../profiling/Profiling.h"
+#include "../profiling/TickTimeline.h"
 #include "../ride/Ride.h"
 #include "../ride/RideData.h"
 #include "../ride/Vehicle.h"
@@ -1423,7 +1425,7 @@ static int32_t ConsoleCommandShowLimits(InteractiveConsole& console, [[maybe_unu
 
     auto bannerCount = GetNumBanners();
 
-    console.WriteFormatLine("Sprites: %d/%d", spriteCount, MAX_ENTITIES);
+    console.WriteFormatLine("Sprites: %d/%d (%zu KiB)", spriteCount, MAX_ENTITIES, GetEntityMemoryUsage() / 1024);
     console.WriteFormatLine("Map Elements: %zu/%d", tileElementCount, MAX_TILE_ELEMENTS);
     console.WriteFormatLine("Banners: %d/%zu", bannerCount, MAX_BANNERS);
     console.WriteFormatLine("Rides: %d/%d", rideCount, OpenRCT2::Limits::kMaxRidesInPark);
@@ -1920,6 +1922,81 @@ static int32_t ConsoleCommandProfilerStop(
     return 0;
 }
 
+static int32_t ConsoleCommandProfilerTimelineStart(InteractiveConsole& console, const arguments_t& argv)
+{
+    using namespace OpenRCT2::Profiling;
+
+    size_t capacity = TickTimeline::kDefaultCapacity;
+    if (argv.size() >= 1)
+    {
+        const auto ticks = atoi(argv[0].c_str());
+        if (ticks <= 0)
+        {
+            console.WriteLineError("Invalid number of ticks");
+            return 1;
+        }
+        capacity = static_cast<size_t>(ticks);
+    }
+
+    TickTimeline::Start(capacity);
+    console.WriteFormatLine("Recording the last %zu ticks", capacity);
+    return 0;
+}
+
+static int32_t ConsoleCommandProfilerTimelineExport(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (argv.size() < 1)
+    {
+        console.WriteLineError("Missing argument: <file path>");
+        return 1;
+    }
+
+    const auto& filePath = argv[0];
+    if (!OpenRCT2::Profiling::TickTimeline::Export(filePath))
+    {
+        console.WriteFormatLine("Unable to export tick timeline to %s", filePath.c_str());
+        return 1;
+    }
+
+    console.WriteFormatLine("Wrote tick timeline: \"%s\"", filePath.c_str());
+    return 0;
+}
+
+static int32_t ConsoleCommandProfilerTimelineStop(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (OpenRCT2::Profiling::TickTimeline::IsRecording())
+        console.WriteLine("Stopped recording the tick timeline");
+    OpenRCT2::Profiling::TickTimeline::Stop();
+
+    // Export if argument is provided.
+    if (argv.size() >= 1)
+    {
+        return ConsoleCommandProfilerTimelineExport(console, argv);
+    }
+
+    return 0;
+}
+
+static int32_t ConsoleCommandPathfindingCache(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (argv.size() >= 1 && argv[0] == "reset")
+    {
+        OpenRCT2::PathFinding::ResetDirectionCacheStats();
+        console.WriteLine("Reset pathfinding cache counters");
+        return 0;
+    }
+
+    const auto stats = OpenRCT2::PathFinding::GetDirectionCacheStats();
+    const auto lookups = stats.Hits + stats.Misses;
+    const auto hitRate = lookups == 0 ? 0.0 : static_cast<double>(stats.Hits) * 100.0 / static_cast<double>(lookups);
+    console.WriteFormatLine("Hits: %llu", static_cast<unsigned long long>(stats.Hits));
+    console.WriteFormatLine("Misses: %llu", static_cast<unsigned long long>(stats.Misses));
+    console.WriteFormatLine("Prepared: %llu", static_cast<unsigned long long>(stats.Prepared));
+    console.WriteFormatLine("Hit rate: %.1f%%", hitRate);
+    console.WriteFormatLine("Cached directions: %zu", stats.Entries);
+    return 0;
+}
+
 static int32_t ConsoleSpawnBalloon(InteractiveConsole& console, const arguments_t& argv)
 {
     if (argv.size() < 3)
@@ -2048,6 +2125,14 @@ static constexpr ConsoleCommand console_command_table[] = {
     { "profiler_stop", ConsoleCommandProfilerStop, "Stops the profiler.", "profiler_stop [<output file>]" },
     { "profiler_exportcsv", ConsoleCommandProfilerExportCSV, "Exports the current profiler data.",
       "profiler_exportcsv <output file>" },
+    { "profiler_timeline_start", ConsoleCommandProfilerTimelineStart,
+      "Starts recording the time spent in each phase of a tick.", "profiler_timeline_start [<ticks to keep>]" },
+    { "profiler_timeline_stop", ConsoleCommandProfilerTimelineStop, "Stops recording the tick timeline.",
+      "profiler_timeline_stop [<output file>]" },
+    { "profiler_timeline_export", ConsoleCommandProfilerTimelineExport,
+      "Exports the tick timeline as a Chrome trace, or as CSV for a .csv file.", "profiler_timeline_export <output file>" },
+    { "pathfinding_cache", ConsoleCommandPathfindingCache, "Shows or resets the guest pathfinding cache counters.",
+      "pathfinding_cache [reset]" },
 };
 
 static int32_t ConsoleCommandWindows(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
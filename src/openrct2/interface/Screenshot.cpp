@@ -371,6 +371,16 @@ void ScreenshotGiant()
     ReleaseDPI(dpi);
 }
 
+size_t ScreenshotRenderGiant(ZoomLevel zoom, uint8_t rotation)
+{
+    auto viewport = GetGiantViewport(rotation & 3, zoom);
+    auto dpi = CreateDPI(viewport);
+    RenderViewport(nullptr, viewport, dpi);
+    const auto pixels = static_cast<size_t>(dpi.width) * dpi.height;
+    ReleaseDPI(dpi);
+    return pixels;
+}
+
 static void ApplyOptions(const ScreenshotOptions* options, Viewport& viewport)
 {
     if (options->weather != WeatherType::Sunny && options->weather != WeatherType::Count)
@@ -56,6 +56,8 @@ std::string ScreenshotDump();
 std::string ScreenshotDumpPNG(DrawPixelInfo& dpi);
 
 void ScreenshotGiant();
+// Renders the whole map the way a giant screenshot does without saving it, returns the number of pixels drawn.
+size_t ScreenshotRenderGiant(ZoomLevel zoom, uint8_t rotation);
 int32_t CommandLineForScreenshot(const char** argv, int32_t argc, ScreenshotOptions* options);
 
 void CaptureImage(const CaptureOptions& options);
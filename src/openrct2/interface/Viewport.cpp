@@ -27,6 +27,7 @@
 #include "../object/LargeSceneryEntry.h"
 #include "../object/SmallSceneryEntry.h"
 #include "../object/WallSceneryEntry.h"
+#include "../paint/Paint.TileCache.h"
 #include "../paint/Paint.h"
 #include "../profiling/Profiling.h"
 #include "../ride/Ride.h"
@@ -63,7 +64,7 @@ uint8_t gShowConstructionRightsRefCount;
 static std::list<Viewport> _viewports;
 Viewport* g_music_tracking_viewport;
 
-static std::unique_ptr<JobPool> _paintJobs;
+static JobPool* _paintJobs;
 static std::vector<PaintSession*> _paintColumns;
 
 InteractionInfo::InteractionInfo(const PaintStruct* ps)
@@ -243,6 +244,8 @@ static Viewport* ViewportGetMain()
 
 void ViewportsInvalidate(int32_t x, int32_t y, int32_t z0, int32_t z1, ZoomLevel maxZoom)
 {
+    PaintTileCacheInvalidateTile({ x, y });
+
     for (auto& vp : _viewports)
     {
         if (maxZoom == ZoomLevel{ -1 } || vp.zoom <= ZoomLevel{ maxZoom })
@@ -936,7 +939,7 @@ static void ViewportFillColumn(PaintSession& session)
     PROFILED_FUNCTION();
 
     PaintSessionGenerate(session);
-    PaintSessionArrange(session);
+    PaintSessionArrange(session, _paintJobs);
 }
 
 static void ViewportPaintColumn(PaintSession& session)
@@ -1004,14 +1007,8 @@ static void ViewportPaint(const Viewport* viewport, DrawPixelInfo& dpi)
     _paintColumns.clear();
 
     bool useMultithreading = Config::Get().general.MultiThreading;
-    if (useMultithreading && _paintJobs == nullptr)
-    {
-        _paintJobs = std::make_unique<JobPool>();
-    }
-    else if (useMultithreading == false && _paintJobs != nullptr)
-    {
-        _paintJobs.reset();
-    }
+    _paintJobs = useMultithreading ? &JobPool::GetShared() : nullptr;
+    JobPool::TaskGroup paintGroup;
 
     bool useParallelDrawing = false;
     if (useMultithreading && (dpi.DrawingEngine->GetFlags() & DEF_PARALLEL_DRAWING))
@@ -1027,6 +1024,7 @@ static void ViewportPaint(const Viewport* viewport, DrawPixelInfo& dpi)
     for (int32_t x = alignedX; x < rightBorder; x += columnWidth)
     {
         PaintSession* session = PaintSessionAlloc(worldDpi, viewport->flags, viewport->rotation);
+        PaintTileCacheBeginSession(*session);
         _paintColumns.push_back(session);
 
         DrawPixelInfo& columnDpi = session->DPI;
@@ -1050,7 +1048,7 @@ static void ViewportPaint(const Viewport* viewport, DrawPixelInfo& dpi)
 
         if (useMultithreading)
         {
-            _paintJobs->AddTask([session]() -> void { ViewportFillColumn(*session); });
+            _paintJobs->AddTask(paintGroup, [session]() -> void { ViewportFillColumn(*session); });
         }
         else
         {
@@ -1060,7 +1058,7 @@ static void ViewportPaint(const Viewport* viewport, DrawPixelInfo& dpi)
 
     if (useMultithreading)
     {
-        _paintJobs->Join();
+        _paintJobs->Wait(paintGroup);
     }
 
     // Paint columns.
@@ -1068,7 +1066,7 @@ static void ViewportPaint(const Viewport* viewport, DrawPixelInfo& dpi)
     {
         if (useParallelDrawing)
         {
-            _paintJobs->AddTask([session]() -> void { ViewportPaintColumn(*session); });
+            _paintJobs->AddTask(paintGroup, [session]() -> void { ViewportPaintColumn(*session); });
         }
         else
         {
@@ -1077,13 +1075,13 @@ static void ViewportPaint(const Viewport* viewport, DrawPixelInfo& dpi)
     }
     if (useParallelDrawing)
     {
-        _paintJobs->Join();
+        _paintJobs->Wait(paintGroup);
     }
 
-    // Release resources.
-    for (auto* session : _paintColumns)
+    // Release resources in reverse so each column gets the same session back next frame.
+    for (auto it = _paintColumns.rbegin(); it != _paintColumns.rend(); ++it)
     {
-        PaintSessionFree(session);
+        PaintSessionFree(*it);
     }
 }
 
@@ -1765,7 +1763,9 @@ InteractionInfo GetMapCoordinatesFromPosWindow(WindowBase* window, const ScreenC
         dpi.height = 1;
         dpi.width = 1;
 
+        // Tiles replay what they painted for an earlier query unless an image moved in or out of the pixel.
         PaintSession* session = PaintSessionAlloc(dpi, viewport->flags, viewport->rotation);
+        PaintTileCacheBeginSession(*session);
         PaintSessionGenerate(*session);
         PaintSessionArrange(*session);
         info = SetInteractionInfoFromPaintSession(session, viewport->flags, flags & 0xFFFF);
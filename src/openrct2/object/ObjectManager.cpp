@@ -35,6 +35,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -598,7 +599,7 @@ private:
         objectsToLoad.erase(std::unique(objectsToLoad.begin(), objectsToLoad.end()), objectsToLoad.end());
 
         // Prepare for loading objects multi-threaded
-        auto numProcessed = 0;
+        std::atomic<size_t> numProcessed{ 0 };
         auto numRequired = objectsToLoad.size();
         std::mutex commonMutex;
         auto loadSingleObject = [&](const ObjectRepositoryItem* requiredObject) {
@@ -622,20 +623,22 @@ private:
             numProcessed++;
         };
 
-        auto completionFn = [&]() {
-            if (reportProgress && (numProcessed % 100) == 0)
-                ReportProgress(numProcessed, numRequired);
-        };
-
         // Dispatch loading the objects
         JobPool jobs{};
         for (auto* object : objectsToLoad)
         {
-            jobs.AddTask([object, &loadSingleObject]() { loadSingleObject(object); }, completionFn);
+            jobs.AddTask([object, &loadSingleObject]() { loadSingleObject(object); });
         }
 
         // Wait until all jobs are fully completed
-        jobs.Join();
+        size_t numReported = 0;
+        jobs.Join([&]() {
+            if (reportProgress && numProcessed >= numReported + 100)
+            {
+                numReported = numProcessed;
+                ReportProgress(numReported, numRequired);
+            }
+        });
 
         // Assign the loaded objects to the required objects
         for (auto& requiredObject : requiredObjects)
@@ -0,0 +1,97 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "Paint.Sort.h"
+
+#include "../core/Guard.hpp"
+#include "Paint.h"
+
+#ifdef __AVX2__
+
+#    include <bit>
+#    include <immintrin.h>
+
+int32_t PaintSortFindAvx2(
+    const PaintSortBounds& bounds, int32_t begin, int32_t end, const PaintStructBoundBox& initialBBox, uint8_t rotation)
+{
+    // Rotations 1 and 2 flip the comparisons on the x axis, rotations 2 and 3 on the y axis.
+    const __m256i allSet = _mm256_set1_epi32(-1);
+    const __m256i flipX = (rotation == 1 || rotation == 2) ? allSet : _mm256_setzero_si256();
+    const __m256i flipY = (rotation == 2 || rotation == 3) ? allSet : _mm256_setzero_si256();
+    const __m256i keepX = _mm256_xor_si256(flipX, allSet);
+    const __m256i keepY = _mm256_xor_si256(flipY, allSet);
+
+    const __m256i initialX = _mm256_set1_epi32(initialBBox.x);
+    const __m256i initialY = _mm256_set1_epi32(initialBBox.y);
+    const __m256i initialZ = _mm256_set1_epi32(initialBBox.z);
+    const __m256i initialXEnd = _mm256_set1_epi32(initialBBox.x_end);
+    const __m256i initialYEnd = _mm256_set1_epi32(initialBBox.y_end);
+    const __m256i initialZEnd = _mm256_set1_epi32(initialBBox.z_end);
+    const __m256i outsideFlag = _mm256_set1_epi32(OpenRCT2::PaintSortFlags::OutsideQuadrant);
+    const __m256i neighbourFlag = _mm256_set1_epi32(OpenRCT2::PaintSortFlags::Neighbour);
+
+    int32_t i = begin;
+    for (; i + 8 <= end; i += 8)
+    {
+        const __m256i flags = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(bounds.SortFlags + i)));
+        const __m256i outside = _mm256_cmpeq_epi32(_mm256_and_si256(flags, outsideFlag), outsideFlag);
+        const __m256i neighbour = _mm256_cmpeq_epi32(_mm256_and_si256(flags, neighbourFlag), neighbourFlag);
+
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bounds.X + i));
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bounds.Y + i));
+        const __m256i z = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bounds.Z + i));
+        const __m256i xEnd = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bounds.XEnd + i));
+        const __m256i yEnd = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bounds.YEnd + i));
+        const __m256i zEnd = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bounds.ZEnd + i));
+
+        // initial.end >= current.start, computed as the negation of current.start > initial.end.
+        const __m256i aboveZ = _mm256_cmpgt_epi32(z, initialZEnd);
+        const __m256i behindY = _mm256_xor_si256(_mm256_cmpgt_epi32(y, initialYEnd), keepY);
+        const __m256i behindX = _mm256_xor_si256(_mm256_cmpgt_epi32(x, initialXEnd), keepX);
+        const __m256i behind = _mm256_andnot_si256(aboveZ, _mm256_and_si256(behindY, behindX));
+
+        // initial.start < current.end
+        const __m256i overlapZ = _mm256_cmpgt_epi32(zEnd, initialZ);
+        const __m256i overlapY = _mm256_xor_si256(_mm256_cmpgt_epi32(yEnd, initialY), flipY);
+        const __m256i overlapX = _mm256_xor_si256(_mm256_cmpgt_epi32(xEnd, initialX), flipX);
+        const __m256i overlap = _mm256_and_si256(overlapZ, _mm256_and_si256(overlapY, overlapX));
+
+        const __m256i match = _mm256_and_si256(neighbour, _mm256_andnot_si256(overlap, behind));
+
+        const auto outsideMask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(outside)));
+        auto matchMask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(match)));
+        if (outsideMask != 0)
+        {
+            // Only entries in front of the first outside entry count.
+            matchMask &= (1u << std::countr_zero(outsideMask)) - 1;
+            return matchMask != 0 ? i + std::countr_zero(matchMask) : end;
+        }
+        if (matchMask != 0)
+        {
+            return i + std::countr_zero(matchMask);
+        }
+    }
+
+    return PaintSortFindScalar(bounds, i, end, initialBBox, rotation);
+}
+
+#else
+
+#    ifdef OPENRCT2_X86
+#        error You have to compile this file with AVX2 enabled, when targeting x86!
+#    endif
+
+int32_t PaintSortFindAvx2(
+    const PaintSortBounds& bounds, int32_t begin, int32_t end, const PaintStructBoundBox& initialBBox, uint8_t rotation)
+{
+    OpenRCT2::Guard::Fail("AVX2 function called on a CPU that doesn't support AVX2");
+    return end;
+}
+
+#endif // __AVX2__
@@ -0,0 +1,100 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "Paint.Sort.h"
+
+#include "../core/Guard.hpp"
+#include "Paint.h"
+
+#ifdef __SSE4_1__
+
+#    include <bit>
+#    include <cstring>
+#    include <immintrin.h>
+
+int32_t PaintSortFindSse4_1(
+    const PaintSortBounds& bounds, int32_t begin, int32_t end, const PaintStructBoundBox& initialBBox, uint8_t rotation)
+{
+    // Rotations 1 and 2 flip the comparisons on the x axis, rotations 2 and 3 on the y axis.
+    const __m128i allSet = _mm_set1_epi32(-1);
+    const __m128i flipX = (rotation == 1 || rotation == 2) ? allSet : _mm_setzero_si128();
+    const __m128i flipY = (rotation == 2 || rotation == 3) ? allSet : _mm_setzero_si128();
+    const __m128i keepX = _mm_xor_si128(flipX, allSet);
+    const __m128i keepY = _mm_xor_si128(flipY, allSet);
+
+    const __m128i initialX = _mm_set1_epi32(initialBBox.x);
+    const __m128i initialY = _mm_set1_epi32(initialBBox.y);
+    const __m128i initialZ = _mm_set1_epi32(initialBBox.z);
+    const __m128i initialXEnd = _mm_set1_epi32(initialBBox.x_end);
+    const __m128i initialYEnd = _mm_set1_epi32(initialBBox.y_end);
+    const __m128i initialZEnd = _mm_set1_epi32(initialBBox.z_end);
+    const __m128i outsideFlag = _mm_set1_epi32(OpenRCT2::PaintSortFlags::OutsideQuadrant);
+    const __m128i neighbourFlag = _mm_set1_epi32(OpenRCT2::PaintSortFlags::Neighbour);
+
+    int32_t i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        int32_t flagBytes;
+        std::memcpy(&flagBytes, bounds.SortFlags + i, sizeof(flagBytes));
+        const __m128i flags = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(flagBytes));
+        const __m128i outside = _mm_cmpeq_epi32(_mm_and_si128(flags, outsideFlag), outsideFlag);
+        const __m128i neighbour = _mm_cmpeq_epi32(_mm_and_si128(flags, neighbourFlag), neighbourFlag);
+
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bounds.X + i));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bounds.Y + i));
+        const __m128i z = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bounds.Z + i));
+        const __m128i xEnd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bounds.XEnd + i));
+        const __m128i yEnd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bounds.YEnd + i));
+        const __m128i zEnd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bounds.ZEnd + i));
+
+        // initial.end >= current.start, computed as the negation of current.start > initial.end.
+        const __m128i aboveZ = _mm_cmpgt_epi32(z, initialZEnd);
+        const __m128i behindY = _mm_xor_si128(_mm_cmpgt_epi32(y, initialYEnd), keepY);
+        const __m128i behindX = _mm_xor_si128(_mm_cmpgt_epi32(x, initialXEnd), keepX);
+        const __m128i behind = _mm_andnot_si128(aboveZ, _mm_and_si128(behindY, behindX));
+
+        // initial.start < current.end
+        const __m128i overlapZ = _mm_cmpgt_epi32(zEnd, initialZ);
+        const __m128i overlapY = _mm_xor_si128(_mm_cmpgt_epi32(yEnd, initialY), flipY);
+        const __m128i overlapX = _mm_xor_si128(_mm_cmpgt_epi32(xEnd, initialX), flipX);
+        const __m128i overlap = _mm_and_si128(overlapZ, _mm_and_si128(overlapY, overlapX));
+
+        const __m128i match = _mm_and_si128(neighbour, _mm_andnot_si128(overlap, behind));
+
+        const auto outsideMask = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(outside)));
+        auto matchMask = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(match)));
+        if (outsideMask != 0)
+        {
+            // Only entries in front of the first outside entry count.
+            matchMask &= (1u << std::countr_zero(outsideMask)) - 1;
+            return matchMask != 0 ? i + std::countr_zero(matchMask) : end;
+        }
+        if (matchMask != 0)
+        {
+            return i + std::countr_zero(matchMask);
+        }
+    }
+
+    return PaintSortFindScalar(bounds, i, end, initialBBox, rotation);
+}
+
+#else
+
+#    ifdef OPENRCT2_X86
+#        error You have to compile this file with SSE4.1 enabled, when targeting x86!
+#    endif
+
+int32_t PaintSortFindSse4_1(
+    const PaintSortBounds& bounds, int32_t begin, int32_t end, const PaintStructBoundBox& initialBBox, uint8_t rotation)
+{
+    OpenRCT2::Guard::Fail("SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+    return end;
+}
+
+#endif // __SSE4_1__
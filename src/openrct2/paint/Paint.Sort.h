@@ -0,0 +1,51 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+struct PaintStructBoundBox;
+
+namespace OpenRCT2::PaintSortFlags
+{
+    static constexpr uint8_t None = 0;
+    static constexpr uint8_t PendingVisit = (1u << 0);
+    static constexpr uint8_t Neighbour = (1u << 1);
+    static constexpr uint8_t OutsideQuadrant = (1u << 7);
+} // namespace OpenRCT2::PaintSortFlags
+
+/**
+ * Bounding boxes and sort flags of the paint structs being arranged, stored as one array per component
+ * so the comparisons can be done for several paint structs at once.
+ */
+struct PaintSortBounds
+{
+    const int32_t* X;
+    const int32_t* Y;
+    const int32_t* Z;
+    const int32_t* XEnd;
+    const int32_t* YEnd;
+    const int32_t* ZEnd;
+    const uint8_t* SortFlags;
+};
+
+/**
+ * Returns the first neighbour in [begin, end) that has to be drawn before the paint struct with initialBBox,
+ * stops at the first entry flagged as outside the quadrant. Returns end if there is no such entry.
+ */
+using PaintSortFindFunc = int32_t (*)(
+    const PaintSortBounds& bounds, int32_t begin, int32_t end, const PaintStructBoundBox& initialBBox, uint8_t rotation);
+
+int32_t PaintSortFindScalar(
+    const PaintSortBounds& bounds, int32_t begin, int32_t end, const PaintStructBoundBox& initialBBox, uint8_t rotation);
+int32_t PaintSortFindSse4_1(
+    const PaintSortBounds& bounds, int32_t begin, int32_t end, const PaintStructBoundBox& initialBBox, uint8_t rotation);
+int32_t PaintSortFindAvx2(
+    const PaintSortBounds& bounds, int32_t begin, int32_t end, const PaintStructBoundBox& initialBBox, uint8_t rotation);
@@ -0,0 +1,657 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "Paint.TileCache.h"
+
+#include "../GameState.h"
+#include "../OpenRCT2.h"
+#include "../config/Config.h"
+#include "../drawing/Drawing.h"
+#include "../drawing/LightFX.h"
+#include "../entity/PatrolArea.h"
+#include "../entity/Peep.h"
+#include "../interface/Viewport.h"
+#include "../profiling/Profiling.h"
+#include "../ride/TrackDesign.h"
+#include "../world/Map.h"
+#include "../world/TileChanges.h"
+#include "../world/TileElement.h"
+#include "Paint.SessionFlags.h"
+#include "Paint.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+using namespace OpenRCT2;
+
+static constexpr size_t kTileCacheShardCount = 64;
+static constexpr size_t kTileCacheMaxEntriesPerShard = 2048;
+// A tile that spans several paint columns is culled differently in each of them, so every key keeps a few entries.
+static constexpr size_t kTileCacheMaxVariants = 4;
+static constexpr size_t kTileVersionCount = 256 * 256;
+static constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325;
+static constexpr uint64_t kFnvPrime = 0x100000001b3;
+
+// Encodings for paint struct references in the state of a cached tile.
+static constexpr int32_t kNoPaintStruct = -1;
+static constexpr int32_t kUnchangedPaintStruct = -2;
+
+namespace
+{
+    struct TileCacheKey
+    {
+        CoordsXY MapPos;
+        uint32_t ViewFlags;
+        int8_t Zoom;
+        uint8_t Rotation;
+        // Sessions for a single pixel, used for picking, cull nearly every image and would evict the column entries.
+        bool SinglePixel;
+
+        bool operator==(const TileCacheKey& other) const = default;
+    };
+
+    struct TileCacheKeyHash
+    {
+        size_t operator()(const TileCacheKey& key) const noexcept
+        {
+            uint64_t hash = static_cast<uint32_t>(key.MapPos.x) | (static_cast<uint64_t>(key.MapPos.y) << 32);
+            hash ^= (static_cast<uint64_t>(key.ViewFlags) << 17) ^ (static_cast<uint64_t>(key.Zoom) << 8) ^ key.Rotation;
+            hash ^= static_cast<uint64_t>(key.SinglePixel) << 7;
+            hash *= kFnvPrime;
+            return static_cast<size_t>(hash ^ (hash >> 29));
+        }
+    };
+
+    // Screen rectangle of an image added while painting the tile and whether it was within the dpi.
+    struct CachedImage
+    {
+        int32_t Left;
+        int32_t Top;
+        int32_t Right;
+        int32_t Bottom;
+        bool Visible;
+    };
+
+    struct CachedPaintStruct
+    {
+        PaintStruct Data;
+        int32_t Children;
+        int32_t Attached;
+    };
+
+    struct CachedAttachedPaintStruct
+    {
+        AttachedPaintStruct Data;
+        int32_t Next;
+    };
+
+    // Session state after all tile elements of the tile were painted.
+    struct CachedTileState
+    {
+        const SurfaceElement* Surface;
+        TileElement* CurrentlyDrawnTileElement;
+        const TileElement* PathElementOnSameHeight;
+        const TileElement* TrackElementOnSameHeight;
+        CoordsXY SpritePosition;
+        CoordsXY MapPosition;
+        ImageId TrackColours;
+        ImageId SupportColours;
+        SupportHeight SupportSegments[9];
+        SupportHeight Support;
+        uint16_t WaterHeight;
+        TunnelEntry LeftTunnels[kTunnelMaxCount];
+        TunnelEntry RightTunnels[kTunnelMaxCount];
+        uint8_t LeftTunnelCount;
+        uint8_t RightTunnelCount;
+        uint8_t VerticalTunnelHeight;
+        uint8_t Flags;
+        ViewportInteractionItem InteractionType;
+        int32_t LastPS;
+        int32_t LastAttachedPS;
+        int32_t WoodenSupportsPrependTo;
+    };
+
+    struct TileCacheEntry
+    {
+        uint64_t Environment{};
+        uint32_t Epoch{};
+        uint32_t TileVersion{};
+        const TileElement* FirstElement{};
+        uint8_t IncomingReferences{};
+        std::vector<CachedImage> Images;
+        std::vector<CachedPaintStruct> Structs;
+        std::vector<CachedAttachedPaintStruct> Attached;
+        std::vector<int32_t> Quadrants;
+        CachedTileState State{};
+    };
+
+    struct TileCacheShard
+    {
+        std::mutex Mutex;
+        std::unordered_map<TileCacheKey, std::vector<TileCacheEntry>, TileCacheKeyHash> Entries;
+    };
+} // namespace
+
+struct PaintTileRecording
+{
+    TileCacheKey Key{};
+    uint32_t Epoch{};
+    uint32_t TileVersion{};
+    const TileElement* FirstElement{};
+    uint8_t IncomingReferences{};
+    bool Valid{};
+    std::vector<CachedImage> Images;
+    std::vector<const PaintStruct*> Structs;
+    std::vector<const AttachedPaintStruct*> Attached;
+    std::vector<const PaintStruct*> Quadrants;
+    const PaintStruct* InitialLastPS{};
+    const AttachedPaintStruct* InitialLastAttachedPS{};
+    const PaintStruct* InitialWoodenSupportsPrependTo{};
+};
+
+static std::array<TileCacheShard, kTileCacheShardCount> _tileCacheShards;
+static std::array<std::atomic<uint32_t>, kTileVersionCount> _tileVersions{};
+static std::atomic<uint32_t> _tileCacheEpoch{};
+static uint32_t _tileChangesCookie;
+static thread_local PaintTileRecording _recording;
+static thread_local std::vector<PaintStruct*> _replayStructs;
+static thread_local std::vector<AttachedPaintStruct*> _replayAttached;
+
+static Profiling::Counter _tileCacheHits("Paint tile cache hits");
+static Profiling::Counter _tileCacheMisses("Paint tile cache misses");
+
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * kFnvPrime;
+    }
+    return hash;
+}
+
+template<typename T> static uint64_t HashValue(uint64_t hash, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    return HashBytes(hash, &value, sizeof(T));
+}
+
+/**
+ * Everything outside of the map that tile element painters read.
+ */
+static uint64_t HashEnvironment(const PaintSession& session)
+{
+    auto hash = kFnvOffsetBasis;
+    hash = HashValue(hash, gMapSelectFlags);
+    hash = HashValue(hash, gMapSelectType);
+    hash = HashValue(hash, gMapSelectPositionA);
+    hash = HashValue(hash, gMapSelectPositionB);
+    hash = HashValue(hash, gMapSelectArrowPosition);
+    hash = HashValue(hash, gMapSelectArrowDirection);
+    for (const auto& tile : gMapSelectionTiles)
+    {
+        hash = HashValue(hash, tile);
+    }
+    hash = HashValue(hash, gClipHeight);
+    hash = HashValue(hash, gClipSelectionA);
+    hash = HashValue(hash, gClipSelectionB);
+    hash = HashValue(hash, gPaintBlockedTiles);
+    hash = HashValue(hash, gPaintWidePathsAsGhost);
+    hash = HashValue(hash, gScreenFlags);
+    hash = HashValue(hash, gTrackDesignSaveMode);
+    hash = HashValue(hash, gTrackDesignSaveRideIndex.ToUnderlying());
+
+    const auto& config = Config::Get().general;
+    hash = HashValue(hash, config.LandscapeSmoothing);
+    hash = HashValue(hash, config.TransparentWater);
+    hash = HashValue(hash, config.UpperCaseBanners);
+    hash = HashValue(hash, config.VirtualFloorStyle);
+    hash = HashValue(hash, GetHeightMarkerOffset());
+
+    const auto& gameState = GetGameState();
+    hash = HashValue(hash, gameState.Cheats.SandboxMode);
+    for (const auto& spawn : gameState.PeepSpawns)
+    {
+        hash = HashValue(hash, spawn.ToTileStart());
+        hash = HashValue(hash, spawn.z);
+        hash = HashValue(hash, spawn.direction);
+    }
+
+    auto patrolAreaToRender = GetPatrolAreaToRender();
+    if (const auto* staffType = std::get_if<StaffType>(&patrolAreaToRender))
+    {
+        hash = HashValue(hash, *staffType);
+    }
+    else
+    {
+        hash = HashValue(hash, std::get<EntityId>(patrolAreaToRender).ToUnderlying() + 0x10000u);
+    }
+
+    hash = HashValue(hash, session.SelectedElement);
+    return hash;
+}
+
+/**
+ * Painters fall back to different primitives depending on whether there is a paint struct to attach to, so
+ * entries are only valid if the same references were set when starting to paint the tile.
+ */
+static uint8_t GetIncomingReferences(const PaintSession& session)
+{
+    return (session.LastPS != nullptr ? 1 : 0) | (session.LastAttachedPS != nullptr ? 2 : 0)
+        | (session.WoodenSupportsPrependTo != nullptr ? 4 : 0);
+}
+
+static size_t GetTileVersionIndex(const CoordsXY& mapPos)
+{
+    const auto tilePos = TileCoordsXY(mapPos);
+    return ((static_cast<uint32_t>(tilePos.x) & 0xFF) << 8) | (static_cast<uint32_t>(tilePos.y) & 0xFF);
+}
+
+static TileCacheShard& GetShard(const TileCacheKey& key)
+{
+    return _tileCacheShards[TileCacheKeyHash{}(key) % kTileCacheShardCount];
+}
+
+template<typename T> static int32_t FindRecorded(const std::vector<const T*>& recorded, const T* ps)
+{
+    // Most references are to the paint struct created last.
+    for (size_t i = recorded.size(); i > 0; i--)
+    {
+        if (recorded[i - 1] == ps)
+        {
+            return static_cast<int32_t>(i - 1);
+        }
+    }
+    return kNoPaintStruct;
+}
+
+template<typename T> static bool EncodeReference(const std::vector<const T*>& recorded, const T* ps, int32_t& index)
+{
+    if (ps == nullptr)
+    {
+        index = kNoPaintStruct;
+        return true;
+    }
+    index = FindRecorded(recorded, ps);
+    return index != kNoPaintStruct;
+}
+
+template<typename T>
+static bool EncodeStateReference(const std::vector<const T*>& recorded, const T* ps, const T* initial, int32_t& index)
+{
+    if (ps != nullptr && ps == initial && FindRecorded(recorded, ps) == kNoPaintStruct)
+    {
+        index = kUnchangedPaintStruct;
+        return true;
+    }
+    return EncodeReference(recorded, ps, index);
+}
+
+template<typename T> static T* DecodeStateReference(const std::vector<T*>& replayed, int32_t index, T* current)
+{
+    if (index == kUnchangedPaintStruct)
+    {
+        return current;
+    }
+    return index == kNoPaintStruct ? nullptr : replayed[index];
+}
+
+static bool IsEntryCurrent(const TileCacheEntry& entry, const PaintTileRecording& recording, const PaintSession& session)
+{
+    return entry.Environment == session.TileCacheEnvironment && entry.Epoch == recording.Epoch
+        && entry.TileVersion == recording.TileVersion && entry.FirstElement == recording.FirstElement;
+}
+
+static bool IsEntryValid(const TileCacheEntry& entry, const PaintTileRecording& recording, const PaintSession& session)
+{
+    if (!IsEntryCurrent(entry, recording, session) || entry.IncomingReferences != recording.IncomingReferences)
+    {
+        return false;
+    }
+
+    // The output only stays the same if every image is culled the same way as when it was recorded.
+    return std::all_of(entry.Images.begin(), entry.Images.end(), [&session](const CachedImage& image) {
+        return PaintIsImageWithinDPI(image.Left, image.Top, image.Right, image.Bottom, session.DPI) == image.Visible;
+    });
+}
+
+static bool ReplayEntry(PaintSession& session, const TileCacheEntry& entry)
+{
+    _replayStructs.clear();
+    _replayAttached.clear();
+    for (size_t i = 0; i < entry.Structs.size(); i++)
+    {
+        auto* paintEntry = session.PaintEntryChain.Allocate();
+        if (paintEntry == nullptr)
+        {
+            return false;
+        }
+        _replayStructs.push_back(paintEntry->AsBasic());
+    }
+    for (size_t i = 0; i < entry.Attached.size(); i++)
+    {
+        auto* paintEntry = session.PaintEntryChain.Allocate();
+        if (paintEntry == nullptr)
+        {
+            return false;
+        }
+        _replayAttached.push_back(paintEntry->AsAttached());
+    }
+
+    for (size_t i = 0; i < entry.Structs.size(); i++)
+    {
+        const auto& cached = entry.Structs[i];
+        auto* ps = _replayStructs[i];
+        *ps = cached.Data;
+        ps->Children = cached.Children == kNoPaintStruct ? nullptr : _replayStructs[cached.Children];
+        ps->Attached = cached.Attached == kNoPaintStruct ? nullptr : _replayAttached[cached.Attached];
+        // Matches the normal paint path which assigns whatever entity was painted last.
+        ps->Entity = session.CurrentlyDrawnEntity;
+    }
+    for (size_t i = 0; i < entry.Attached.size(); i++)
+    {
+        const auto& cached = entry.Attached[i];
+        auto* ps = _replayAttached[i];
+        *ps = cached.Data;
+        ps->NextEntry = cached.Next == kNoPaintStruct ? nullptr : _replayAttached[cached.Next];
+    }
+    for (auto index : entry.Quadrants)
+    {
+        PaintSessionAddPSToQuadrant(session, _replayStructs[index]);
+    }
+
+    const auto& state = entry.State;
+    session.Surface = state.Surface;
+    session.CurrentlyDrawnTileElement = state.CurrentlyDrawnTileElement;
+    session.PathElementOnSameHeight = state.PathElementOnSameHeight;
+    session.TrackElementOnSameHeight = state.TrackElementOnSameHeight;
+    session.SpritePosition = state.SpritePosition;
+    session.MapPosition = state.MapPosition;
+    session.TrackColours = state.TrackColours;
+    session.SupportColours = state.SupportColours;
+    std::copy(std::begin(state.SupportSegments), std::end(state.SupportSegments), session.SupportSegments);
+    session.Support = state.Support;
+    session.WaterHeight = state.WaterHeight;
+    std::copy(std::begin(state.LeftTunnels), std::end(state.LeftTunnels), session.LeftTunnels);
+    std::copy(std::begin(state.RightTunnels), std::end(state.RightTunnels), session.RightTunnels);
+    session.LeftTunnelCount = state.LeftTunnelCount;
+    session.RightTunnelCount = state.RightTunnelCount;
+    session.VerticalTunnelHeight = state.VerticalTunnelHeight;
+    session.Flags = state.Flags;
+    session.InteractionType = state.InteractionType;
+    session.LastPS = DecodeStateReference(_replayStructs, state.LastPS, session.LastPS);
+    session.LastAttachedPS = DecodeStateReference(_replayAttached, state.LastAttachedPS, session.LastAttachedPS);
+    session.WoodenSupportsPrependTo = DecodeStateReference(
+        _replayStructs, state.WoodenSupportsPrependTo, session.WoodenSupportsPrependTo);
+    return true;
+}
+
+static bool CreateEntry(const PaintSession& session, const PaintTileRecording& recording, TileCacheEntry& entry)
+{
+    entry.Environment = session.TileCacheEnvironment;
+    entry.Epoch = recording.Epoch;
+    entry.TileVersion = recording.TileVersion;
+    entry.FirstElement = recording.FirstElement;
+    entry.IncomingReferences = recording.IncomingReferences;
+    entry.Images = recording.Images;
+
+    entry.Structs.resize(recording.Structs.size());
+    for (size_t i = 0; i < recording.Structs.size(); i++)
+    {
+        const auto* ps = recording.Structs[i];
+        auto& cached = entry.Structs[i];
+        cached.Data = *ps;
+        cached.Data.NextQuadrantEntry = nullptr;
+        cached.Data.Entity = nullptr;
+        if (!EncodeReference(recording.Structs, ps->Children, cached.Children)
+            || !EncodeReference(recording.Attached, ps->Attached, cached.Attached))
+        {
+            return false;
+        }
+    }
+
+    entry.Attached.resize(recording.Attached.size());
+    for (size_t i = 0; i < recording.Attached.size(); i++)
+    {
+        const auto* ps = recording.Attached[i];
+        auto& cached = entry.Attached[i];
+        cached.Data = *ps;
+        if (!EncodeReference(recording.Attached, ps->NextEntry, cached.Next))
+        {
+            return false;
+        }
+    }
+
+    entry.Quadrants.resize(recording.Quadrants.size());
+    for (size_t i = 0; i < recording.Quadrants.size(); i++)
+    {
+        if (!EncodeReference(recording.Structs, recording.Quadrants[i], entry.Quadrants[i]))
+        {
+            return false;
+        }
+    }
+
+    auto& state = entry.State;
+    state.Surface = session.Surface;
+    state.CurrentlyDrawnTileElement = session.CurrentlyDrawnTileElement;
+    state.PathElementOnSameHeight = session.PathElementOnSameHeight;
+    state.TrackElementOnSameHeight = session.TrackElementOnSameHeight;
+    state.SpritePosition = session.SpritePosition;
+    state.MapPosition = session.MapPosition;
+    state.TrackColours = session.TrackColours;
+    state.SupportColours = session.SupportColours;
+    std::copy(std::begin(session.SupportSegments), std::end(session.SupportSegments), state.SupportSegments);
+    state.Support = session.Support;
+    state.WaterHeight = session.WaterHeight;
+    std::copy(std::begin(session.LeftTunnels), std::end(session.LeftTunnels), state.LeftTunnels);
+    std::copy(std::begin(session.RightTunnels), std::end(session.RightTunnels), state.RightTunnels);
+    state.LeftTunnelCount = session.LeftTunnelCount;
+    state.RightTunnelCount = session.RightTunnelCount;
+    state.VerticalTunnelHeight = session.VerticalTunnelHeight;
+    state.Flags = session.Flags;
+    state.InteractionType = session.InteractionType;
+    return EncodeStateReference(recording.Structs, session.LastPS, recording.InitialLastPS, state.LastPS)
+        && EncodeStateReference(
+               recording.Attached, session.LastAttachedPS, recording.InitialLastAttachedPS, state.LastAttachedPS)
+        && EncodeStateReference(
+               recording.Structs, session.WoodenSupportsPrependTo, recording.InitialWoodenSupportsPrependTo,
+               state.WoodenSupportsPrependTo);
+}
+
+static void OnTileChanges(const TileChanges::ChangeSet& changes)
+{
+    if (changes.AllTilesChanged)
+    {
+        PaintTileCacheInvalidateAll();
+        return;
+    }
+    for (const auto& change : changes.Changes)
+    {
+        PaintTileCacheInvalidateTile(change.Coords.ToCoordsXY());
+    }
+}
+
+void PaintTileCacheBeginSession(PaintSession& session)
+{
+    // Light effects are collected as a side effect of painting, those would be lost when replaying.
+    session.UseTileCache = !gOpenRCT2Headless && !LightFXIsAvailable();
+    if (session.UseTileCache)
+    {
+        // Sessions are started on the main thread, before anything is cached.
+        if (_tileChangesCookie == 0)
+        {
+            _tileChangesCookie = TileChanges::Subscribe(OnTileChanges);
+        }
+        session.TileCacheEnvironment = HashEnvironment(session);
+    }
+}
+
+bool PaintTileCacheBeginTile(PaintSession& session, const CoordsXY& mapPos, const TileElement* firstElement)
+{
+    if (!session.UseTileCache || (session.Flags & PaintSessionFlags::IsTrackPiecePreview))
+    {
+        return false;
+    }
+
+    auto& recording = _recording;
+    recording.Key = TileCacheKey{
+        mapPos,
+        session.ViewFlags,
+        static_cast<int8_t>(session.DPI.zoom_level),
+        session.CurrentRotation,
+        session.DPI.width == 1 && session.DPI.height == 1,
+    };
+    recording.Epoch = _tileCacheEpoch.load(std::memory_order_relaxed);
+    recording.TileVersion = _tileVersions[GetTileVersionIndex(mapPos)].load(std::memory_order_relaxed);
+    recording.FirstElement = firstElement;
+    recording.IncomingReferences = GetIncomingReferences(session);
+
+    auto& shard = GetShard(recording.Key);
+    {
+        std::lock_guard lock(shard.Mutex);
+        auto it = shard.Entries.find(recording.Key);
+        if (it != shard.Entries.end())
+        {
+            for (const auto& entry : it->second)
+            {
+                if (IsEntryValid(entry, recording, session) && ReplayEntry(session, entry))
+                {
+                    _tileCacheHits.Add();
+                    return true;
+                }
+            }
+        }
+    }
+    _tileCacheMisses.Add();
+
+    recording.Valid = true;
+    recording.Images.clear();
+    recording.Structs.clear();
+    recording.Attached.clear();
+    recording.Quadrants.clear();
+    recording.InitialLastPS = session.LastPS;
+    recording.InitialLastAttachedPS = session.LastAttachedPS;
+    recording.InitialWoodenSupportsPrependTo = session.WoodenSupportsPrependTo;
+    session.TileRecording = &recording;
+    return false;
+}
+
+void PaintTileCacheEndTile(PaintSession& session)
+{
+    auto* recording = session.TileRecording;
+    if (recording == nullptr)
+    {
+        return;
+    }
+    session.TileRecording = nullptr;
+
+    TileCacheEntry entry;
+    if (!recording->Valid || !CreateEntry(session, *recording, entry))
+    {
+        return;
+    }
+
+    auto& shard = GetShard(recording->Key);
+    std::lock_guard lock(shard.Mutex);
+    if (shard.Entries.size() >= kTileCacheMaxEntriesPerShard && shard.Entries.count(recording->Key) == 0)
+    {
+        shard.Entries.clear();
+    }
+
+    // Entries recorded before the tile changed can never be replayed again.
+    auto& variants = shard.Entries[recording->Key];
+    std::erase_if(variants, [&](const TileCacheEntry& variant) { return !IsEntryCurrent(variant, *recording, session); });
+    if (variants.size() >= kTileCacheMaxVariants)
+    {
+        variants.erase(variants.begin());
+    }
+    variants.push_back(std::move(entry));
+}
+
+void PaintTileCacheRecordImage(
+    PaintSession& session, const ScreenCoordsXY& imagePos, const G1Element& g1, const PaintStruct* ps)
+{
+    auto* recording = session.TileRecording;
+    if (recording == nullptr || !recording->Valid)
+    {
+        return;
+    }
+
+    const int32_t left = imagePos.x + g1.x_offset;
+    const int32_t top = imagePos.y + g1.y_offset;
+    recording->Images.push_back({ left, top, left + g1.width, top + g1.height, ps != nullptr });
+    if (ps != nullptr)
+    {
+        recording->Structs.push_back(ps);
+    }
+}
+
+void PaintTileCacheRecordAttached(PaintSession& session, const AttachedPaintStruct* ps)
+{
+    auto* recording = session.TileRecording;
+    if (recording != nullptr && recording->Valid)
+    {
+        recording->Attached.push_back(ps);
+    }
+}
+
+void PaintTileCacheRecordQuadrant(PaintSession& session, const PaintStruct* ps)
+{
+    auto* recording = session.TileRecording;
+    if (recording != nullptr && recording->Valid)
+    {
+        recording->Quadrants.push_back(ps);
+    }
+}
+
+void PaintTileCacheCheckParent(PaintSession& session, const void* parent)
+{
+    auto* recording = session.TileRecording;
+    if (recording == nullptr || !recording->Valid)
+    {
+        return;
+    }
+
+    // Modifying a paint struct of another tile or entity can not be replayed.
+    const bool isRecorded = FindRecorded(recording->Structs, static_cast<const PaintStruct*>(parent)) != kNoPaintStruct
+        || FindRecorded(recording->Attached, static_cast<const AttachedPaintStruct*>(parent)) != kNoPaintStruct;
+    if (!isRecorded)
+    {
+        recording->Valid = false;
+    }
+}
+
+void PaintTileCacheMarkVolatile(PaintSession& session)
+{
+    if (session.TileRecording != nullptr)
+    {
+        session.TileRecording->Valid = false;
+    }
+}
+
+void PaintTileCacheInvalidateTile(const CoordsXY& mapPos)
+{
+    // Tile elements also read the four direct neighbours of their tile (surface edges, chairlift ends).
+    _tileVersions[GetTileVersionIndex(mapPos)].fetch_add(1, std::memory_order_relaxed);
+    for (Direction direction = 0; direction < kNumOrthogonalDirections; direction++)
+    {
+        const auto neighbour = mapPos + CoordsDirectionDelta[direction];
+        _tileVersions[GetTileVersionIndex(neighbour)].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void PaintTileCacheInvalidateAll()
+{
+    _tileCacheEpoch.fetch_add(1, std::memory_order_relaxed);
+}
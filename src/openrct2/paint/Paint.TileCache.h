@@ -0,0 +1,53 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../world/Location.hpp"
+
+#include <cstdint>
+
+struct AttachedPaintStruct;
+struct G1Element;
+struct PaintSession;
+struct PaintStruct;
+struct PaintTileRecording;
+struct TileElement;
+
+/**
+ * Cache of the paint structs generated for the tile elements of a single tile, keyed on the tile, rotation,
+ * zoom and view flags. Entries are validated against per tile invalidation counters, which are bumped for a tile
+ * and its neighbours when the tile is invalidated or its elements change, and a global epoch. Entities are not
+ * cached and are painted every frame.
+ *
+ * Only sessions that opted in with PaintTileCacheBeginSession use the cache. While a tile is being painted its
+ * output is recorded through the hooks below, anything the recording cannot reproduce (animations, references to
+ * paint structs of other tiles) marks the tile as volatile so it is painted normally every frame.
+ *
+ * The single pixel sessions of viewport picking keep their own entries, a tile is replayed for the next query as
+ * long as none of its images moved in or out of the queried pixel.
+ */
+void PaintTileCacheBeginSession(PaintSession& session);
+
+/**
+ * Replays the cached output for the tile if it is still valid, otherwise starts recording it.
+ * Returns true if the tile has been painted from the cache.
+ */
+bool PaintTileCacheBeginTile(PaintSession& session, const CoordsXY& mapPos, const TileElement* firstElement);
+void PaintTileCacheEndTile(PaintSession& session);
+
+void PaintTileCacheRecordImage(
+    PaintSession& session, const ScreenCoordsXY& imagePos, const G1Element& g1, const PaintStruct* ps);
+void PaintTileCacheRecordAttached(PaintSession& session, const AttachedPaintStruct* ps);
+void PaintTileCacheRecordQuadrant(PaintSession& session, const PaintStruct* ps);
+void PaintTileCacheCheckParent(PaintSession& session, const void* parent);
+void PaintTileCacheMarkVolatile(PaintSession& session);
+
+void PaintTileCacheInvalidateTile(const CoordsXY& mapPos);
+void PaintTileCacheInvalidateAll();
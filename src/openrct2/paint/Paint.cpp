@@ -10,24 +10,31 @@
 #include "Paint.h"
 
 #include "../Context.h"
+#include "../Diagnostic.h"
 #include "../config/Config.h"
 #include "../core/Guard.hpp"
+#include "../core/JobPool.h"
 #include "../drawing/Drawing.h"
 #include "../interface/Viewport.h"
 #include "../localisation/Currency.h"
 #include "../localisation/Formatting.h"
 #include "../localisation/LocalisationService.h"
 #include "../paint/Painter.h"
+#include "../platform/Platform.h"
 #include "../profiling/Profiling.h"
 #include "../util/Math.hpp"
 #include "../util/Prefetch.h"
 #include "Boundbox.h"
 #include "Paint.Entity.h"
+#include "Paint.Sort.h"
+#include "Paint.TileCache.h"
 #include "tile_element/Paint.TileElement.h"
 
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <memory>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -56,6 +63,8 @@ bool gShowDirtyVisuals;
 bool gPaintBoundingBoxes;
 bool gPaintBlockedTiles;
 
+static Profiling::Counter _paintAllocations("Paint entry node allocations");
+
 static void PaintAttachedPS(DrawPixelInfo& dpi, PaintStruct* ps, uint32_t viewFlags);
 static void PaintPSImageWithBoundingBoxes(PaintSession& session, PaintStruct* ps, ImageId imageId, int32_t x, int32_t y);
 static ImageId PaintPSColourifyImage(const PaintStruct* ps, ImageId imageId, uint32_t viewFlags);
@@ -86,7 +95,7 @@ static int32_t RemapPositionToQuadrant(const PaintStruct& ps, uint8_t rotation)
     return 0;
 }
 
-static void PaintSessionAddPSToQuadrant(PaintSession& session, PaintStruct* ps)
+void PaintSessionAddPSToQuadrant(PaintSession& session, PaintStruct* ps)
 {
     const auto positionHash = RemapPositionToQuadrant(*ps, session.CurrentRotation);
 
@@ -99,16 +108,15 @@ static void PaintSessionAddPSToQuadrant(PaintSession& session, PaintStruct* ps)
 
     session.QuadrantBackIndex = std::min(session.QuadrantBackIndex, paintQuadrantIndex);
     session.QuadrantFrontIndex = std::max(session.QuadrantFrontIndex, paintQuadrantIndex);
+
+    if (session.TileRecording != nullptr)
+    {
+        PaintTileCacheRecordQuadrant(session, ps);
+    }
 }
 
-static constexpr bool ImageWithinDPI(const ScreenCoordsXY& imagePos, const G1Element& g1, const DrawPixelInfo& dpi)
+static constexpr bool ImageBoundsWithinDPI(int32_t left, int32_t bottom, int32_t right, int32_t top, const DrawPixelInfo& dpi)
 {
-    int32_t left = imagePos.x + g1.x_offset;
-    int32_t bottom = imagePos.y + g1.y_offset;
-
-    int32_t right = left + g1.width;
-    int32_t top = bottom + g1.height;
-
     // mber: It is possible to use only the bottom else block here if you change <= and >= to simply < and >.
     // However, since this is used to cull paint structs, I'd prefer to keep the condition strict and calculate
     // the culling differently for minifying and magnifying.
@@ -138,6 +146,23 @@ static constexpr bool ImageWithinDPI(const ScreenCoordsXY& imagePos, const G1Ele
     return true;
 }
 
+static constexpr bool ImageWithinDPI(const ScreenCoordsXY& imagePos, const G1Element& g1, const DrawPixelInfo& dpi)
+{
+    int32_t left = imagePos.x + g1.x_offset;
+    int32_t bottom = imagePos.y + g1.y_offset;
+
+    int32_t right = left + g1.width;
+    int32_t top = bottom + g1.height;
+
+    return ImageBoundsWithinDPI(left, bottom, right, top, dpi);
+}
+
+bool PaintIsImageWithinDPI(int32_t left, int32_t top, int32_t right, int32_t bottom, const DrawPixelInfo& dpi)
+{
+    // The culling code names the edges after image coordinates, the top of the screen is its bottom.
+    return ImageBoundsWithinDPI(left, top, right, bottom, dpi);
+}
+
 static constexpr CoordsXYZ RotateBoundBoxSize(const CoordsXYZ& bbSize, const uint8_t rotation)
 {
     auto output = bbSize;
@@ -184,6 +209,10 @@ static PaintStruct* CreateNormalPaintStruct(
 
     if (!ImageWithinDPI(imagePos, *g1, session.DPI))
     {
+        if (session.TileRecording != nullptr)
+        {
+            PaintTileCacheRecordImage(session, imagePos, *g1, nullptr);
+        }
         return nullptr;
     }
 
@@ -193,6 +222,7 @@ static PaintStruct* CreateNormalPaintStruct(
     auto* ps = session.AllocateNormalPaintEntry();
     if (ps == nullptr)
     {
+        PaintTileCacheMarkVolatile(session);
         return nullptr;
     }
 
@@ -212,6 +242,11 @@ static PaintStruct* CreateNormalPaintStruct(
     ps->Element = session.CurrentlyDrawnTileElement;
     ps->Entity = session.CurrentlyDrawnEntity;
 
+    if (session.TileRecording != nullptr)
+    {
+        PaintTileCacheRecordImage(session, imagePos, *g1, ps);
+    }
+
     return ps;
 }
 
@@ -318,14 +353,6 @@ static bool CheckBoundingBox(const PaintStructBoundBox& initialBBox, const Paint
     return false;
 }
 
-namespace OpenRCT2::PaintSortFlags
-{
-    static constexpr uint8_t None = 0;
-    static constexpr uint8_t PendingVisit = (1u << 0);
-    static constexpr uint8_t Neighbour = (1u << 1);
-    static constexpr uint8_t OutsideQuadrant = (1u << 7);
-} // namespace OpenRCT2::PaintSortFlags
-
 static PaintStruct* PaintStructsFirstInQuadrant(PaintStruct* psNext, uint16_t quadrantIndex)
 {
     PaintStruct* ps;
@@ -519,21 +546,412 @@ template<int TRotation> static void PaintSessionArrangeImpl(PaintSessionCore& se
 
 using PaintArrangeWithRotation = void (*)(PaintSessionCore& session);
 
-constexpr std::array _paintArrangeFuncs = {
+constexpr std::array _paintArrangeReferenceFuncs = {
     PaintSessionArrangeImpl<0>,
     PaintSessionArrangeImpl<1>,
     PaintSessionArrangeImpl<2>,
     PaintSessionArrangeImpl<3>,
 };
 
+void PaintSessionArrangeReference(PaintSessionCore& session)
+{
+    PROFILED_FUNCTION();
+    return _paintArrangeReferenceFuncs[session.CurrentRotation](session);
+}
+
+template<uint8_t TRotation>
+static int32_t PaintSortFindScalarRotation(
+    const PaintSortBounds& bounds, int32_t begin, int32_t end, const PaintStructBoundBox& initialBBox)
+{
+    for (int32_t i = begin; i < end; i++)
+    {
+        const auto sortFlags = bounds.SortFlags[i];
+        if (sortFlags & PaintSortFlags::OutsideQuadrant)
+        {
+            break;
+        }
+        if (!(sortFlags & PaintSortFlags::Neighbour))
+        {
+            continue;
+        }
+
+        const PaintStructBoundBox currentBBox = {
+            bounds.X[i], bounds.Y[i], bounds.Z[i], bounds.XEnd[i], bounds.YEnd[i], bounds.ZEnd[i],
+        };
+        if (CheckBoundingBox<TRotation>(initialBBox, currentBBox))
+        {
+            return i;
+        }
+    }
+    return end;
+}
+
+int32_t PaintSortFindScalar(
+    const PaintSortBounds& bounds, int32_t begin, int32_t end, const PaintStructBoundBox& initialBBox, uint8_t rotation)
+{
+    switch (rotation)
+    {
+        case 0:
+            return PaintSortFindScalarRotation<0>(bounds, begin, end, initialBBox);
+        case 1:
+            return PaintSortFindScalarRotation<1>(bounds, begin, end, initialBBox);
+        case 2:
+            return PaintSortFindScalarRotation<2>(bounds, begin, end, initialBBox);
+        default:
+            return PaintSortFindScalarRotation<3>(bounds, begin, end, initialBBox);
+    }
+}
+
+static PaintSortFindFunc GetPaintSortFindFunction()
+{
+    if (Platform::AVX2Available())
+    {
+        LOG_VERBOSE("registering AVX2 paint sort function");
+        return PaintSortFindAvx2;
+    }
+    else if (Platform::SSE41Available())
+    {
+        LOG_VERBOSE("registering SSE4.1 paint sort function");
+        return PaintSortFindSse4_1;
+    }
+    else
+    {
+        LOG_VERBOSE("registering scalar paint sort function");
+        return PaintSortFindScalar;
+    }
+}
+
+static const auto PaintSortFind = GetPaintSortFindFunction();
+
+// A run of non-empty quadrants, nothing is moved across an empty quadrant so runs can be sorted independently.
+struct PaintSortBand
+{
+    uint32_t Begin;
+    uint32_t End;
+    uint32_t FirstQuadrant;
+    uint32_t LastQuadrant;
+};
+
+// The fields the sort needs, one array per field. The arrays are re-ordered instead of the paint structs.
+struct PaintSortScratch
+{
+    std::vector<int32_t> X;
+    std::vector<int32_t> Y;
+    std::vector<int32_t> Z;
+    std::vector<int32_t> XEnd;
+    std::vector<int32_t> YEnd;
+    std::vector<int32_t> ZEnd;
+    std::vector<uint8_t> SortFlags;
+    std::vector<uint16_t> QuadrantIndex;
+    std::vector<PaintStruct*> Structs;
+    std::vector<PaintSortBand> Bands;
+    std::vector<PaintSortBand> Batches;
+
+    void Clear()
+    {
+        X.clear();
+        Y.clear();
+        Z.clear();
+        XEnd.clear();
+        YEnd.clear();
+        ZEnd.clear();
+        SortFlags.clear();
+        QuadrantIndex.clear();
+        Structs.clear();
+        Bands.clear();
+        Batches.clear();
+    }
+
+    void PushBack(PaintStruct* ps)
+    {
+        X.push_back(ps->Bounds.x);
+        Y.push_back(ps->Bounds.y);
+        Z.push_back(ps->Bounds.z);
+        XEnd.push_back(ps->Bounds.x_end);
+        YEnd.push_back(ps->Bounds.y_end);
+        ZEnd.push_back(ps->Bounds.z_end);
+        SortFlags.push_back(ps->SortFlags);
+        QuadrantIndex.push_back(ps->QuadrantIndex);
+        Structs.push_back(ps);
+    }
+};
+
+// Arranging can nest on one thread: while waiting for the sort jobs of one column, a worker may pick up the job of
+// another column and arrange that. Every nesting level uses its own scratch so the outer one is left untouched.
+static thread_local std::vector<std::unique_ptr<PaintSortScratch>> _paintSortScratch;
+static thread_local size_t _paintSortDepth;
+
+class PaintSortScratchLease
+{
+public:
+    PaintSortScratchLease()
+    {
+        if (_paintSortDepth == _paintSortScratch.size())
+        {
+            _paintSortScratch.push_back(std::make_unique<PaintSortScratch>());
+        }
+        _scratch = _paintSortScratch[_paintSortDepth++].get();
+        _scratch->Clear();
+    }
+
+    PaintSortScratchLease(const PaintSortScratchLease&) = delete;
+    PaintSortScratchLease& operator=(const PaintSortScratchLease&) = delete;
+
+    ~PaintSortScratchLease()
+    {
+        _paintSortDepth--;
+    }
+
+    PaintSortScratch& Get()
+    {
+        return *_scratch;
+    }
+
+private:
+    PaintSortScratch* _scratch;
+};
+
+// Bands smaller than this are grouped together before they are handed to the job pool.
+static constexpr uint32_t kPaintSortBatchSize = 512;
+
+// The entries of a single band, position -1 stands in for the head node.
+struct PaintSortBandView
+{
+    int32_t* X;
+    int32_t* Y;
+    int32_t* Z;
+    int32_t* XEnd;
+    int32_t* YEnd;
+    int32_t* ZEnd;
+    uint8_t* SortFlags;
+    uint16_t* QuadrantIndex;
+    PaintStruct** Structs;
+    int32_t Count;
+
+    PaintSortBandView(PaintSortScratch& scratch, const PaintSortBand& band)
+        : X(scratch.X.data() + band.Begin)
+        , Y(scratch.Y.data() + band.Begin)
+        , Z(scratch.Z.data() + band.Begin)
+        , XEnd(scratch.XEnd.data() + band.Begin)
+        , YEnd(scratch.YEnd.data() + band.Begin)
+        , ZEnd(scratch.ZEnd.data() + band.Begin)
+        , SortFlags(scratch.SortFlags.data() + band.Begin)
+        , QuadrantIndex(scratch.QuadrantIndex.data() + band.Begin)
+        , Structs(scratch.Structs.data() + band.Begin)
+        , Count(static_cast<int32_t>(band.End - band.Begin))
+    {
+    }
+
+    PaintSortBounds Bounds() const
+    {
+        return { X, Y, Z, XEnd, YEnd, ZEnd, SortFlags };
+    }
+
+    // Moves the entry at source to destination and everything in between one position down.
+    void MoveUp(int32_t destination, int32_t source)
+    {
+        const auto rotate = [destination, source](auto* values) {
+            const auto value = values[source];
+            std::move_backward(values + destination, values + source, values + source + 1);
+            values[destination] = value;
+        };
+        rotate(X);
+        rotate(Y);
+        rotate(Z);
+        rotate(XEnd);
+        rotate(YEnd);
+        rotate(ZEnd);
+        rotate(SortFlags);
+        rotate(QuadrantIndex);
+        rotate(Structs);
+    }
+};
+
+// Array version of PaintStructsSortQuadrant.
+static void PaintSortBandQuadrant(PaintSortBandView& band, int32_t parent, int32_t child, uint8_t rotation)
+{
+    band.SortFlags[child] &= ~PaintSortFlags::PendingVisit;
+
+    const PaintStructBoundBox initialBBox = {
+        band.X[child], band.Y[child], band.Z[child], band.XEnd[child], band.YEnd[child], band.ZEnd[child],
+    };
+    const auto bounds = band.Bounds();
+    for (int32_t i = child + 1; i < band.Count; i++)
+    {
+        // Entries after the match keep their position so the search continues right after it.
+        i = PaintSortFind(bounds, i, band.Count, initialBBox, rotation);
+        if (i == band.Count)
+        {
+            break;
+        }
+        band.MoveUp(parent + 1, i);
+    }
+}
+
+// Runs the same passes as PaintArrangeStructsHelperRotation over a band.
+static void PaintSortBandPasses(PaintSortBandView& band, const PaintSortBand& range, uint32_t backQuadrant, uint8_t rotation)
+{
+    int32_t start = -1;
+    for (uint32_t quadrantIndex = range.FirstQuadrant; quadrantIndex <= range.LastQuadrant; quadrantIndex++)
+    {
+        while (start + 1 < band.Count && band.QuadrantIndex[start + 1] < quadrantIndex)
+        {
+            start++;
+        }
+
+        const uint8_t flag = quadrantIndex == backQuadrant ? PaintSortFlags::Neighbour : PaintSortFlags::None;
+        for (int32_t i = start + 1; i < band.Count; i++)
+        {
+            if (band.QuadrantIndex[i] > quadrantIndex + 1)
+            {
+                band.SortFlags[i] = PaintSortFlags::OutsideQuadrant;
+                break;
+            }
+            if (band.QuadrantIndex[i] == quadrantIndex + 1)
+            {
+                band.SortFlags[i] = PaintSortFlags::Neighbour | PaintSortFlags::PendingVisit;
+            }
+            else if (band.QuadrantIndex[i] == quadrantIndex)
+            {
+                band.SortFlags[i] = flag | PaintSortFlags::PendingVisit;
+            }
+        }
+
+        int32_t parent = start;
+        for (;;)
+        {
+            int32_t child = -1;
+            for (int32_t i = parent + 1; i < band.Count; i++)
+            {
+                const auto sortFlags = band.SortFlags[i];
+                if (sortFlags & PaintSortFlags::OutsideQuadrant)
+                {
+                    break;
+                }
+                if (sortFlags & PaintSortFlags::PendingVisit)
+                {
+                    child = i;
+                    break;
+                }
+            }
+            if (child == -1)
+            {
+                break;
+            }
+
+            parent = child - 1;
+            PaintSortBandQuadrant(band, parent, child, rotation);
+        }
+    }
+}
+
+static void PaintSortBatch(PaintSortScratch& scratch, const PaintSortBand& batch, uint32_t backQuadrant, uint8_t rotation)
+{
+    for (uint32_t bandIndex = batch.Begin; bandIndex < batch.End; bandIndex++)
+    {
+        const auto& range = scratch.Bands[bandIndex];
+        PaintSortBandView band(scratch, range);
+        PaintSortBandPasses(band, range, backQuadrant, rotation);
+    }
+}
+
 /**
  *
  *  rct2: 0x00688217
+ *
+ * Produces the same order as PaintSessionArrangeReference. The bounding boxes are copied into one array per
+ * component and split into bands at empty quadrants, a sort pass only looks at its own and the next quadrant
+ * so entries never move across an empty quadrant and the bands can be sorted in parallel.
  */
-void PaintSessionArrange(PaintSessionCore& session)
+void PaintSessionArrange(PaintSessionCore& session, JobPool* jobs)
 {
     PROFILED_FUNCTION();
-    return _paintArrangeFuncs[session.CurrentRotation](session);
+
+    const uint32_t backQuadrant = session.QuadrantBackIndex;
+    const uint32_t frontQuadrant = session.QuadrantFrontIndex;
+    const uint8_t rotation = session.CurrentRotation;
+    if (backQuadrant == UINT32_MAX)
+    {
+        return;
+    }
+
+    // The reference implementation always visits the back quadrant, even if it is also the front.
+    const uint32_t lastPass = frontQuadrant > backQuadrant ? frontQuadrant - 1 : backQuadrant;
+
+    PaintSortScratchLease lease;
+    auto& scratch = lease.Get();
+
+    for (uint32_t quadrantIndex = backQuadrant; quadrantIndex <= frontQuadrant; quadrantIndex++)
+    {
+        PaintStruct* ps = session.Quadrants[quadrantIndex];
+        if (ps == nullptr)
+        {
+            continue;
+        }
+
+        const auto begin = static_cast<uint32_t>(scratch.Structs.size());
+        for (; ps != nullptr; ps = ps->NextQuadrantEntry)
+        {
+            scratch.PushBack(ps);
+        }
+        const auto end = static_cast<uint32_t>(scratch.Structs.size());
+
+        if (!scratch.Bands.empty() && scratch.Bands.back().LastQuadrant + 1 == quadrantIndex)
+        {
+            scratch.Bands.back().End = end;
+            scratch.Bands.back().LastQuadrant = quadrantIndex;
+        }
+        else
+        {
+            scratch.Bands.push_back({ begin, end, quadrantIndex, quadrantIndex });
+        }
+    }
+
+    // Turn the quadrant ranges into the passes that have to run, a band after an empty quadrant also needs the
+    // pass of that empty quadrant as it flags the first quadrant of the band as neighbour.
+    for (auto& band : scratch.Bands)
+    {
+        if (band.FirstQuadrant != backQuadrant)
+        {
+            band.FirstQuadrant--;
+        }
+        band.LastQuadrant = std::min(band.LastQuadrant, lastPass);
+    }
+
+    for (uint32_t bandIndex = 0; bandIndex < scratch.Bands.size(); bandIndex++)
+    {
+        const auto& band = scratch.Bands[bandIndex];
+        if (scratch.Batches.empty() || scratch.Bands[scratch.Batches.back().Begin].Begin + kPaintSortBatchSize <= band.Begin)
+        {
+            scratch.Batches.push_back({ bandIndex, bandIndex + 1, 0, 0 });
+        }
+        else
+        {
+            scratch.Batches.back().End = bandIndex + 1;
+        }
+    }
+
+    if (jobs != nullptr && scratch.Batches.size() > 1)
+    {
+        jobs->ParallelFor(0, scratch.Batches.size(), 1, [&scratch, backQuadrant, rotation](size_t batchIndex) {
+            PaintSortBatch(scratch, scratch.Batches[batchIndex], backQuadrant, rotation);
+        });
+    }
+    else
+    {
+        for (const auto& batch : scratch.Batches)
+        {
+            PaintSortBatch(scratch, batch, backQuadrant, rotation);
+        }
+    }
+
+    session.PaintHead = scratch.Structs.front();
+    for (size_t i = 0; i < scratch.Structs.size(); i++)
+    {
+        PaintStruct* ps = scratch.Structs[i];
+        ps->SortFlags = scratch.SortFlags[i];
+        ps->NextQuadrantEntry = i + 1 < scratch.Structs.size() ? scratch.Structs[i + 1] : nullptr;
+    }
 }
 
 static void PaintDrawStruct(PaintSession& session, PaintStruct* ps)
@@ -813,6 +1231,10 @@ PaintStruct* PaintAddImageAsChild(
         return nullptr;
     }
 
+    if (session.TileRecording != nullptr)
+    {
+        PaintTileCacheCheckParent(session, parentPS);
+    }
     parentPS->Children = ps;
 
     return ps;
@@ -837,6 +1259,7 @@ bool PaintAttachToPreviousAttach(PaintSession& session, const ImageId imageId, i
     auto* ps = session.AllocateAttachedPaintEntry();
     if (ps == nullptr)
     {
+        PaintTileCacheMarkVolatile(session);
         return false;
     }
 
@@ -845,6 +1268,11 @@ bool PaintAttachToPreviousAttach(PaintSession& session, const ImageId imageId, i
     ps->IsMasked = false;
     ps->NextEntry = nullptr;
 
+    if (session.TileRecording != nullptr)
+    {
+        PaintTileCacheCheckParent(session, previousAttachedPS);
+        PaintTileCacheRecordAttached(session, ps);
+    }
     previousAttachedPS->NextEntry = ps;
 
     return true;
@@ -869,6 +1297,7 @@ bool PaintAttachToPreviousPS(PaintSession& session, const ImageId image_id, int3
     auto* ps = session.AllocateAttachedPaintEntry();
     if (ps == nullptr)
     {
+        PaintTileCacheMarkVolatile(session);
         return false;
     }
 
@@ -876,6 +1305,11 @@ bool PaintAttachToPreviousPS(PaintSession& session, const ImageId image_id, int3
     ps->RelativePos = { x, y };
     ps->IsMasked = false;
 
+    if (session.TileRecording != nullptr)
+    {
+        PaintTileCacheCheckParent(session, masterPs);
+        PaintTileCacheRecordAttached(session, ps);
+    }
     AttachedPaintStruct* oldFirstAttached = masterPs->Attached;
     masterPs->Attached = ps;
     ps->NextEntry = oldFirstAttached;
@@ -991,12 +1425,15 @@ PaintEntry* PaintEntryPool::Chain::Allocate()
     }
     else if (Current->Count >= NodeSize)
     {
-        // We need another node
-        Current->Next = Pool->AllocateNode();
+        // We need another node, nodes kept from a previous frame are used first.
         if (Current->Next == nullptr)
         {
-            // Unable to allocate any more nodes
-            return nullptr;
+            Current->Next = Pool->AllocateNode();
+            if (Current->Next == nullptr)
+            {
+                // Unable to allocate any more nodes
+                return nullptr;
+            }
         }
         Current = Current->Next;
     }
@@ -1017,6 +1454,17 @@ void PaintEntryPool::Chain::Clear()
     assert(Current == nullptr);
 }
 
+// Marks all entries as unused but keeps the nodes so the chain can be filled again without
+// going through the pool.
+void PaintEntryPool::Chain::Rewind()
+{
+    for (auto* node = Head; node != nullptr && node->Count != 0; node = node->Next)
+    {
+        node->Count = 0;
+    }
+    Current = Head;
+}
+
 size_t PaintEntryPool::Chain::GetCount() const
 {
     size_t count = 0;
@@ -1051,6 +1499,7 @@ PaintEntryPool::Node* PaintEntryPool::AllocateNode()
     else
     {
         result = new (std::nothrow) PaintEntryPool::Node();
+        _paintAllocations.Add();
     }
     return result;
 }
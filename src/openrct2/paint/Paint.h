@@ -19,7 +19,9 @@
 #include <mutex>
 #include <thread>
 
+class JobPool;
 struct EntityBase;
+struct PaintTileRecording;
 struct TileElement;
 struct SurfaceElement;
 enum class RailingEntrySupportType : uint8_t;
@@ -155,6 +157,7 @@ public:
 
         PaintEntry* Allocate();
         void Clear();
+        void Rewind();
         size_t GetCount() const;
     };
 
@@ -211,6 +214,11 @@ struct PaintSession : public PaintSessionCore
     DrawPixelInfo DPI;
     PaintEntryPool::Chain PaintEntryChain;
 
+    // Per tile paint cache, see Paint.TileCache.h.
+    PaintTileRecording* TileRecording{};
+    uint64_t TileCacheEnvironment{};
+    bool UseTileCache{};
+
     PaintStruct* AllocateNormalPaintEntry() noexcept
     {
         auto* entry = PaintEntryChain.Allocate();
@@ -330,9 +338,17 @@ void PaintFloatingMoneyEffect(
     PaintSession& session, money64 amount, StringId string_id, int32_t y, int32_t z, int8_t y_offsets[], int32_t offset_x,
     uint32_t rotation);
 
+void PaintSessionAddPSToQuadrant(PaintSession& session, PaintStruct* ps);
+bool PaintIsImageWithinDPI(int32_t left, int32_t top, int32_t right, int32_t bottom, const DrawPixelInfo& dpi);
+
 PaintSession* PaintSessionAlloc(DrawPixelInfo& dpi, uint32_t viewFlags, uint8_t rotation);
 void PaintSessionFree(PaintSession* session);
 void PaintSessionGenerate(PaintSession& session);
-void PaintSessionArrange(PaintSessionCore& session);
+void PaintSessionArrange(PaintSessionCore& session, JobPool* jobs = nullptr);
+
+/**
+ * The original linked list sort, PaintSessionArrange must produce the same draw order.
+ */
+void PaintSessionArrangeReference(PaintSessionCore& session);
 void PaintDrawStructs(PaintSession& session);
 void PaintDrawMoneyStructs(DrawPixelInfo& dpi, PaintStringStruct* ps);
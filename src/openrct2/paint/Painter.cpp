@@ -35,6 +35,8 @@ using namespace OpenRCT2::Drawing;
 using namespace OpenRCT2::Paint;
 using namespace OpenRCT2::Ui;
 
+static Profiling::Counter _sessionAllocations("Paint session allocations");
+
 Painter::Painter(const std::shared_ptr<IUiContext>& uiContext)
     : _uiContext(uiContext)
 {
@@ -157,7 +159,7 @@ PaintSession* Painter::CreateSession(DrawPixelInfo& dpi, uint32_t viewFlags, uin
 
     if (_freePaintSessions.empty() == false)
     {
-        // Re-use.
+        // Re-use, the quadrants and paint entries have been reset on release.
         session = _freePaintSessions.back();
 
         // Shrink by one.
@@ -167,18 +169,21 @@ PaintSession* Painter::CreateSession(DrawPixelInfo& dpi, uint32_t viewFlags, uin
     {
         // Create new one in pool.
         _paintSessionPool.emplace_back(std::make_unique<PaintSession>());
+        _freePaintSessions.reserve(_paintSessionPool.size());
+        _sessionAllocations.Add();
+
         session = _paintSessionPool.back().get();
+        session->PaintEntryChain = _paintStructPool.Create();
+        std::fill(std::begin(session->Quadrants), std::end(session->Quadrants), nullptr);
     }
 
     session->DPI = dpi;
     session->ViewFlags = viewFlags;
     session->QuadrantBackIndex = std::numeric_limits<uint32_t>::max();
     session->QuadrantFrontIndex = 0;
-    session->PaintEntryChain = _paintStructPool.Create();
     session->Flags = 0;
     session->CurrentRotation = rotation;
 
-    std::fill(std::begin(session->Quadrants), std::end(session->Quadrants), nullptr);
     session->PaintHead = nullptr;
     session->LastPS = nullptr;
     session->LastAttachedPS = nullptr;
@@ -189,6 +194,8 @@ PaintSession* Painter::CreateSession(DrawPixelInfo& dpi, uint32_t viewFlags, uin
     session->CurrentlyDrawnTileElement = nullptr;
     session->Surface = nullptr;
     session->SelectedElement = OpenRCT2::TileInspector::GetSelectedElement();
+    session->TileRecording = nullptr;
+    session->UseTileCache = false;
 
     return session;
 }
@@ -197,7 +204,17 @@ void Painter::ReleaseSession(PaintSession* session)
 {
     PROFILED_FUNCTION();
 
-    session->PaintEntryChain.Clear();
+    // Only the quadrants that were used need to be cleared, the paint entry nodes stay with
+    // the session so steady state rendering does not go through the shared pool.
+    if (session->QuadrantBackIndex <= session->QuadrantFrontIndex)
+    {
+        std::fill(
+            std::begin(session->Quadrants) + session->QuadrantBackIndex,
+            std::begin(session->Quadrants) + session->QuadrantFrontIndex + 1, nullptr);
+    }
+    session->QuadrantBackIndex = std::numeric_limits<uint32_t>::max();
+    session->QuadrantFrontIndex = 0;
+    session->PaintEntryChain.Rewind();
     _freePaintSessions.push_back(session);
 }
 
@@ -205,7 +222,7 @@ Painter::~Painter()
 {
     for (auto&& session : _paintSessionPool)
     {
-        ReleaseSession(session.get());
+        session->PaintEntryChain.Clear();
     }
     _paintSessionPool.clear();
 }
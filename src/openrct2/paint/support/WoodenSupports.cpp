@@ -17,6 +17,7 @@
 #include "../../world/tile_element/Slope.h"
 #include "../Boundbox.h"
 #include "../Paint.SessionFlags.h"
+#include "../Paint.TileCache.h"
 #include "../Paint.h"
 
 #include <cassert>
@@ -376,6 +377,10 @@ static void PaintSlopeTransitions(
         auto* paintStruct = PaintAddImageAsOrphan(session, imageId, { 0, 0, baseHeight }, boundBox);
         if (paintStruct != nullptr)
         {
+            if (session.TileRecording != nullptr)
+            {
+                PaintTileCacheCheckParent(session, session.WoodenSupportsPrependTo);
+            }
             session.WoodenSupportsPrependTo->Children = paintStruct;
         }
     }
@@ -30,6 +30,7 @@
 #include "../../world/Park.h"
 #include "../../world/TileInspector.h"
 #include "../../world/tile_element/EntranceElement.h"
+#include "../Paint.TileCache.h"
 #include "../support/WoodenSupports.h"
 #include "Paint.TileElement.h"
 #include "Segment.h"
@@ -362,6 +363,9 @@ void PaintEntrance(PaintSession& session, uint8_t direction, int32_t height, con
 {
     PROFILED_FUNCTION();
 
+    // Entrances show the state of their ride or park.
+    PaintTileCacheMarkVolatile(session);
+
     session.InteractionType = ViewportInteractionItem::Label;
 
     PaintHeightMarkers(session, entranceElement, height);
@@ -28,6 +28,7 @@
 #include "../../world/Surface.h"
 #include "../../world/tile_element/Slope.h"
 #include "../Paint.SessionFlags.h"
+#include "../Paint.TileCache.h"
 #include "../Paint.h"
 #include "../VirtualFloor.h"
 #include "Paint.Surface.h"
@@ -210,6 +211,13 @@ static void PaintTileElementBase(PaintSession& session, const CoordsXY& origCoor
     session.SpritePosition.y = coords.y;
     session.Flags &= ~PaintSessionFlags::PassedSurface;
 
+    // The virtual floor and support heights are painted after the elements and are not part of the cache.
+    if (!partOfVirtualFloor && !gShowSupportSegmentHeights
+        && PaintTileCacheBeginTile(session, session.MapPosition, tile_element))
+    {
+        return;
+    }
+
     int32_t previousBaseZ = 0;
     do
     {
@@ -285,6 +293,8 @@ static void PaintTileElementBase(PaintSession& session, const CoordsXY& origCoor
         session.MapPosition = mapPosition;
     } while (!(tile_element++)->IsLastForTile());
 
+    PaintTileCacheEndTile(session);
+
     if (Config::Get().general.VirtualFloorStyle != VirtualFloorStyles::Off && partOfVirtualFloor)
     {
         VirtualFloorPaint(session);
@@ -16,6 +16,7 @@
 #include "../../../ride/Vehicle.h"
 #include "../../../scenario/Scenario.h"
 #include "../../../world/Map.h"
+#include "../../Paint.TileCache.h"
 #include "../../Paint.h"
 #include "../../support/WoodenSupports.h"
 #include "../../support/WoodenSupports.hpp"
@@ -527,6 +528,7 @@ static void PaintRiverRapidsTrackWaterfall(
 {
     ImageId imageId;
 
+    PaintTileCacheMarkVolatile(session);
     uint16_t frameNum = (GetGameState().CurrentTicks / 2) & 7;
 
     if (direction & 1)
@@ -598,6 +600,7 @@ static void PaintRiverRapidsTrackRapids(
 {
     ImageId imageId;
 
+    PaintTileCacheMarkVolatile(session);
     uint16_t frameNum = (GetGameState().CurrentTicks / 2) & 7;
 
     if (direction & 1)
@@ -650,6 +653,7 @@ static void PaintRiverRapidsTrackWhirlpool(
 {
     ImageId imageId;
 
+    PaintTileCacheMarkVolatile(session);
     uint8_t frameNum = (GetGameState().CurrentTicks / 4) % 16;
 
     if (direction & 1)
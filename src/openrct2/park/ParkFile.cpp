@@ -60,8 +60,10 @@
 #include "Legacy.h"
 
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <ctime>
+#include <future>
 #include <numeric>
 #include <optional>
 #include <string_view>
@@ -103,6 +105,7 @@ namespace OpenRCT2
         ObjectList RequiredObjects;
         std::vector<const ObjectRepositoryItem*> ExportObjectsList;
         bool OmitTracklessRides{};
+        uint32_t Compression = OrcaStream::COMPRESSION_GZIP_CHUNKS;
 
     private:
         std::unique_ptr<OrcaStream> _os;
@@ -147,6 +150,7 @@ namespace OpenRCT2
         void Import(GameState_t& gameState)
         {
             auto& os = *_os;
+            os.PrefetchChunks();
             ReadWriteTilesChunk(gameState, os);
             ReadWriteBannersChunk(gameState, os);
             ReadWriteRidesChunk(gameState, os);
@@ -178,6 +182,7 @@ namespace OpenRCT2
             header.Magic = PARK_FILE_MAGIC;
             header.TargetVersion = PARK_FILE_CURRENT_VERSION;
             header.MinVersion = PARK_FILE_MIN_VERSION;
+            header.Compression = Compression;
 
             ReadWriteAuthoringChunk(os);
             ReadWriteObjectsChunk(os);
@@ -1120,7 +1125,16 @@ namespace OpenRCT2
                         std::vector<TileElement> tileElements;
                         tileElements.resize(numElements);
                         cs.Read(tileElements.data(), tileElements.size() * sizeof(TileElement));
-                        SetTileElements(gameState, std::move(tileElements));
+                        if (os.GetHeader().TargetVersion < kMapSizedTilesVersion)
+                        {
+                            // Older versions stored the tiles of a map of the largest size regardless of the map size
+                            SetTileElements(
+                                gameState, std::move(tileElements), { kMaximumMapSizeTechnical, kMaximumMapSizeTechnical });
+                        }
+                        else
+                        {
+                            SetTileElements(gameState, std::move(tileElements));
+                        }
                         {
                             TileElementIterator it;
                             TileElementIteratorBegin(&it);
@@ -2645,6 +2659,72 @@ int32_t ScenarioSave(GameState_t& gameState, u8string_view path, int32_t flags)
     return result;
 }
 
+// The autosave being compressed and written, there is never more than one.
+static std::future<bool> _autosaveFuture;
+
+bool ScenarioAutosave(GameState_t& gameState, u8string_view path)
+{
+    LOG_VERBOSE("autosaving game");
+
+    ScenarioWaitForAutosave();
+    gIsAutosave = true;
+    PrepareMapForSave();
+
+    // Serialising reads the game state so it has to be done now, but without compression it is quick. The serialised
+    // chunks are then compressed exactly as a regular save would, so the file is the same as saving it directly.
+    MemoryStream snapshot;
+    try
+    {
+        auto parkFile = std::make_unique<OpenRCT2::ParkFile>();
+        parkFile->OmitTracklessRides = true;
+        parkFile->Compression = OrcaStream::COMPRESSION_NONE;
+        parkFile->Save(gameState, snapshot);
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR(e.what());
+        return false;
+    }
+
+    _autosaveFuture = std::async(std::launch::async, [snapshot = std::move(snapshot), path = u8string(path)]() mutable {
+        try
+        {
+            snapshot.SetPosition(0);
+            OrcaStream src(snapshot, OrcaStream::Mode::READING);
+            FileStream fs(path, FILE_MODE_WRITE);
+            OrcaStream dst(fs, OrcaStream::Mode::WRITING);
+            src.CopyChunksTo(dst);
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            LOG_ERROR("Unable to write autosave %s: %s", path.c_str(), e.what());
+            return false;
+        }
+    });
+    return true;
+}
+
+bool ScenarioIsAutosaveInProgress()
+{
+    if (!_autosaveFuture.valid())
+        return false;
+    if (_autosaveFuture.wait_for(std::chrono::seconds::zero()) != std::future_status::ready)
+        return true;
+
+    // Finished, report how it went.
+    ScenarioWaitForAutosave();
+    return false;
+}
+
+void ScenarioWaitForAutosave()
+{
+    if (_autosaveFuture.valid() && !_autosaveFuture.get())
+    {
+        Console::Error::WriteLine("Could not autosave the scenario. Is the save folder writeable?");
+    }
+}
+
 class ParkFileImporter final : public IParkImporter
 {
 private:
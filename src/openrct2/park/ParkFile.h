@@ -11,10 +11,10 @@ namespace OpenRCT2
     struct GameState_t;
 
     // Current version that is saved.
-    constexpr uint32_t PARK_FILE_CURRENT_VERSION = 40;
+    constexpr uint32_t PARK_FILE_CURRENT_VERSION = 42;
 
     // The minimum version that is forwards compatible with the current version.
-    constexpr uint32_t PARK_FILE_MIN_VERSION = 40;
+    constexpr uint32_t PARK_FILE_MIN_VERSION = 42;
 
     // The minimum version that is backwards compatible with the current version.
     // If this is increased beyond 0, uncomment the checks in ParkFile.cpp and Context.cpp!
@@ -31,6 +31,8 @@ namespace OpenRCT2
     constexpr uint16_t kWoodenFlatToSteepVersion = 37;
     constexpr uint16_t k16BitParkHistoryVersion = 38;
     constexpr uint16_t kPeepNamesObjectsVersion = 39;
+    constexpr uint16_t kMapSizedTilesVersion = 41;
+    constexpr uint16_t kChunkCompressionVersion = 42;
 } // namespace OpenRCT2
 
 class ParkFileExporter
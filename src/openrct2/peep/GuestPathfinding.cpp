@@ -12,6 +12,8 @@
 #include "../Diagnostic.h"
 #include "../GameState.h"
 #include "../core/Guard.hpp"
+#include "../core/JobPool.h"
+#include "../entity/EntityList.h"
 #include "../entity/Guest.h"
 #include "../entity/Staff.h"
 #include "../profiling/Profiling.h"
@@ -22,14 +24,21 @@
 #include "../util/Util.h"
 #include "../world/Entrance.h"
 #include "../world/Footpath.h"
+#include "../world/TileChanges.h"
 #include "../world/tile_element/BannerElement.h"
 #include "../world/tile_element/EntranceElement.h"
 #include "../world/tile_element/TrackElement.h"
 
+#include <algorithm>
+#include <array>
 #include <bit>
 #include <bitset>
 #include <cassert>
 #include <cstring>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace OpenRCT2::PathFinding
 {
@@ -44,6 +53,8 @@ namespace OpenRCT2::PathFinding
     static constexpr uint8_t kMaxJunctions = std::max({ kMaxJunctionsStaff, kMaxJunctionsGuest, kMaxJunctionsGuestWithMap,
                                                         kMaxJunctionsGuestLeavingPark, kMaxJunctionsGuestLeavingParkLost });
 
+    struct PreparedDirection;
+
     struct PathFindingState
     {
         int8_t junctionCount;
@@ -58,6 +69,8 @@ namespace OpenRCT2::PathFinding
             TileCoordsXYZ location;
             Direction direction;
         } history[kMaxJunctions + 1];
+        // Set while preparing a direction on the job pool, the search then hands its result over instead of caching it.
+        PreparedDirection* prepared;
     };
 
     static int32_t GuestSurfacePathFinding(Peep& peep);
@@ -629,6 +642,344 @@ namespace OpenRCT2::PathFinding
         return isThinJunction;
     }
 
+#pragma region Footpath graph
+    /*
+     * Between junctions the heuristic search walks runs of thin path tiles one at a time, each time with only one edge to
+     * continue on. These runs are the edges of the footpath graph, they are cached so the search can step over them
+     * without reading tile elements. Tiles on which the search can end or behaves differently per peep (queues, banners,
+     * wide paths, entrances and shops) are never part of an edge, the search walks those itself.
+     */
+    struct FootpathGraphTile
+    {
+        TileCoordsXY Location;
+        // Height the search enters the tile at, which is lower than the path when coming up a slope.
+        uint8_t EntryZ;
+        uint8_t BaseZ;
+        uint8_t ExitZ;
+        Direction ExitDirection;
+    };
+
+    struct FootpathGraphEdgeRef
+    {
+        uint32_t Edge;
+        uint32_t Offset;
+    };
+
+    // The search does not take more steps than this along a single path.
+    static constexpr size_t kMaxSearchSteps = 200;
+
+    static bool _footpathGraphEnabled = true;
+    static std::vector<std::vector<FootpathGraphTile>> _footpathGraphEdges;
+    // Edges by the tile, height and direction the search leaves from. Leaving any tile along an edge starts the rest of it.
+    static std::unordered_map<uint64_t, FootpathGraphEdgeRef> _footpathGraphIndex;
+
+    static uint64_t GetFootpathGraphKey(const TileCoordsXYZ& loc, Direction direction)
+    {
+        return (static_cast<uint64_t>(static_cast<uint16_t>(loc.x)) << 34)
+            | (static_cast<uint64_t>(static_cast<uint16_t>(loc.y)) << 18) | (static_cast<uint64_t>(loc.z & 0xFF) << 2)
+            | direction;
+    }
+
+    /**
+     * Returns the tile the heuristic search steps onto when leaving loc in the given direction, if it is a thin path
+     * the search can only leave in one direction. Mirrors the checks of PeepPathfindHeuristicSearch for guests.
+     */
+    static std::optional<FootpathGraphTile> GetFootpathGraphStep(const TileCoordsXYZ& from, Direction direction)
+    {
+        auto loc = from;
+        loc += TileDirectionDelta[direction];
+        const TileElement* tileElement = MapGetFirstElementAt(loc);
+        if (tileElement == nullptr)
+            return std::nullopt;
+
+        const PathElement* pathElement = nullptr;
+        do
+        {
+            if (tileElement->IsGhost())
+                continue;
+
+            switch (tileElement->GetType())
+            {
+                case TileElementType::Track:
+                {
+                    if (loc.z != tileElement->BaseHeight)
+                        continue;
+                    auto ride = GetRide(tileElement->AsTrack()->GetRideIndex());
+                    if (ride == nullptr || !ride->GetRideTypeDescriptor().HasFlag(RtdFlag::isShopOrFacility))
+                        continue;
+                    return std::nullopt;
+                }
+                case TileElementType::Entrance:
+                    if (loc.z != tileElement->BaseHeight)
+                        continue;
+                    switch (tileElement->AsEntrance()->GetEntranceType())
+                    {
+                        case ENTRANCE_TYPE_RIDE_ENTRANCE:
+                        case ENTRANCE_TYPE_RIDE_EXIT:
+                            if (tileElement->GetDirection() == direction)
+                                return std::nullopt;
+                            continue;
+                        case ENTRANCE_TYPE_PARK_ENTRANCE:
+                            return std::nullopt;
+                        default:
+                            continue;
+                    }
+                case TileElementType::Path:
+                    if (!FootpathIsZAndDirectionValid(*tileElement->AsPath(), loc.z, direction))
+                        continue;
+                    // The search checks the following elements at the height of this path.
+                    if (pathElement != nullptr)
+                        return std::nullopt;
+                    pathElement = tileElement->AsPath();
+                    loc.z = tileElement->BaseHeight;
+                    continue;
+                default:
+                    continue;
+            }
+        } while (!(tileElement++)->IsLastForTile());
+
+        if (pathElement == nullptr || pathElement->IsWide() || pathElement->IsQueue())
+            return std::nullopt;
+
+        const uint32_t edges = pathElement->GetEdges();
+        if (std::popcount(edges) != 2 || static_cast<uint32_t>(PathGetPermittedEdges(false, pathElement)) != edges)
+            return std::nullopt;
+
+        const uint32_t exits = edges & ~(1u << DirectionReverse(direction));
+        if (std::popcount(exits) != 1)
+            return std::nullopt;
+
+        const Direction exitDirection = UtilBitScanForward(exits);
+        uint8_t exitZ = pathElement->BaseHeight;
+        if (pathElement->IsSloped() && pathElement->GetSlopeDirection() == exitDirection)
+        {
+            exitZ += 2;
+        }
+        return FootpathGraphTile{
+            TileCoordsXY{ loc.x, loc.y }, static_cast<uint8_t>(from.z), pathElement->BaseHeight, exitZ, exitDirection,
+        };
+    }
+
+    // The search only reads paths, track, entrances and banners, so changes to other elements keep its answers.
+    static bool AffectsFootpathSearch(const TileChanges::ChangeSet& changes)
+    {
+        if (changes.AllTilesChanged)
+            return true;
+
+        for (const auto& change : changes.Changes)
+        {
+            switch (change.ElementType)
+            {
+                case TileElementType::Path:
+                case TileElementType::Track:
+                case TileElementType::Entrance:
+                case TileElementType::Banner:
+                    return true;
+                default:
+                    continue;
+            }
+        }
+        return false;
+    }
+
+    static uint32_t _tileChangesCookie;
+
+    // Called before anything is cached, as there is nothing to forget until then.
+    static void SubscribeToTileChanges()
+    {
+        if (_tileChangesCookie != 0)
+            return;
+
+        _tileChangesCookie = TileChanges::Subscribe([](const TileChanges::ChangeSet& changes) {
+            if (AffectsFootpathSearch(changes))
+            {
+                InvalidateFootpathGraph();
+            }
+        });
+    }
+
+    static FootpathGraphEdgeRef GetFootpathGraphEdge(const TileCoordsXYZ& loc, Direction direction)
+    {
+        const auto key = GetFootpathGraphKey(loc, direction);
+        auto it = _footpathGraphIndex.find(key);
+        if (it != _footpathGraphIndex.end())
+            return it->second;
+
+        std::vector<FootpathGraphTile> tiles;
+        auto from = loc;
+        auto fromDirection = direction;
+        while (tiles.size() < kMaxSearchSteps)
+        {
+            const auto step = GetFootpathGraphStep(from, fromDirection);
+            if (!step.has_value())
+                break;
+            tiles.push_back(*step);
+            from = { step->Location, step->ExitZ };
+            fromDirection = step->ExitDirection;
+        }
+
+        SubscribeToTileChanges();
+        const auto edge = static_cast<uint32_t>(_footpathGraphEdges.size());
+        _footpathGraphIndex.emplace(key, FootpathGraphEdgeRef{ edge, 0 });
+        for (size_t i = 0; i < tiles.size(); i++)
+        {
+            const auto& tile = tiles[i];
+            _footpathGraphIndex.emplace(
+                GetFootpathGraphKey({ tile.Location, tile.ExitZ }, tile.ExitDirection),
+                FootpathGraphEdgeRef{ edge, static_cast<uint32_t>(i + 1) });
+        }
+        _footpathGraphEdges.push_back(std::move(tiles));
+        return { edge, 0 };
+    }
+
+    static void InvalidateDirectionCache();
+
+    void InvalidateFootpathGraph()
+    {
+        InvalidateDirectionCache();
+        if (_footpathGraphEdges.empty())
+            return;
+
+        _footpathGraphEdges.clear();
+        _footpathGraphIndex.clear();
+    }
+
+    void SetFootpathGraphEnabled(bool enabled)
+    {
+        _footpathGraphEnabled = enabled;
+        InvalidateFootpathGraph();
+    }
+#pragma endregion
+
+#pragma region Direction cache
+    /*
+     * The edge the search chooses for a guest only depends on the map and on the state the search is given, so guests
+     * standing at the same junction heading for the same goal get the same answer. The answers are kept until the map
+     * changes.
+     */
+    struct DirectionCacheKey
+    {
+        TileCoordsXYZ Location;
+        TileCoordsXYZ Goal;
+        // The junctions the guest remembers, in the order they are kept in. The search uses the first one at a location,
+        // so the order matters when two of them share a location.
+        std::array<uint64_t, 4> History;
+        RideId QueueRideIndex;
+        uint8_t Edges;
+        int8_t MaxJunctions;
+        bool IgnoreForeignQueues;
+
+        bool operator==(const DirectionCacheKey& other) const = default;
+    };
+
+    struct DirectionCacheKeyHash
+    {
+        size_t operator()(const DirectionCacheKey& key) const
+        {
+            uint64_t hash = GetDirectionCacheCoordsKey(key.Location);
+            hash = hash * 31 + GetDirectionCacheCoordsKey(key.Goal);
+            for (auto entry : key.History)
+            {
+                hash = hash * 31 + entry;
+            }
+            hash = hash * 31 + key.QueueRideIndex.ToUnderlying();
+            hash = hash * 31 + key.Edges;
+            hash = hash * 31 + static_cast<uint8_t>(key.MaxJunctions);
+            hash = hash * 31 + key.IgnoreForeignQueues;
+            return std::hash<uint64_t>{}(hash);
+        }
+
+        static uint64_t GetDirectionCacheCoordsKey(const TileCoordsXYZ& loc)
+        {
+            return (static_cast<uint64_t>(static_cast<uint16_t>(loc.x)) << 32)
+                | (static_cast<uint64_t>(static_cast<uint16_t>(loc.y)) << 16) | static_cast<uint16_t>(loc.z);
+        }
+    };
+
+    // Cleared completely once full, it only needs to hold the goals guests are currently heading for.
+    static constexpr size_t kMaxDirectionCacheEntries = 1 << 16;
+
+    static bool _directionCacheEnabled = true;
+    static std::unordered_map<DirectionCacheKey, Direction, DirectionCacheKeyHash> _directionCache;
+    static uint64_t _directionCacheHits;
+    static uint64_t _directionCacheMisses;
+    static uint64_t _directionCachePrepared;
+
+    struct PreparedDirection
+    {
+        DirectionCacheKey Key;
+        Direction Chosen;
+        bool Searched;
+    };
+
+    // Searches run ahead of the guest update, only used while no tile element has changed since they ran.
+    static std::unordered_map<DirectionCacheKey, Direction, DirectionCacheKeyHash> _preparedDirections;
+    static uint32_t _preparedRecordCount;
+
+    static uint64_t GetDirectionCacheHistoryEntry(const TileCoordsXYZD& entry)
+    {
+        // The search only looks at remembered junctions it is standing on, so all forgotten ones are alike.
+        if (entry.IsNull())
+            return std::numeric_limits<uint64_t>::max();
+
+        return (DirectionCacheKeyHash::GetDirectionCacheCoordsKey(entry) << 8) | entry.direction;
+    }
+
+    static std::optional<Direction> FindPreparedDirection(const DirectionCacheKey& key)
+    {
+        if (_preparedDirections.empty())
+            return std::nullopt;
+
+        // Any change to the map since the searches ran could change what they find.
+        if (TileChanges::GetRecordCount() != _preparedRecordCount)
+        {
+            _preparedDirections.clear();
+            return std::nullopt;
+        }
+
+        auto it = _preparedDirections.find(key);
+        if (it == _preparedDirections.end())
+            return std::nullopt;
+
+        return it->second;
+    }
+
+    void ForgetPreparedDirections()
+    {
+        if (!_preparedDirections.empty())
+        {
+            _preparedDirections.clear();
+        }
+    }
+
+    static void InvalidateDirectionCache()
+    {
+        if (!_directionCache.empty())
+        {
+            _directionCache.clear();
+        }
+        ForgetPreparedDirections();
+    }
+
+    void SetDirectionCacheEnabled(bool enabled)
+    {
+        _directionCacheEnabled = enabled;
+        InvalidateDirectionCache();
+    }
+
+    DirectionCacheStats GetDirectionCacheStats()
+    {
+        return { _directionCacheHits, _directionCacheMisses, _directionCachePrepared, _directionCache.size() };
+    }
+
+    void ResetDirectionCacheStats()
+    {
+        _directionCacheHits = 0;
+        _directionCacheMisses = 0;
+        _directionCachePrepared = 0;
+    }
+#pragma endregion
+
     static int32_t CalculateHeuristicPathingScore(const TileCoordsXYZ& loc1, const TileCoordsXYZ& loc2)
     {
         auto xDelta = abs(loc1.x - loc2.x) * 32;
@@ -735,6 +1086,47 @@ namespace OpenRCT2::PathFinding
                 currentElementIsWide = false;
         }
 
+        // The footpath graph is built while searching, which can not happen on the job pool.
+        if (_footpathGraphEnabled && !peep.Is<Staff>() && state.prepared == nullptr)
+        {
+            // Step over the thin paths ahead, doing what the search below would do on each of them.
+            const auto ref = GetFootpathGraphEdge(loc, testEdge);
+            const auto& tiles = _footpathGraphEdges[ref.Edge];
+            for (size_t i = ref.Offset; i < tiles.size(); i++)
+            {
+                const auto& tile = tiles[i];
+                ++numSteps;
+                state.countTilesChecked--;
+
+                if (state.history[0].location == TileCoordsXYZ{ tile.Location, tile.EntryZ })
+                    return;
+
+                const TileCoordsXYZ tileLoc{ tile.Location, tile.BaseZ };
+                uint16_t newScore = CalculateHeuristicPathingScore(tileLoc, goal);
+                if (newScore == 0 || numSteps >= kMaxSearchSteps || state.countTilesChecked <= 0)
+                {
+                    if (newScore < *endScore || (newScore == *endScore && numSteps < *endSteps))
+                    {
+                        *endScore = newScore;
+                        *endSteps = numSteps;
+                        *endXYZ = tileLoc;
+                        *endJunctions = state.maxJunctions - state.junctionCount;
+                        for (uint8_t junctInd = 0; junctInd < *endJunctions; junctInd++)
+                        {
+                            uint8_t histIdx = state.maxJunctions - junctInd;
+                            junctionList[junctInd] = state.history[histIdx].location;
+                            directionList[junctInd] = state.history[histIdx].direction;
+                        }
+                    }
+                    return;
+                }
+
+                loc = { tile.Location, tile.ExitZ };
+                testEdge = tile.ExitDirection;
+                currentElementIsWide = false;
+            }
+        }
+
         loc += TileDirectionDelta[testEdge];
 
         ++numSteps;
@@ -1020,7 +1412,7 @@ namespace OpenRCT2::PathFinding
 
             /* Check if either of the search limits has been reached:
              * - max number of steps or max tiles checked. */
-            if (numSteps >= 200 || state.countTilesChecked <= 0)
+            if (numSteps >= kMaxSearchSteps || state.countTilesChecked <= 0)
             {
                 /* The current search ends here.
                  * The path continues, so the goal could still be reachable from here.
@@ -1222,6 +1614,219 @@ namespace OpenRCT2::PathFinding
         }
     }
 
+    /**
+     * Runs the heuristic search along each of the given edges and returns the edge that gets closest to the goal, or
+     * INVALID_DIRECTION if the search failed along all of them.
+     */
+    static Direction PeepPathfindChooseBestEdge(
+        PathFindingState& state, const TileCoordsXYZ& loc, const TileCoordsXYZ& goal, Peep& peep,
+        TileElement* firstTileElement, uint32_t edges, int32_t maxTilesChecked)
+    {
+        int32_t chosenEdge = UtilBitScanForward(edges);
+
+        uint8_t bestJunctions = 0;
+        TileCoordsXYZ bestJunctionList[16];
+        uint8_t bestDirectionList[16];
+        TileCoordsXYZ bestXYZ;
+
+        uint16_t bestScore = 0xFFFF;
+        uint8_t bestSub = 0xFF;
+
+        LogPathfinding(
+            &peep, "Pathfind start for goal %d,%d,%d from %d,%d,%d", goal.x, goal.y, goal.z, loc.x, loc.y, loc.z);
+
+        /* Call the search heuristic on each edge, keeping track of the
+         * edge that gives the best (i.e. smallest) value (best_score)
+         * or for different edges with equal value, the edge with the
+         * least steps (best_sub). */
+        int32_t numEdges = std::popcount(edges);
+        for (int32_t testEdge = chosenEdge; testEdge != -1; testEdge = UtilBitScanForward(edges))
+        {
+            edges &= ~(1 << testEdge);
+            uint8_t height = loc.z;
+
+            if (firstTileElement->AsPath()->IsSloped() && firstTileElement->AsPath()->GetSlopeDirection() == testEdge)
+            {
+                height += 0x2;
+            }
+
+            /* Divide the maxTilesChecked global search limit
+             * between the remaining edges to ensure the search
+             * covers all of the remaining edges. */
+            state.countTilesChecked = maxTilesChecked / numEdges;
+            state.junctionCount = state.maxJunctions;
+
+            // Initialise _peepPathFindHistory.
+
+            for (auto& entry : state.history)
+            {
+                entry.location.SetNull();
+                entry.direction = INVALID_DIRECTION;
+            }
+
+            /* The pathfinding will only use elements
+             * 1.._peepPathFindMaxJunctions, so the starting point
+             * is placed in element 0 */
+            state.history[0].location = loc;
+            state.history[0].direction = 0xF;
+
+            uint16_t score = 0xFFFF;
+            /* Variable endXYZ contains the end location of the
+             * search path. */
+            TileCoordsXYZ endXYZ;
+            endXYZ.x = 0;
+            endXYZ.y = 0;
+            endXYZ.z = 0;
+
+            uint8_t endSteps = 255;
+
+            /* Variable endJunctions is the number of junctions
+             * passed through in the search path.
+             * Variables endJunctionList and endDirectionList
+             * contain the junctions and corresponding directions
+             * of the search path.
+             * In the future these could be used to visualise the
+             * pathfinding on the map. */
+            uint8_t endJunctions = 0;
+            TileCoordsXYZ endJunctionList[16];
+            uint8_t endDirectionList[16] = { 0 };
+
+            bool inPatrolArea = false;
+            auto* staff = peep.As<Staff>();
+            if (staff != nullptr && staff->IsMechanic())
+            {
+                /* Mechanics are the only staff type that
+                 * pathfind to a destination. Determine if the
+                 * mechanic is in their patrol area. */
+                inPatrolArea = staff->IsLocationInPatrol(peep.NextLoc);
+            }
+
+            LogPathfinding(
+                &peep, "Pathfind searching in direction: %d from %d,%d,%d", testEdge, loc.x >> 5, loc.y >> 5, loc.z);
+
+            PeepPathfindHeuristicSearch(
+                state, { loc.x, loc.y, height }, goal, peep, firstTileElement, inPatrolArea, 0, &score, testEdge,
+                &endJunctions, endJunctionList, endDirectionList, &endXYZ, &endSteps);
+
+            if constexpr (kLogPathfinding)
+            {
+                LogPathfinding(
+                    &peep, "Pathfind test edge: %d score: %d steps: %d end: %d,%d,%d junctions: %d", testEdge, score,
+                    endSteps, endXYZ.x, endXYZ.y, endXYZ.z, endJunctions);
+                for (uint8_t listIdx = 0; listIdx < endJunctions; listIdx++)
+                {
+                    LogPathfinding(
+                        &peep, "Junction#%d %d,%d,%d Direction %d", listIdx + 1, endJunctionList[listIdx].x,
+                        endJunctionList[listIdx].y, endJunctionList[listIdx].z, endDirectionList[listIdx]);
+                }
+            }
+
+            if (score < bestScore || (score == bestScore && endSteps < bestSub))
+            {
+                chosenEdge = testEdge;
+                bestScore = score;
+                bestSub = endSteps;
+
+                if constexpr (kLogPathfinding)
+                {
+                    bestJunctions = endJunctions;
+                    for (uint8_t index = 0; index < endJunctions; index++)
+                    {
+                        bestJunctionList[index].x = endJunctionList[index].x;
+                        bestJunctionList[index].y = endJunctionList[index].y;
+                        bestJunctionList[index].z = endJunctionList[index].z;
+                        bestDirectionList[index] = endDirectionList[index];
+                    }
+                    bestXYZ.x = endXYZ.x;
+                    bestXYZ.y = endXYZ.y;
+                    bestXYZ.z = endXYZ.z;
+                }
+            }
+        }
+
+        /* Check if the heuristic search failed. e.g. all connected
+         * paths are within the search limits and none reaches the
+         * goal. */
+        if (bestScore == 0xFFFF)
+        {
+            LogPathfinding(&peep, "Pathfind heuristic search failed.");
+            return INVALID_DIRECTION;
+        }
+
+        if constexpr (kLogPathfinding)
+        {
+            LogPathfinding(&peep, "Pathfind best edge %d with score %d steps %d", chosenEdge, bestScore, bestSub);
+            for (uint8_t listIdx = 0; listIdx < bestJunctions; listIdx++)
+            {
+                LogPathfinding(
+                    &peep, "Junction#%d %d,%d,%d Direction %d", listIdx + 1, bestJunctionList[listIdx].x,
+                    bestJunctionList[listIdx].y, bestJunctionList[listIdx].z, bestDirectionList[listIdx]);
+            }
+            LogPathfinding(&peep, "End at %d,%d,%d", bestXYZ.x, bestXYZ.y, bestXYZ.z);
+        }
+
+        return static_cast<Direction>(chosenEdge);
+    }
+
+    static Direction PeepPathfindChooseEdgeCached(
+        PathFindingState& state, const TileCoordsXYZ& loc, const TileCoordsXYZ& goal, Peep& peep,
+        TileElement* firstTileElement, uint32_t edges, int32_t maxTilesChecked)
+    {
+        if (!_directionCacheEnabled || peep.Is<Staff>())
+            return PeepPathfindChooseBestEdge(state, loc, goal, peep, firstTileElement, edges, maxTilesChecked);
+
+        DirectionCacheKey key{};
+        key.Location = loc;
+        key.Goal = goal;
+        for (size_t i = 0; i < peep.PathfindHistory.size(); i++)
+        {
+            key.History[i] = GetDirectionCacheHistoryEntry(peep.PathfindHistory[i]);
+        }
+        key.QueueRideIndex = state.queueRideIndex;
+        key.Edges = static_cast<uint8_t>(edges);
+        key.MaxJunctions = state.maxJunctions;
+        key.IgnoreForeignQueues = state.ignoreForeignQueues;
+
+        auto it = _directionCache.find(key);
+        if (state.prepared != nullptr)
+        {
+            // The cache is only read on the job pool, the search is cached once the guest asks for it.
+            if (it != _directionCache.end())
+                return it->second;
+
+            state.prepared->Key = key;
+            state.prepared->Chosen = PeepPathfindChooseBestEdge(
+                state, loc, goal, peep, firstTileElement, edges, maxTilesChecked);
+            state.prepared->Searched = true;
+            return state.prepared->Chosen;
+        }
+
+        if (it != _directionCache.end())
+        {
+            _directionCacheHits++;
+            return it->second;
+        }
+
+        _directionCacheMisses++;
+        Direction direction;
+        if (auto prepared = FindPreparedDirection(key); prepared.has_value())
+        {
+            _directionCachePrepared++;
+            direction = *prepared;
+        }
+        else
+        {
+            direction = PeepPathfindChooseBestEdge(state, loc, goal, peep, firstTileElement, edges, maxTilesChecked);
+        }
+        if (_directionCache.size() >= kMaxDirectionCacheEntries)
+        {
+            _directionCache.clear();
+        }
+        SubscribeToTileChanges();
+        _directionCache.emplace(key, direction);
+        return direction;
+    }
+
     /**
      * Returns:
      *   -1   - no direction chosen
@@ -1229,16 +1834,11 @@ namespace OpenRCT2::PathFinding
      *
      *  rct2: 0x0069A5F0
      */
-    Direction ChooseDirection(
-        const TileCoordsXYZ& loc, const TileCoordsXYZ& goal, Peep& peep, bool ignoreForeignQueues, RideId queueRideIndex)
+    static Direction ChooseDirection(
+        PathFindingState& state, const TileCoordsXYZ& loc, const TileCoordsXYZ& goal, Peep& peep)
     {
         PROFILED_FUNCTION();
 
-        PathFindingState state{};
-
-        state.ignoreForeignQueues = ignoreForeignQueues;
-        state.queueRideIndex = queueRideIndex;
-
         // The max number of thin junctions searched - a per-search-path limit.
         state.maxJunctions = PeepPathfindGetMaxNumberJunctions(peep);
 
@@ -1380,146 +1980,9 @@ namespace OpenRCT2::PathFinding
         // Peep has multiple edges still to try.
         if (edges & ~(1 << chosenEdge))
         {
-            uint8_t bestJunctions = 0;
-            TileCoordsXYZ bestJunctionList[16];
-            uint8_t bestDirectionList[16];
-            TileCoordsXYZ bestXYZ;
-
-            uint16_t bestScore = 0xFFFF;
-            uint8_t bestSub = 0xFF;
-
-            LogPathfinding(
-                &peep, "Pathfind start for goal %d,%d,%d from %d,%d,%d", goal.x, goal.y, goal.z, loc.x, loc.y, loc.z);
-
-            /* Call the search heuristic on each edge, keeping track of the
-             * edge that gives the best (i.e. smallest) value (best_score)
-             * or for different edges with equal value, the edge with the
-             * least steps (best_sub). */
-            int32_t numEdges = std::popcount(edges);
-            for (int32_t testEdge = chosenEdge; testEdge != -1; testEdge = UtilBitScanForward(edges))
-            {
-                edges &= ~(1 << testEdge);
-                uint8_t height = loc.z;
-
-                if (firstTileElement->AsPath()->IsSloped() && firstTileElement->AsPath()->GetSlopeDirection() == testEdge)
-                {
-                    height += 0x2;
-                }
-
-                /* Divide the maxTilesChecked global search limit
-                 * between the remaining edges to ensure the search
-                 * covers all of the remaining edges. */
-                state.countTilesChecked = maxTilesChecked / numEdges;
-                state.junctionCount = state.maxJunctions;
-
-                // Initialise _peepPathFindHistory.
-
-                for (auto& entry : state.history)
-                {
-                    entry.location.SetNull();
-                    entry.direction = INVALID_DIRECTION;
-                }
-
-                /* The pathfinding will only use elements
-                 * 1.._peepPathFindMaxJunctions, so the starting point
-                 * is placed in element 0 */
-                state.history[0].location = loc;
-                state.history[0].direction = 0xF;
-
-                uint16_t score = 0xFFFF;
-                /* Variable endXYZ contains the end location of the
-                 * search path. */
-                TileCoordsXYZ endXYZ;
-                endXYZ.x = 0;
-                endXYZ.y = 0;
-                endXYZ.z = 0;
-
-                uint8_t endSteps = 255;
-
-                /* Variable endJunctions is the number of junctions
-                 * passed through in the search path.
-                 * Variables endJunctionList and endDirectionList
-                 * contain the junctions and corresponding directions
-                 * of the search path.
-                 * In the future these could be used to visualise the
-                 * pathfinding on the map. */
-                uint8_t endJunctions = 0;
-                TileCoordsXYZ endJunctionList[16];
-                uint8_t endDirectionList[16] = { 0 };
-
-                bool inPatrolArea = false;
-                auto* staff = peep.As<Staff>();
-                if (staff != nullptr && staff->IsMechanic())
-                {
-                    /* Mechanics are the only staff type that
-                     * pathfind to a destination. Determine if the
-                     * mechanic is in their patrol area. */
-                    inPatrolArea = staff->IsLocationInPatrol(peep.NextLoc);
-                }
-
-                LogPathfinding(
-                    &peep, "Pathfind searching in direction: %d from %d,%d,%d", testEdge, loc.x >> 5, loc.y >> 5, loc.z);
-
-                PeepPathfindHeuristicSearch(
-                    state, { loc.x, loc.y, height }, goal, peep, firstTileElement, inPatrolArea, 0, &score, testEdge,
-                    &endJunctions, endJunctionList, endDirectionList, &endXYZ, &endSteps);
-
-                if constexpr (kLogPathfinding)
-                {
-                    LogPathfinding(
-                        &peep, "Pathfind test edge: %d score: %d steps: %d end: %d,%d,%d junctions: %d", testEdge, score,
-                        endSteps, endXYZ.x, endXYZ.y, endXYZ.z, endJunctions);
-                    for (uint8_t listIdx = 0; listIdx < endJunctions; listIdx++)
-                    {
-                        LogPathfinding(
-                            &peep, "Junction#%d %d,%d,%d Direction %d", listIdx + 1, endJunctionList[listIdx].x,
-                            endJunctionList[listIdx].y, endJunctionList[listIdx].z, endDirectionList[listIdx]);
-                    }
-                }
-
-                if (score < bestScore || (score == bestScore && endSteps < bestSub))
-                {
-                    chosenEdge = testEdge;
-                    bestScore = score;
-                    bestSub = endSteps;
-
-                    if constexpr (kLogPathfinding)
-                    {
-                        bestJunctions = endJunctions;
-                        for (uint8_t index = 0; index < endJunctions; index++)
-                        {
-                            bestJunctionList[index].x = endJunctionList[index].x;
-                            bestJunctionList[index].y = endJunctionList[index].y;
-                            bestJunctionList[index].z = endJunctionList[index].z;
-                            bestDirectionList[index] = endDirectionList[index];
-                        }
-                        bestXYZ.x = endXYZ.x;
-                        bestXYZ.y = endXYZ.y;
-                        bestXYZ.z = endXYZ.z;
-                    }
-                }
-            }
-
-            /* Check if the heuristic search failed. e.g. all connected
-             * paths are within the search limits and none reaches the
-             * goal. */
-            if (bestScore == 0xFFFF)
-            {
-                LogPathfinding(&peep, "Pathfind heuristic search failed.");
+            chosenEdge = PeepPathfindChooseEdgeCached(state, loc, goal, peep, firstTileElement, edges, maxTilesChecked);
+            if (chosenEdge == INVALID_DIRECTION)
                 return INVALID_DIRECTION;
-            }
-
-            if constexpr (kLogPathfinding)
-            {
-                LogPathfinding(&peep, "Pathfind best edge %d with score %d steps %d", chosenEdge, bestScore, bestSub);
-                for (uint8_t listIdx = 0; listIdx < bestJunctions; listIdx++)
-                {
-                    LogPathfinding(
-                        &peep, "Junction#%d %d,%d,%d Direction %d", listIdx + 1, bestJunctionList[listIdx].x,
-                        bestJunctionList[listIdx].y, bestJunctionList[listIdx].z, bestDirectionList[listIdx]);
-                }
-                LogPathfinding(&peep, "End at %d,%d,%d", bestXYZ.x, bestXYZ.y, bestXYZ.z);
-            }
         }
 
         if (isThin)
@@ -1562,6 +2025,15 @@ namespace OpenRCT2::PathFinding
         return chosenEdge;
     }
 
+    Direction ChooseDirection(
+        const TileCoordsXYZ& loc, const TileCoordsXYZ& goal, Peep& peep, bool ignoreForeignQueues, RideId queueRideIndex)
+    {
+        PathFindingState state{};
+        state.ignoreForeignQueues = ignoreForeignQueues;
+        state.queueRideIndex = queueRideIndex;
+        return ChooseDirection(state, loc, goal, peep);
+    }
+
     /**
      * Gets the nearest park entrance relative to point, by using Manhattan distance.
      * @param x x coordinate of location
@@ -1661,34 +2133,41 @@ namespace OpenRCT2::PathFinding
 
     /**
      *
-     *  rct2: 0x00695161
+    /**
+     * The park entrance the peep leaves through, which is the one it chose before as long as that still exists.
      */
-    int32_t GuestPathFindParkEntranceLeaving(Peep& peep, uint8_t edges)
+    static std::optional<TileCoordsXYZ> GetParkExitGoal(const Peep& peep)
     {
-        TileCoordsXYZ entranceGoal{};
         if (peep.PeepFlags & PEEP_FLAGS_PARK_ENTRANCE_CHOSEN)
         {
-            entranceGoal = peep.PathfindGoal;
-            auto* entranceElement = MapGetParkEntranceElementAt(entranceGoal.ToCoordsXYZ(), false);
-            // If entrance no longer exists, choose a new one
-            if (entranceElement == nullptr)
-            {
-                peep.PeepFlags &= ~(PEEP_FLAGS_PARK_ENTRANCE_CHOSEN);
-            }
+            const TileCoordsXYZ entranceGoal = peep.PathfindGoal;
+            if (MapGetParkEntranceElementAt(entranceGoal.ToCoordsXYZ(), false) != nullptr)
+                return entranceGoal;
         }
 
-        if (!(peep.PeepFlags & PEEP_FLAGS_PARK_ENTRANCE_CHOSEN))
-        {
-            auto chosenEntrance = GetNearestParkEntrance(peep.NextLoc);
+        auto chosenEntrance = GetNearestParkEntrance(peep.NextLoc);
+        if (!chosenEntrance.has_value())
+            return std::nullopt;
 
-            if (!chosenEntrance.has_value())
-                return GuestPathfindAimless(peep, edges);
+        return TileCoordsXYZ(*chosenEntrance);
+    }
 
-            peep.PeepFlags |= PEEP_FLAGS_PARK_ENTRANCE_CHOSEN;
-            entranceGoal = TileCoordsXYZ(*chosenEntrance);
+    /**
+     *
+     *  rct2: 0x00695161
+     */
+    int32_t GuestPathFindParkEntranceLeaving(Peep& peep, uint8_t edges)
+    {
+        const auto entranceGoal = GetParkExitGoal(peep);
+        if (!entranceGoal.has_value())
+        {
+            peep.PeepFlags &= ~(PEEP_FLAGS_PARK_ENTRANCE_CHOSEN);
+            return GuestPathfindAimless(peep, edges);
         }
+        peep.PeepFlags |= PEEP_FLAGS_PARK_ENTRANCE_CHOSEN;
 
-        Direction chosenDirection = ChooseDirection(TileCoordsXYZ{ peep.NextLoc }, entranceGoal, peep, true, RideId::GetNull());
+        Direction chosenDirection = ChooseDirection(
+            TileCoordsXYZ{ peep.NextLoc }, *entranceGoal, peep, true, RideId::GetNull());
         if (chosenDirection == INVALID_DIRECTION)
             return GuestPathfindAimless(peep, edges);
 
@@ -1876,6 +2355,74 @@ namespace OpenRCT2::PathFinding
 
         return StationIndex::FromUnderlying(0);
     }
+
+    /**
+     * The end of the queue at the entrance of the station the guest heads for, or the start of the first station if the
+     * ride has no entrances.
+     */
+    static TileCoordsXYZ GetRideGoal(const Guest& peep, const Ride& ride)
+    {
+        /* Find the ride's closest entrance station to the peep.
+         * At the same time, count how many entrance stations there are and
+         * which stations are entrance stations. */
+        auto bestScore = std::numeric_limits<int32_t>::max();
+        StationIndex closestStationNum = StationIndex::FromUnderlying(0);
+
+        int32_t numEntranceStations = 0;
+        BitSet<OpenRCT2::Limits::kMaxStationsPerRide> entranceStations = {};
+
+        for (const auto& station : ride.GetStations())
+        {
+            // Skip if stationNum has no entrance (so presumably an exit only station)
+            if (station.Entrance.IsNull())
+                continue;
+
+            const auto stationIndex = ride.GetStationIndex(&station);
+
+            numEntranceStations++;
+            entranceStations[stationIndex.ToUnderlying()] = true;
+
+            TileCoordsXYZD entranceLocation = station.Entrance;
+            auto score = CalculateHeuristicPathingScore(entranceLocation, TileCoordsXYZ{ peep.NextLoc });
+            if (score < bestScore)
+            {
+                bestScore = score;
+                closestStationNum = stationIndex;
+                continue;
+            }
+        }
+
+        // Ride has no stations with an entrance, so head to station 0.
+        if (numEntranceStations == 0)
+            closestStationNum = StationIndex::FromUnderlying(0);
+
+        if (numEntranceStations > 1 && (ride.depart_flags & RIDE_DEPART_SYNCHRONISE_WITH_ADJACENT_STATIONS))
+        {
+            closestStationNum = GuestPathfindingSelectRandomStation(peep, numEntranceStations, entranceStations);
+        }
+
+        TileCoordsXYZ loc;
+        if (numEntranceStations == 0)
+        {
+            // closestStationNum is always 0 here.
+            const auto& closestStation = ride.GetStation(closestStationNum);
+            auto entranceXY = TileCoordsXY(closestStation.Start);
+            loc.x = entranceXY.x;
+            loc.y = entranceXY.y;
+            loc.z = closestStation.Height;
+        }
+        else
+        {
+            TileCoordsXYZD entranceXYZD = ride.GetStation(closestStationNum).Entrance;
+            loc.x = entranceXYZD.x;
+            loc.y = entranceXYZD.y;
+            loc.z = entranceXYZD.z;
+        }
+
+        GetRideQueueEnd(loc);
+        return loc;
+    }
+
     /**
      *
      *  rct2: 0x00694C35
@@ -2047,84 +2594,116 @@ namespace OpenRCT2::PathFinding
             return GuestPathfindAimless(peep, edges);
         }
 
-        /* Find the ride's closest entrance station to the peep.
-         * At the same time, count how many entrance stations there are and
-         * which stations are entrance stations. */
-        auto bestScore = std::numeric_limits<int32_t>::max();
-        StationIndex closestStationNum = StationIndex::FromUnderlying(0);
-
-        int32_t numEntranceStations = 0;
-        BitSet<OpenRCT2::Limits::kMaxStationsPerRide> entranceStations = {};
+        const auto goal = GetRideGoal(peep, *ride);
+        direction = ChooseDirection(TileCoordsXYZ{ peep.NextLoc }, goal, peep, true, rideIndex);
 
-        for (const auto& station : ride->GetStations())
+        if (direction == INVALID_DIRECTION)
         {
-            // Skip if stationNum has no entrance (so presumably an exit only station)
-            if (station.Entrance.IsNull())
-                continue;
-
-            const auto stationIndex = ride->GetStationIndex(&station);
+            /* Heuristic search failed for all directions.
+             * Reset the PathfindGoal - this means that the PathfindHistory
+             * will be reset in the next call to ChooseDirection().
+             * This lets the heuristic search "try again" in case the player has
+             * edited the path layout or the mechanic was already stuck in the
+             * save game (e.g. with a worse version of the pathfinding). */
+            peep.ResetPathfindGoal();
 
-            numEntranceStations++;
-            entranceStations[stationIndex.ToUnderlying()] = true;
+            LogPathfinding(&peep, "Completed CalculateNextDestination - failed to choose a direction == aimless.");
 
-            TileCoordsXYZD entranceLocation = station.Entrance;
-            auto score = CalculateHeuristicPathingScore(entranceLocation, TileCoordsXYZ{ peep.NextLoc });
-            if (score < bestScore)
-            {
-                bestScore = score;
-                closestStationNum = stationIndex;
-                continue;
-            }
+            return GuestPathfindAimless(peep, edges);
         }
 
-        // Ride has no stations with an entrance, so head to station 0.
-        if (numEntranceStations == 0)
-            closestStationNum = StationIndex::FromUnderlying(0);
+        LogPathfinding(&peep, "Completed CalculateNextDestination - direction chosen: %d.", direction);
 
-        if (numEntranceStations > 1 && (ride->depart_flags & RIDE_DEPART_SYNCHRONISE_WITH_ADJACENT_STATIONS))
-        {
-            closestStationNum = GuestPathfindingSelectRandomStation(peep, numEntranceStations, entranceStations);
-        }
+        return PeepMoveOneTile(direction, peep);
+    }
 
-        if (numEntranceStations == 0)
+    struct GuestGoal
+    {
+        TileCoordsXYZ Location;
+        RideId QueueRideIndex;
+    };
+
+    /**
+     * What CalculateNextDestination makes the guest search a direction towards, if it heads for anything.
+     */
+    static std::optional<GuestGoal> GetGuestGoal(const Guest& guest)
+    {
+        if (guest.OutsideOfPark)
         {
-            // closestStationNum is always 0 here.
-            const auto& closestStation = ride->GetStation(closestStationNum);
-            auto entranceXY = TileCoordsXY(closestStation.Start);
-            loc.x = entranceXY.x;
-            loc.y = entranceXY.y;
-            loc.z = closestStation.Height;
+            if (guest.State != PeepState::EnteringPark)
+                return std::nullopt;
+
+            auto chosenEntrance = GetNearestParkEntrance(guest.NextLoc);
+            if (!chosenEntrance.has_value())
+                return std::nullopt;
+
+            return GuestGoal{ TileCoordsXYZ(*chosenEntrance), RideId::GetNull() };
         }
-        else
+
+        if (guest.State != PeepState::Walking)
+            return std::nullopt;
+
+        if (guest.PeepFlags & PEEP_FLAGS_LEAVING_PARK)
         {
-            TileCoordsXYZD entranceXYZD = ride->GetStation(closestStationNum).Entrance;
-            loc.x = entranceXYZD.x;
-            loc.y = entranceXYZD.y;
-            loc.z = entranceXYZD.z;
+            const auto entranceGoal = GetParkExitGoal(guest);
+            if (!entranceGoal.has_value())
+                return std::nullopt;
+
+            return GuestGoal{ *entranceGoal, RideId::GetNull() };
         }
 
-        GetRideQueueEnd(loc);
+        if (guest.GuestHeadingToRideId.IsNull())
+            return std::nullopt;
 
-        direction = ChooseDirection(TileCoordsXYZ{ peep.NextLoc }, loc, peep, true, rideIndex);
+        const auto* ride = GetRide(guest.GuestHeadingToRideId);
+        if (ride == nullptr || ride->status != RideStatus::Open)
+            return std::nullopt;
 
-        if (direction == INVALID_DIRECTION)
-        {
-            /* Heuristic search failed for all directions.
-             * Reset the PathfindGoal - this means that the PathfindHistory
-             * will be reset in the next call to ChooseDirection().
-             * This lets the heuristic search "try again" in case the player has
-             * edited the path layout or the mechanic was already stuck in the
-             * save game (e.g. with a worse version of the pathfinding). */
-            peep.ResetPathfindGoal();
+        return GuestGoal{ GetRideGoal(guest, *ride), guest.GuestHeadingToRideId };
+    }
 
-            LogPathfinding(&peep, "Completed CalculateNextDestination - failed to choose a direction == aimless.");
+    void PrepareGuestDirections()
+    {
+        PROFILED_FUNCTION();
 
-            return GuestPathfindAimless(peep, edges);
+        ForgetPreparedDirections();
+        if (!_directionCacheEnabled)
+            return;
+
+        // Guests walking to the centre of the tile they are on choose where to go next once they get there.
+        std::vector<const Guest*> guests;
+        for (auto* guest : EntityList<Guest>())
+        {
+            if (guest->GetNextIsSurface() || TileCoordsXY(guest->GetDestination()) != TileCoordsXY(guest->NextLoc))
+                continue;
+
+            guests.push_back(guest);
         }
 
-        LogPathfinding(&peep, "Completed CalculateNextDestination - direction chosen: %d.", direction);
+        std::vector<PreparedDirection> prepared(guests.size());
+        JobPool::GetShared().ParallelFor(0, guests.size(), 16, [&guests, &prepared](size_t i) {
+            // Choosing a direction updates the junctions the guest remembers, so the search works on a copy.
+            auto guest = *guests[i];
+            const auto goal = GetGuestGoal(guest);
+            if (!goal.has_value())
+                return;
 
-        return PeepMoveOneTile(direction, peep);
+            PathFindingState state{};
+            state.ignoreForeignQueues = true;
+            state.queueRideIndex = goal->QueueRideIndex;
+            state.prepared = &prepared[i];
+            ChooseDirection(state, TileCoordsXYZ{ guest.NextLoc }, goal->Location, guest);
+        });
+
+        // Handed over in entity id order, the same search can have been prepared for several guests.
+        for (const auto& direction : prepared)
+        {
+            if (direction.Searched)
+            {
+                _preparedDirections.emplace(direction.Key, direction.Chosen);
+            }
+        }
+        _preparedRecordCount = TileChanges::GetRecordCount();
     }
 
 } // namespace OpenRCT2::PathFinding
@@ -31,4 +31,39 @@ namespace OpenRCT2::PathFinding
 
     int32_t GuestPathFindParkEntranceLeaving(Peep& peep, uint8_t edges);
 
+    /**
+     * Forgets the runs of thin footpath and the directions the guest search has cached. Called whenever TileChanges
+     * publishes changes to paths, track, entrances or banners.
+     */
+    void InvalidateFootpathGraph();
+
+    // Lets the guest search step over cached runs of thin footpath, chosen directions are the same either way.
+    void SetFootpathGraphEnabled(bool enabled);
+
+    struct DirectionCacheStats
+    {
+        uint64_t Hits;
+        uint64_t Misses;
+        // Misses that took a direction prepared by PrepareGuestDirections instead of searching.
+        uint64_t Prepared;
+        size_t Entries;
+    };
+
+    // Lets guests reuse the direction chosen by an earlier search from the same junction towards the same goal.
+    void SetDirectionCacheEnabled(bool enabled);
+
+    DirectionCacheStats GetDirectionCacheStats();
+
+    void ResetDirectionCacheStats();
+
+    /**
+     * Runs the searches of the guests that choose a direction at their next tile centre on the job pool, before the
+     * guests update. A guest only takes a prepared direction on a miss of the direction cache, for exactly the same
+     * search, and only while no tile element has changed since. The guests therefore choose the same directions as
+     * without preparing.
+     */
+    void PrepareGuestDirections();
+
+    void ForgetPreparedDirections();
+
 }; // namespace OpenRCT2::PathFinding
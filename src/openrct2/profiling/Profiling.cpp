@@ -9,6 +9,7 @@
 
 #include "Profiling.h"
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <fstream>
@@ -120,13 +121,57 @@ namespace OpenRCT2::Profiling
             return Registry;
         }
 
+        std::vector<Counter*>& GetCounterRegistry()
+        {
+            static std::vector<Counter*> Registry;
+            return Registry;
+        }
+
     } // namespace Detail
 
+    Counter::Counter(const char* name)
+        : _name(name)
+    {
+        Detail::GetCounterRegistry().push_back(this);
+    }
+
+    void Counter::EndFrame() noexcept
+    {
+        const auto value = _value.exchange(0);
+        _lastFrameValue = value;
+        _maxFrameValue = std::max(_maxFrameValue.load(), value);
+        _totalValue += value;
+    }
+
+    void Counter::Reset() noexcept
+    {
+        _value = 0;
+        _lastFrameValue = 0;
+        _maxFrameValue = 0;
+        _totalValue = 0;
+    }
+
     const std::vector<Function*>& GetData()
     {
         return Detail::GetRegistry();
     }
 
+    const std::vector<Counter*>& GetCounters()
+    {
+        return Detail::GetCounterRegistry();
+    }
+
+    void EndFrame()
+    {
+        if (!_enabled)
+            return;
+
+        for (auto* counter : Detail::GetCounterRegistry())
+        {
+            counter->EndFrame();
+        }
+    }
+
     void ResetData()
     {
         for (auto* func : Detail::GetRegistry())
@@ -141,6 +186,11 @@ namespace OpenRCT2::Profiling
             funcInternal->Children.clear();
             funcInternal->Parents.clear();
         }
+
+        for (auto* counter : Detail::GetCounterRegistry())
+        {
+            counter->Reset();
+        }
     }
 
     bool ExportCSV(const std::string& filePath)
@@ -168,6 +218,16 @@ namespace OpenRCT2::Profiling
             out << avg << "\n";
         }
 
+        out << "\ncounter_name;last_frame;max_frame;total\n";
+        for (auto* counter : GetCounters())
+        {
+            out << "\"" << counter->GetName() << "\""
+                << ";";
+            out << counter->GetLastFrameValue() << ";";
+            out << counter->GetMaxFrameValue() << ";";
+            out << counter->GetTotalValue() << "\n";
+        }
+
         return true;
     }
 
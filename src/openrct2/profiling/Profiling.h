@@ -53,12 +53,64 @@ namespace OpenRCT2::Profiling
         virtual std::vector<Function*> GetChildren() const = 0;
     };
 
+    // Counts occurrences of an event per frame, e.g. allocations. Counters register themselves
+    // on construction and should therefore have static storage duration.
+    class Counter
+    {
+    private:
+        const char* _name;
+        std::atomic<uint64_t> _value{};
+        std::atomic<uint64_t> _lastFrameValue{};
+        std::atomic<uint64_t> _maxFrameValue{};
+        std::atomic<uint64_t> _totalValue{};
+
+    public:
+        explicit Counter(const char* name);
+        Counter(const Counter&) = delete;
+        Counter& operator=(const Counter&) = delete;
+
+        void Add(uint64_t amount = 1) noexcept
+        {
+            if (IsEnabled())
+            {
+                _value.fetch_add(amount, std::memory_order_relaxed);
+            }
+        }
+
+        const char* GetName() const noexcept
+        {
+            return _name;
+        }
+
+        // Value of the most recently completed frame.
+        uint64_t GetLastFrameValue() const noexcept
+        {
+            return _lastFrameValue.load();
+        }
+
+        // Highest value of all completed frames.
+        uint64_t GetMaxFrameValue() const noexcept
+        {
+            return _maxFrameValue.load();
+        }
+
+        // Sum of all completed frames.
+        uint64_t GetTotalValue() const noexcept
+        {
+            return _totalValue.load();
+        }
+
+        void EndFrame() noexcept;
+        void Reset() noexcept;
+    };
+
     namespace Detail
     {
         static constexpr auto MaxSamplesSize = 1024;
         static constexpr auto MaxNameSize = 250;
 
         std::vector<Function*>& GetRegistry();
+        std::vector<Counter*>& GetCounterRegistry();
 
         struct FunctionInternal : Function
         {
@@ -188,6 +240,12 @@ namespace OpenRCT2::Profiling
     // Returns all functions.
     const std::vector<Function*>& GetData();
 
+    // Returns all counters.
+    const std::vector<Counter*>& GetCounters();
+
+    // Closes the current frame of all counters, called once per frame.
+    void EndFrame();
+
     bool ExportCSV(const std::string& filePath);
 
 } // namespace OpenRCT2::Profiling
@@ -0,0 +1,232 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TickTimeline.h"
+
+#include "../core/String.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+
+namespace OpenRCT2::Profiling::TickTimeline
+{
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr const char* kPhaseNames[] = {
+        "Network",
+        "Date",
+        "Climate",
+        "MapTiles",
+        "Peeps",
+        "Vehicles",
+        "MiscEntities",
+        "Rides",
+        "Park",
+        "Research",
+        "RideRatings",
+        "Presentation",
+        "SpatialIndex",
+        "GameActions",
+        "Scripting",
+    };
+    static_assert(std::size(kPhaseNames) == kPhaseCount);
+
+    static bool _recording = false;
+    static std::vector<TickRecord> _records;
+    static size_t _capacity = 0;
+    static size_t _next = 0;
+    static Clock::time_point _origin;
+
+    static TickRecord _current;
+    static bool _inTick = false;
+    static Phase _currentPhase = Phase::Count;
+    static Clock::time_point _phaseStart;
+
+    static double ElapsedUs(Clock::time_point from, Clock::time_point to)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count() / 1000.0;
+    }
+
+    static void EndPhase(Clock::time_point now)
+    {
+        if (_currentPhase != Phase::Count)
+        {
+            _current.PhaseUs[static_cast<size_t>(_currentPhase)] += ElapsedUs(_phaseStart, now);
+            _currentPhase = Phase::Count;
+        }
+    }
+
+    double TickRecord::GetTotalTime() const
+    {
+        return std::accumulate(PhaseUs.begin(), PhaseUs.end(), 0.0);
+    }
+
+    void Start(size_t capacity)
+    {
+        _capacity = std::max<size_t>(capacity, 1);
+        _records.clear();
+        _records.reserve(_capacity);
+        _next = 0;
+        _origin = Clock::now();
+        _inTick = false;
+        _currentPhase = Phase::Count;
+        _recording = true;
+    }
+
+    void Stop()
+    {
+        _recording = false;
+        _inTick = false;
+    }
+
+    bool IsRecording()
+    {
+        return _recording;
+    }
+
+    void BeginTick(uint32_t tick)
+    {
+        if (!_recording)
+            return;
+
+        // A tick that returned early is simply replaced by the next one.
+        const auto now = Clock::now();
+        _current = {};
+        _current.Tick = tick;
+        _current.StartUs = ElapsedUs(_origin, now);
+        _inTick = true;
+        _currentPhase = Phase::Count;
+    }
+
+    void BeginPhase(Phase phase)
+    {
+        if (!_inTick)
+            return;
+
+        const auto now = Clock::now();
+        EndPhase(now);
+        _currentPhase = phase;
+        _phaseStart = now;
+    }
+
+    void EndTick(const EntityCounts& entities)
+    {
+        if (!_inTick)
+            return;
+
+        EndPhase(Clock::now());
+        _current.Entities = entities;
+        if (_records.size() < _capacity)
+        {
+            _records.push_back(_current);
+        }
+        else
+        {
+            _records[_next] = _current;
+        }
+        _next = (_next + 1) % _capacity;
+        _inTick = false;
+    }
+
+    std::vector<TickRecord> GetRecords()
+    {
+        if (_records.size() < _capacity)
+            return _records;
+
+        std::vector<TickRecord> records;
+        records.reserve(_records.size());
+        records.insert(records.end(), _records.begin() + _next, _records.end());
+        records.insert(records.end(), _records.begin(), _records.begin() + _next);
+        return records;
+    }
+
+    const char* GetPhaseName(Phase phase)
+    {
+        const auto index = static_cast<size_t>(phase);
+        return index < kPhaseCount ? kPhaseNames[index] : "Unknown";
+    }
+
+    bool ExportChromeTrace(const std::string& filePath)
+    {
+        std::ofstream out(filePath);
+        if (!out.is_open())
+            return false;
+
+        out << std::fixed << std::setprecision(3);
+        out << "{\"traceEvents\":[\n";
+        out << R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"Game logic"}})";
+        for (const auto& record : GetRecords())
+        {
+            out << ",\n";
+            out << R"({"name":"Tick","ph":"X","pid":1,"tid":1,"ts":)" << record.StartUs << R"(,"dur":)"
+                << record.GetTotalTime() << R"(,"args":{"tick":)" << record.Tick << "}}";
+
+            // Phases run back to back in the order of the enum.
+            auto ts = record.StartUs;
+            for (size_t i = 0; i < kPhaseCount; i++)
+            {
+                const auto duration = record.PhaseUs[i];
+                if (duration <= 0)
+                    continue;
+
+                out << ",\n";
+                out << R"({"name":")" << kPhaseNames[i] << R"(","ph":"X","pid":1,"tid":1,"ts":)" << ts << R"(,"dur":)"
+                    << duration << "}";
+                ts += duration;
+            }
+
+            const auto& entities = record.Entities;
+            out << ",\n";
+            out << R"({"name":"Entities","ph":"C","pid":1,"ts":)" << record.StartUs << R"(,"args":{"guests":)"
+                << entities.Guests << R"(,"staff":)" << entities.Staff << R"(,"vehicles":)" << entities.Vehicles
+                << R"(,"misc":)" << entities.Misc << "}}";
+        }
+        out << "\n]}\n";
+        return out.good();
+    }
+
+    bool ExportCSV(const std::string& filePath)
+    {
+        std::ofstream out(filePath);
+        if (!out.is_open())
+            return false;
+
+        out << "tick;start_microseconds";
+        for (const auto* name : kPhaseNames)
+        {
+            out << ";" << name << "_microseconds";
+        }
+        out << ";total_microseconds;guests;staff;vehicles;misc_entities\n";
+        out << std::setprecision(12);
+
+        for (const auto& record : GetRecords())
+        {
+            out << record.Tick << ";" << record.StartUs;
+            for (auto duration : record.PhaseUs)
+            {
+                out << ";" << duration;
+            }
+            const auto& entities = record.Entities;
+            out << ";" << record.GetTotalTime() << ";" << entities.Guests << ";" << entities.Staff << ";"
+                << entities.Vehicles << ";" << entities.Misc << "\n";
+        }
+        return out.good();
+    }
+
+    bool Export(const std::string& filePath)
+    {
+        if (String::EndsWith(filePath, ".csv", true))
+            return ExportCSV(filePath);
+        return ExportChromeTrace(filePath);
+    }
+
+} // namespace OpenRCT2::Profiling::TickTimeline
@@ -0,0 +1,88 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Records how long each phase of the game logic update took for every tick, together with the number of entities, so
+ * slow ticks can be traced back to the subsystem and park that caused them.
+ */
+namespace OpenRCT2::Profiling::TickTimeline
+{
+    // Listed in the order the update runs them, the exports rely on this to place the phases on the timeline.
+    enum class Phase : uint8_t
+    {
+        Network,
+        Date,
+        Climate,
+        MapTiles,
+        Peeps,
+        Vehicles,
+        MiscEntities,
+        Rides,
+        Park,
+        Research,
+        RideRatings,
+        Presentation,
+        SpatialIndex,
+        GameActions,
+        Scripting,
+        Count,
+    };
+    static constexpr size_t kPhaseCount = static_cast<size_t>(Phase::Count);
+
+    // Ten minutes of game time.
+    static constexpr size_t kDefaultCapacity = 40 * 60 * 10;
+
+    struct EntityCounts
+    {
+        uint16_t Guests{};
+        uint16_t Staff{};
+        uint16_t Vehicles{};
+        uint16_t Misc{};
+    };
+
+    struct TickRecord
+    {
+        uint32_t Tick{};
+        // Microseconds since the recording was started.
+        double StartUs{};
+        std::array<double, kPhaseCount> PhaseUs{};
+        EntityCounts Entities{};
+
+        double GetTotalTime() const;
+    };
+
+    // Starts recording, keeping the last capacity ticks. Any previous recording is discarded.
+    void Start(size_t capacity = kDefaultCapacity);
+    void Stop();
+    bool IsRecording();
+
+    void BeginTick(uint32_t tick);
+    // Ends the current phase and starts the next one.
+    void BeginPhase(Phase phase);
+    void EndTick(const EntityCounts& entities);
+
+    // Returns the recorded ticks, oldest first.
+    std::vector<TickRecord> GetRecords();
+
+    const char* GetPhaseName(Phase phase);
+
+    // Writes the trace event format read by chrome://tracing and Perfetto.
+    bool ExportChromeTrace(const std::string& filePath);
+    bool ExportCSV(const std::string& filePath);
+    // Writes a CSV file when the path ends in .csv and a Chrome trace otherwise.
+    bool Export(const std::string& filePath);
+
+} // namespace OpenRCT2::Profiling::TickTimeline
@@ -1518,9 +1518,9 @@ namespace OpenRCT2::RCT1
 
             std::vector<TileElement> tileElements;
             const auto maxSize = _s4.MapSize == 0 ? Limits::kMaxMapSize : _s4.MapSize;
-            for (TileCoordsXY coords = { 0, 0 }; coords.y < kMaximumMapSizeTechnical; coords.y++)
+            for (TileCoordsXY coords = { 0, 0 }; coords.y < gameState.MapSize.y; coords.y++)
             {
-                for (coords.x = 0; coords.x < kMaximumMapSizeTechnical; coords.x++)
+                for (coords.x = 0; coords.x < gameState.MapSize.x; coords.x++)
                 {
                     auto tileAdded = false;
                     if (coords.x < maxSize && coords.y < maxSize)
@@ -1190,9 +1190,9 @@ namespace OpenRCT2::RCT2
             bool nextElementInvisible = false;
             bool restOfTileInvisible = false;
             const auto maxSize = std::min(Limits::kMaxMapSize, _s6.MapSize);
-            for (TileCoordsXY coords = { 0, 0 }; coords.y < kMaximumMapSizeTechnical; coords.y++)
+            for (TileCoordsXY coords = { 0, 0 }; coords.y < gameState.MapSize.y; coords.y++)
             {
-                for (coords.x = 0; coords.x < kMaximumMapSizeTechnical; coords.x++)
+                for (coords.x = 0; coords.x < gameState.MapSize.x; coords.x++)
                 {
                     nextElementInvisible = false;
                     restOfTileInvisible = false;
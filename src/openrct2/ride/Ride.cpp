@@ -61,6 +61,7 @@
 #include "../world/MapAnimation.h"
 #include "../world/Park.h"
 #include "../world/Scenery.h"
+#include "../world/TileChanges.h"
 #include "../world/TileElementsView.h"
 #include "../world/tile_element/EntranceElement.h"
 #include "../world/tile_element/TrackElement.h"
@@ -69,6 +70,7 @@
 #include "RideConstruction.h"
 #include "RideData.h"
 #include "RideEntry.h"
+#include "RideOccupancy.h"
 #include "ShopItem.h"
 #include "Station.h"
 #include "Track.h"
@@ -77,12 +79,14 @@
 #include "TrainManager.h"
 #include "Vehicle.h"
 
+#include <algorithm>
 #include <cassert>
 #include <climits>
 #include <cstdlib>
 #include <iterator>
 #include <limits>
 #include <optional>
+#include <unordered_map>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::TrackMetaData;
@@ -195,6 +199,7 @@ Ride* RideAllocateAtIndex(RideId index)
     std::fill(std::begin(result->vehicles), std::end(result->vehicles), EntityId::GetNull());
 
     result->id = index;
+    RideOccupancy::InvalidateTallRides();
     return result;
 }
 
@@ -221,6 +226,7 @@ void RideDelete(RideId id)
 
     auto& ride = gameState.Rides[idx];
     RideReset(ride);
+    RideOccupancy::InvalidateTallRides();
 
     // Shrink maximum ride size.
     while (_endOfUsedRange > 0 && gameState.Rides[_endOfUsedRange - 1].id.IsNull())
@@ -599,11 +605,8 @@ bool TrackBlockGetNextFromZero(
  *
  *  rct2: 0x006C60C2
  */
-bool TrackBlockGetNext(CoordsXYE* input, CoordsXYE* output, int32_t* z, int32_t* direction)
+static bool TrackBlockGetNextUncached(CoordsXYE* input, CoordsXYE* output, int32_t* z, int32_t* direction)
 {
-    if (input == nullptr || input->element == nullptr)
-        return false;
-
     auto inputElement = input->element->AsTrack();
     if (inputElement == nullptr)
         return false;
@@ -741,11 +744,8 @@ bool TrackBlockGetPreviousFromZero(
  * higher two bytes of ecx and edx where as outTrackBeginEnd.end_x and
  * outTrackBeginEnd.end_y will be in the lower two bytes (cx and dx).
  */
-bool TrackBlockGetPrevious(const CoordsXYE& trackPos, TrackBeginEnd* outTrackBeginEnd)
+static bool TrackBlockGetPreviousUncached(const CoordsXYE& trackPos, TrackBeginEnd* outTrackBeginEnd)
 {
-    if (trackPos.element == nullptr)
-        return false;
-
     auto trackElement = trackPos.element->AsTrack();
     if (trackElement == nullptr)
         return false;
@@ -780,6 +780,150 @@ bool TrackBlockGetPrevious(const CoordsXYE& trackPos, TrackBeginEnd* outTrackBeg
     return TrackBlockGetPreviousFromZero({ coords, z }, *ride, rotation, outTrackBeginEnd);
 }
 
+#pragma region Track graph
+/*
+ * Vehicles, ride tests and ratings keep walking the same track, each step scanning a tile for the connecting piece. The
+ * connections found are remembered per track element until any tile element changes.
+ */
+struct TrackGraphNode
+{
+    CoordsXY Location;
+    bool HasNext{};
+    bool HasPrevious{};
+    CoordsXYE Next;
+    int32_t NextZ{};
+    int32_t NextDirection{};
+    TrackBeginEnd Previous{};
+};
+
+static std::unordered_map<uint32_t, TrackGraphNode> _trackGraph;
+static bool _trackGraphFrozen;
+static uint32_t _trackGraphTileChangesCookie;
+
+// Connections point at elements, which move whenever any element is inserted or removed on their tile.
+static bool AffectsTrackGraph(const TileChanges::ChangeSet& changes)
+{
+    if (changes.AllTilesChanged)
+        return true;
+
+    return std::any_of(changes.Changes.begin(), changes.Changes.end(), [](const TileChanges::Change& change) {
+        return change.Kind != TileChanges::ChangeKind::Modified || change.ElementType == TileElementType::Track;
+    });
+}
+
+static TrackGraphNode* GetTrackGraphNode(const CoordsXY& location, const TileElement* tileElement)
+{
+    // Copies of tile elements are not part of the map, and neither are their connections.
+    const auto& tileElements = GetTileElements();
+    if (tileElements.empty() || tileElement < tileElements.data() || tileElement >= tileElements.data() + tileElements.size())
+        return nullptr;
+
+    const auto index = static_cast<uint32_t>(tileElement - tileElements.data());
+    if (_trackGraphFrozen)
+    {
+        auto it = _trackGraph.find(index);
+        if (it == _trackGraph.end() || it->second.Location != location)
+            return nullptr;
+        return &it->second;
+    }
+
+    if (_trackGraphTileChangesCookie == 0)
+    {
+        _trackGraphTileChangesCookie = TileChanges::Subscribe([](const TileChanges::ChangeSet& changes) {
+            if (AffectsTrackGraph(changes))
+            {
+                InvalidateTrackGraph();
+            }
+        });
+    }
+
+    auto [it, inserted] = _trackGraph.try_emplace(index);
+    auto& node = it->second;
+    if (inserted)
+    {
+        node.Location = location;
+    }
+    else if (node.Location != location)
+    {
+        return nullptr;
+    }
+    return &node;
+}
+
+bool TrackBlockGetNext(CoordsXYE* input, CoordsXYE* output, int32_t* z, int32_t* direction)
+{
+    if (input == nullptr || input->element == nullptr)
+        return false;
+
+    auto* node = GetTrackGraphNode(*input, input->element);
+    if (node != nullptr && node->HasNext)
+    {
+        *output = node->Next;
+        if (z != nullptr)
+            *z = node->NextZ;
+        if (direction != nullptr)
+            *direction = node->NextDirection;
+        return true;
+    }
+
+    if (node == nullptr || _trackGraphFrozen)
+        return TrackBlockGetNextUncached(input, output, z, direction);
+
+    // Only connections that were found are remembered, failures leave different parts of the output behind.
+    int32_t nextZ{};
+    int32_t nextDirection{};
+    int32_t* outZ = z != nullptr ? z : &nextZ;
+    int32_t* outDirection = direction != nullptr ? direction : &nextDirection;
+    if (!TrackBlockGetNextUncached(input, output, outZ, outDirection))
+        return false;
+
+    node->HasNext = true;
+    node->Next = *output;
+    node->NextZ = *outZ;
+    node->NextDirection = *outDirection;
+    return true;
+}
+
+bool TrackBlockGetPrevious(const CoordsXYE& trackPos, TrackBeginEnd* outTrackBeginEnd)
+{
+    if (trackPos.element == nullptr)
+        return false;
+
+    auto* node = GetTrackGraphNode(trackPos, trackPos.element);
+    if (node != nullptr && node->HasPrevious)
+    {
+        // end_element is not part of the result.
+        auto* endElement = outTrackBeginEnd->end_element;
+        *outTrackBeginEnd = node->Previous;
+        outTrackBeginEnd->end_element = endElement;
+        return true;
+    }
+
+    if (node == nullptr || _trackGraphFrozen)
+        return TrackBlockGetPreviousUncached(trackPos, outTrackBeginEnd);
+
+    if (!TrackBlockGetPreviousUncached(trackPos, outTrackBeginEnd))
+        return false;
+
+    node->HasPrevious = true;
+    node->Previous = *outTrackBeginEnd;
+    return true;
+}
+
+void InvalidateTrackGraph()
+{
+    if (!_trackGraph.empty())
+    {
+        _trackGraph.clear();
+    }
+}
+
+void SetTrackGraphFrozen(bool frozen)
+{
+    _trackGraphFrozen = frozen;
+}
+#pragma endregion
+
 /**
  *
  * Make sure to pass in the x and y of the start track element too.
@@ -963,6 +1107,7 @@ void RideInitAll()
     auto& gameState = GetGameState();
     std::for_each(std::begin(gameState.Rides), std::end(gameState.Rides), RideReset);
     _endOfUsedRange = 0;
+    RideOccupancy::InvalidateTallRides();
 }
 
 /**
@@ -1804,51 +1949,42 @@ Staff* RideFindClosestMechanic(const Ride& ride, int32_t forInspection)
  */
 Staff* FindClosestMechanic(const CoordsXY& entrancePosition, int32_t forInspection)
 {
-    Staff* closestMechanic = nullptr;
-    uint32_t closestDistance = std::numeric_limits<uint32_t>::max();
+    auto location = entrancePosition.ToTileStart();
+    const bool locationInPark = MapIsLocationInPark(location);
+    return FindNearestEntity<Staff>(
+        entrancePosition, std::numeric_limits<uint32_t>::max(), [&](const Staff& peep) -> std::optional<uint32_t> {
+            if (!peep.IsMechanic())
+                return std::nullopt;
 
-    for (auto peep : EntityList<Staff>())
-    {
-        if (!peep->IsMechanic())
-            continue;
+            if (!forInspection)
+            {
+                if (peep.State == PeepState::HeadingToInspection)
+                {
+                    if (peep.SubState >= 4)
+                        return std::nullopt;
+                }
+                else if (peep.State != PeepState::Patrolling)
+                    return std::nullopt;
 
-        if (!forInspection)
-        {
-            if (peep->State == PeepState::HeadingToInspection)
+                if (!(peep.StaffOrders & STAFF_ORDERS_FIX_RIDES))
+                    return std::nullopt;
+            }
+            else
             {
-                if (peep->SubState >= 4)
-                    continue;
+                if (peep.State != PeepState::Patrolling || !(peep.StaffOrders & STAFF_ORDERS_INSPECT_RIDES))
+                    return std::nullopt;
             }
-            else if (peep->State != PeepState::Patrolling)
-                continue;
 
-            if (!(peep->StaffOrders & STAFF_ORDERS_FIX_RIDES))
-                continue;
-        }
-        else
-        {
-            if (peep->State != PeepState::Patrolling || !(peep->StaffOrders & STAFF_ORDERS_INSPECT_RIDES))
-                continue;
-        }
-
-        auto location = entrancePosition.ToTileStart();
-        if (MapIsLocationInPark(location))
-            if (!peep->IsLocationInPatrol(location))
-                continue;
-
-        if (peep->x == kLocationNull)
-            continue;
+            if (locationInPark)
+                if (!peep.IsLocationInPatrol(location))
+                    return std::nullopt;
 
-        // Manhattan distance
-        uint32_t distance = std::abs(peep->x - entrancePosition.x) + std::abs(peep->y - entrancePosition.y);
-        if (distance < closestDistance)
-        {
-            closestDistance = distance;
-            closestMechanic = peep;
-        }
-    }
+            if (peep.x == kLocationNull)
+                return std::nullopt;
 
-    return closestMechanic;
+            // Manhattan distance
+            return std::abs(peep.x - entrancePosition.x) + std::abs(peep.y - entrancePosition.y);
+        });
 }
 
 Staff* RideGetMechanic(const Ride& ride)
@@ -4654,6 +4790,7 @@ void InvalidateTestResults(Ride& ride)
 {
     ride.measurement = {};
     ride.ratings.setNull();
+    RideOccupancy::InvalidateTallRides();
     ride.lifecycle_flags &= ~RIDE_LIFECYCLE_TESTED;
     ride.lifecycle_flags &= ~RIDE_LIFECYCLE_TEST_IN_PROGRESS;
     if (ride.lifecycle_flags & RIDE_LIFECYCLE_ON_TRACK)
@@ -1041,6 +1041,15 @@ bool TrackBlockGetPrevious(const CoordsXYE& trackPos, TrackBeginEnd* outTrackBeg
 bool TrackBlockGetPreviousFromZero(
     const CoordsXYZ& startPos, const Ride& ride, uint8_t direction, TrackBeginEnd* outTrackBeginEnd);
 
+/**
+ * Forgets the track connections remembered by TrackBlockGetNext and TrackBlockGetPrevious. Called whenever TileChanges
+ * publishes an insert or removal, or a change to track.
+ */
+void InvalidateTrackGraph();
+
+// While frozen the remembered track connections are only read, so that track can be walked on several threads.
+void SetTrackGraphFrozen(bool frozen);
+
 void RideGetStartOfTrack(CoordsXYE* output);
 
 money64 RideEntranceExitPlaceGhost(
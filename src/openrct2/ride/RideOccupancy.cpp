@@ -0,0 +1,196 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "RideOccupancy.h"
+
+#include "../world/Map.h"
+#include "../world/TileChanges.h"
+#include "../world/TileElementsView.h"
+#include "../world/tile_element/TrackElement.h"
+#include "Ride.h"
+#include "RideRatings.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace OpenRCT2::RideOccupancy
+{
+    /*
+     * The map is split into blocks of 8x8 tiles, each remembering which rides have track in it and on which of its
+     * tiles. Blocks fully inside the searched area add their rides at once, blocks on the border only look at the tiles
+     * that have track. Blocks are rebuilt when first used after track on one of their tiles changed.
+     */
+    static constexpr int32_t kBlockSize = 8;
+    static constexpr int32_t kBlocksPerSide = (kMaximumMapSizeTechnical + kBlockSize - 1) / kBlockSize;
+
+    struct Block
+    {
+        RideSet Rides;
+        // Bit y * kBlockSize + x is set when the tile at x, y within the block has track.
+        uint64_t TrackTiles{};
+        uint32_t Generation{};
+    };
+
+    static std::vector<Block> _blocks;
+    static uint32_t _generation = 1;
+    static uint32_t _tileChangesCookie;
+
+    static RideSet _tallRides;
+    static bool _tallRidesValid;
+
+    static bool AddRidesOnTile(RideSet& rides, const TileCoordsXY& tile)
+    {
+        bool hasTrack = false;
+        for (auto* trackElement : TileElementsView<TrackElement>(tile.ToCoordsXY()))
+        {
+            auto rideIndex = trackElement->GetRideIndex();
+            if (!rideIndex.IsNull())
+            {
+                rides[rideIndex.ToUnderlying()] = true;
+                hasTrack = true;
+            }
+        }
+        return hasTrack;
+    }
+
+    static void OnTileChanges(const TileChanges::ChangeSet& changes)
+    {
+        if (changes.AllTilesChanged)
+        {
+            Invalidate();
+            return;
+        }
+        if (_blocks.empty())
+            return;
+
+        for (const auto& change : changes.Changes)
+        {
+            if (change.ElementType != TileElementType::Track)
+                continue;
+            if (change.Coords.x >= kMaximumMapSizeTechnical || change.Coords.y >= kMaximumMapSizeTechnical)
+                continue;
+
+            auto& block = _blocks[(change.Coords.y / kBlockSize) * kBlocksPerSide + change.Coords.x / kBlockSize];
+            block.Generation = 0;
+        }
+    }
+
+    static const Block& GetBlock(int32_t blockX, int32_t blockY)
+    {
+        if (_blocks.empty())
+        {
+            _blocks.resize(kBlocksPerSide * kBlocksPerSide);
+        }
+        if (_tileChangesCookie == 0)
+        {
+            _tileChangesCookie = TileChanges::Subscribe(OnTileChanges);
+        }
+
+        auto& block = _blocks[blockY * kBlocksPerSide + blockX];
+        if (block.Generation == _generation)
+            return block;
+
+        block.Rides.reset();
+        block.TrackTiles = 0;
+        block.Generation = _generation;
+        for (int32_t y = 0; y < kBlockSize; y++)
+        {
+            for (int32_t x = 0; x < kBlockSize; x++)
+            {
+                const TileCoordsXY tile{ blockX * kBlockSize + x, blockY * kBlockSize + y };
+                if (tile.x >= kMaximumMapSizeTechnical || tile.y >= kMaximumMapSizeTechnical)
+                    continue;
+
+                if (AddRidesOnTile(block.Rides, tile))
+                {
+                    block.TrackTiles |= 1ULL << (y * kBlockSize + x);
+                }
+            }
+        }
+        return block;
+    }
+
+    void AddRidesNear(RideSet& rides, const TileCoordsXY& centre, int32_t radius)
+    {
+        const int32_t minX = std::max(centre.x - radius, 0);
+        const int32_t minY = std::max(centre.y - radius, 0);
+        const int32_t maxX = std::min(centre.x + radius, kMaximumMapSizeTechnical - 1);
+        const int32_t maxY = std::min(centre.y + radius, kMaximumMapSizeTechnical - 1);
+        if (minX > maxX || minY > maxY)
+            return;
+
+        for (int32_t blockY = minY / kBlockSize; blockY <= maxY / kBlockSize; blockY++)
+        {
+            for (int32_t blockX = minX / kBlockSize; blockX <= maxX / kBlockSize; blockX++)
+            {
+                const auto& block = GetBlock(blockX, blockY);
+                if (block.TrackTiles == 0)
+                    continue;
+
+                const int32_t x0 = std::max(minX - blockX * kBlockSize, 0);
+                const int32_t y0 = std::max(minY - blockY * kBlockSize, 0);
+                const int32_t x1 = std::min(maxX - blockX * kBlockSize, kBlockSize - 1);
+                const int32_t y1 = std::min(maxY - blockY * kBlockSize, kBlockSize - 1);
+                if (x0 == 0 && y0 == 0 && x1 == kBlockSize - 1 && y1 == kBlockSize - 1)
+                {
+                    rides |= block.Rides;
+                    continue;
+                }
+
+                const uint64_t rowMask = ((1ULL << (x1 - x0 + 1)) - 1) << x0;
+                uint64_t tiles = 0;
+                for (int32_t y = y0; y <= y1; y++)
+                {
+                    tiles |= rowMask << (y * kBlockSize);
+                }
+                tiles &= block.TrackTiles;
+                while (tiles != 0)
+                {
+                    const int32_t bit = std::countr_zero(tiles);
+                    tiles &= tiles - 1;
+                    AddRidesOnTile(
+                        rides, { blockX * kBlockSize + bit % kBlockSize, blockY * kBlockSize + bit / kBlockSize });
+                }
+            }
+        }
+    }
+
+    void AddTallRides(RideSet& rides)
+    {
+        if (!_tallRidesValid)
+        {
+            _tallRides.reset();
+            for (auto& ride : GetRideManager())
+            {
+                if (ride.highest_drop_height > 66 || ride.ratings.excitement >= RIDE_RATING(8, 00))
+                {
+                    _tallRides[ride.id.ToUnderlying()] = true;
+                }
+            }
+            _tallRidesValid = true;
+        }
+        rides |= _tallRides;
+    }
+
+    void Invalidate()
+    {
+        // Blocks start out at generation 0, which therefore must never become current.
+        if (++_generation == 0)
+        {
+            _blocks.clear();
+            _generation = 1;
+        }
+    }
+
+    void InvalidateTallRides()
+    {
+        _tallRidesValid = false;
+    }
+} // namespace OpenRCT2::RideOccupancy
@@ -0,0 +1,36 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../Limits.h"
+#include "../core/BitSet.hpp"
+#include "../world/Location.hpp"
+
+#include <cstdint>
+
+namespace OpenRCT2::RideOccupancy
+{
+    using RideSet = BitSet<Limits::kMaxRidesInPark>;
+
+    /**
+     * Adds every ride with track on a tile at most radius tiles away from centre along both axes, the same as looking
+     * at the track elements of each of those tiles.
+     */
+    void AddRidesNear(RideSet& rides, const TileCoordsXY& centre, int32_t radius);
+
+    // Adds the rides that guests can see from anywhere in the park.
+    void AddTallRides(RideSet& rides);
+
+    // Forgets the rides of every block, changes published by TileChanges only forget the blocks they touch.
+    void Invalidate();
+
+    // Needs to be called when a ride is added or removed, or its ratings or highest drop change.
+    void InvalidateTallRides();
+} // namespace OpenRCT2::RideOccupancy
@@ -13,6 +13,7 @@
 #include "../Context.h"
 #include "../GameState.h"
 #include "../OpenRCT2.h"
+#include "../core/JobPool.h"
 #include "../interface/Window.h"
 #include "../localisation/Localisation.Date.h"
 #include "../profiling/Profiling.h"
@@ -23,11 +24,13 @@
 #include "../world/tile_element/TrackElement.h"
 #include "Ride.h"
 #include "RideData.h"
+#include "RideOccupancy.h"
 #include "Station.h"
 #include "Track.h"
 #include "TrackData.h"
 
 #include <iterator>
+#include <vector>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::Scripting;
@@ -182,6 +185,60 @@ void RideRatingsUpdateRide(const Ride& ride)
     }
 }
 
+/**
+ * Runs the state machine up to the point where the ratings get calculated. Up to there it only reads the map and the
+ * ride, so the track of several rides can be walked at once.
+ */
+static void RideRatingsWalkTrack(RideRatingUpdateState& state, size_t maxSteps)
+{
+    for (size_t i = 0; i < maxSteps; i++)
+    {
+        if (state.State == RIDE_RATINGS_STATE_CALCULATE || state.State == RIDE_RATINGS_STATE_FIND_NEXT_RIDE)
+            return;
+
+        ride_ratings_update_state(state);
+    }
+
+    // The track runs in circles without coming back to the station, the state machine would never finish either.
+    state.State = RIDE_RATINGS_STATE_FIND_NEXT_RIDE;
+}
+
+void RideRatingsUpdateRides(const std::vector<RideId>& rides)
+{
+    PROFILED_FUNCTION();
+
+    std::vector<RideRatingUpdateState> states;
+    states.reserve(rides.size());
+    for (const auto rideId : rides)
+    {
+        const auto* ride = GetRide(rideId);
+        if (ride == nullptr || ride->status == RideStatus::Closed)
+            continue;
+
+        auto& state = states.emplace_back();
+        state.CurrentRide = rideId;
+        state.State = RIDE_RATINGS_STATE_INITIALISE;
+    }
+    if (states.empty())
+        return;
+
+    // Every step visits another track piece, going once forwards and once backwards.
+    const size_t maxSteps = GetTileElements().size() * 2 + 4;
+    SetTrackGraphFrozen(true);
+    JobPool::GetShared().ParallelFor(
+        0, states.size(), 1, [&states, maxSteps](size_t i) { RideRatingsWalkTrack(states[i], maxSteps); });
+    SetTrackGraphFrozen(false);
+
+    // Calculating runs the script hooks and invalidates the ride window, which has to happen on this thread.
+    for (auto& state : states)
+    {
+        if (state.State == RIDE_RATINGS_STATE_CALCULATE)
+        {
+            ride_ratings_update_state(state);
+        }
+    }
+}
+
 /**
  *
  *  rct2: 0x006B5A2A
@@ -430,6 +487,7 @@ static void ride_ratings_update_state_3(RideRatingUpdateState& state)
 
     RideRatingsCalculate(state, *ride);
     RideRatingsCalculateValue(*ride);
+    RideOccupancy::InvalidateTallRides();
 
     WindowInvalidateByNumber(WindowClass::Ride, state.CurrentRide.ToUnderlying());
     state.State = RIDE_RATINGS_STATE_FIND_NEXT_RIDE;
@@ -14,6 +14,8 @@
 #include "../world/Location.hpp"
 #include "RideTypes.h"
 
+#include <vector>
+
 using ride_rating = fixed16_2dp;
 namespace OpenRCT2
 {
@@ -67,6 +69,12 @@ using RideRatingUpdateStates = std::array<RideRatingUpdateState, RideRatingMaxUp
 void RideRatingResetUpdateStates();
 
 void RideRatingsUpdateRide(const Ride& ride);
+
+/**
+ * Calculates the ratings of the given rides right away, with the same result as RideRatingsUpdateRide. The track of the
+ * rides is walked on multiple threads.
+ */
+void RideRatingsUpdateRides(const std::vector<RideId>& rides);
 void RideRatingsUpdateAll();
 
 // Special Track Element Adjustment functions for RTDs
@@ -2148,10 +2148,9 @@ void TrackDesignDrawPreview(TrackDesign& td, uint8_t* pixels)
  */
 static void TrackDesignPreviewClearMap()
 {
-    auto numTiles = kMaximumMapSizeTechnical * kMaximumMapSizeTechnical;
-
     auto& gameState = GetGameState();
     gameState.MapSize = TRACK_DESIGN_PREVIEW_MAP_SIZE;
+    auto numTiles = gameState.MapSize.x * gameState.MapSize.y;
 
     // Reserve ~8 elements per tile
     std::vector<TileElement> tileElements;
@@ -19,6 +19,7 @@
 #include "../interface/Window.h"
 #include "../object/StationObject.h"
 #include "../paint/Paint.SessionFlags.h"
+#include "../paint/Paint.TileCache.h"
 #include "../paint/Paint.h"
 #include "../paint/support/MetalSupports.h"
 #include "../paint/support/WoodenSupports.h"
@@ -1726,6 +1727,7 @@ void TrackPaintUtilLeftQuarterTurn1TilePaint(
 
 void TrackPaintUtilSpinningTunnelPaint(PaintSession& session, int8_t thickness, int16_t height, Direction direction)
 {
+    PaintTileCacheMarkVolatile(session);
     int32_t frame = (GetGameState().CurrentTicks >> 2) & 3;
     auto colourFlags = session.SupportColours;
 
@@ -2004,6 +2006,12 @@ void PaintTrack(PaintSession& session, Direction direction, int32_t height, cons
         }
 
         const auto& rtd = GetRideTypeDescriptor(trackElement.GetRideType());
+        if (rtd.HasFlag(RtdFlag::isFlatRide))
+        {
+            // Flat rides paint their structure from the state of their vehicles.
+            PaintTileCacheMarkVolatile(session);
+        }
+
         bool isInverted = trackElement.IsInverted() && rtd.HasFlag(RtdFlag::hasInvertedVariant);
         const auto trackDrawerEntry = getTrackDrawerEntry(rtd, isInverted, TrackElementIsCovered(trackType));
 
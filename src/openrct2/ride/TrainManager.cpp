@@ -19,9 +19,14 @@ namespace OpenRCT2::TrainManager
     {
         Entity = nullptr;
 
-        while (iter != end && Entity == nullptr)
+        while (Entity == nullptr)
         {
-            Entity = GetEntity<Vehicle>(*iter++);
+            const auto id = cursor.Next();
+            if (id.IsNull())
+            {
+                break;
+            }
+            Entity = GetEntity<Vehicle>(id);
             if (Entity != nullptr && !Entity->IsHead())
             {
                 Entity = nullptr;
@@ -23,6 +23,7 @@
 #include "../core/FixedPoint.hpp"
 #include "../core/Memory.hpp"
 #include "../core/Speed.hpp"
+#include "../core/TickArena.h"
 #include "../entity/EntityRegistry.h"
 #include "../entity/Particle.h"
 #include "../entity/Yaw.hpp"
@@ -52,6 +53,7 @@
 #include "CableLift.h"
 #include "Ride.h"
 #include "RideData.h"
+#include "RideOccupancy.h"
 #include "Station.h"
 #include "Track.h"
 #include "TrackData.h"
@@ -59,6 +61,7 @@
 #include "VehicleData.h"
 #include "VehicleSubpositionData.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iterator>
 
@@ -585,8 +588,10 @@ Vehicle* TryGetVehicle(EntityId spriteIndex)
 
 void VehicleSoundsUpdate()
 {
+    // Called every tick, constructing an intent can allocate.
+    static const auto intent = Intent(INTENT_ACTION_UPDATE_VEHICLE_SOUNDS);
     auto windowManager = OpenRCT2::GetContext()->GetUiContext()->GetWindowManager();
-    windowManager->BroadcastIntent(Intent(INTENT_ACTION_UPDATE_VEHICLE_SOUNDS));
+    windowManager->BroadcastIntent(intent);
 }
 
 /**
@@ -1029,6 +1034,7 @@ void Vehicle::UpdateMeasurements()
                     if (curZ > curRide->highest_drop_height)
                     {
                         curRide->highest_drop_height = static_cast<uint8_t>(curZ);
+                        RideOccupancy::InvalidateTallRides();
                     }
                 }
             }
@@ -1060,6 +1066,7 @@ void Vehicle::UpdateMeasurements()
                     if (curZ > curRide->highest_drop_height)
                     {
                         curRide->highest_drop_height = static_cast<uint8_t>(curZ);
+                        RideOccupancy::InvalidateTallRides();
                     }
                 }
             }
@@ -2362,6 +2369,7 @@ static void test_reset(Ride& ride, StationIndex curStation)
     ride.var_11C = 0;
     ride.num_sheltered_sections = 0;
     ride.highest_drop_height = 0;
+    RideOccupancy::InvalidateTallRides();
     ride.special_track_elements = 0;
     for (auto& station : ride.GetStations())
     {
@@ -6734,10 +6742,8 @@ void Vehicle::ReverseReverserCar()
  *
  *  rct2: 0x006DBF3E
  */
-void Vehicle::Sub6DBF3E()
+void Vehicle::Sub6DBF3E(const CarEntry* carEntry)
 {
-    const auto* carEntry = Entry();
-
     acceleration /= _vehicleUnkF64E10;
     if (TrackSubposition == VehicleTrackSubposition::ChairliftGoingBack)
     {
@@ -8488,6 +8494,16 @@ void Vehicle::UpdateTrackMotionPreUpdate(
     car.MoveTo(_vehicleCurPosition);
 }
 
+// Cars of a train nearly always share the ride entry of the head, which is then only looked up once per train.
+static const CarEntry* GetTrainCarEntry(const Vehicle& car, const Vehicle& head, const RideObjectEntry* headRideEntry)
+{
+    if (car.ride_subtype != head.ride_subtype)
+        return car.Entry();
+    if (headRideEntry == nullptr)
+        return nullptr;
+    return &headRideEntry->Cars[car.vehicle_type];
+}
+
 /**
  *
  *  rct2: 0x006DAB4C
@@ -8520,74 +8536,59 @@ int32_t Vehicle::UpdateTrackMotion(int32_t* outStation)
     CheckAndApplyBlockSectionStopSite();
     UpdateVelocity();
 
-    Vehicle* vehicle = this;
-    if (_vehicleVelocityF64E08 < 0 && !vehicle->HasFlag(VehicleFlags::MoveSingleCar))
+    // The cars are collected once so both passes below iterate a contiguous list instead of following the links.
+    TickVector<Vehicle*> cars;
+    for (auto* car = this; car != nullptr; car = GetEntity<Vehicle>(car->next_vehicle_on_train))
     {
-        vehicle = vehicle->TrainTail();
+        cars.push_back(car);
     }
-    // This will be the front vehicle even when traveling
-    // backwards.
-    _vehicleFrontVehicle = vehicle;
 
-    auto spriteId = vehicle->Id;
-    while (!spriteId.IsNull())
-    {
-        Vehicle* car = GetEntity<Vehicle>(spriteId);
-        if (car == nullptr)
-        {
-            break;
-        }
-        carEntry = car->Entry();
+    // When travelling backwards the cars are moved starting from the tail, which then acts as the front vehicle.
+    const bool backwards = _vehicleVelocityF64E08 < 0 && !HasFlag(VehicleFlags::MoveSingleCar);
+    _vehicleFrontVehicle = backwards ? cars.back() : this;
+
+    const auto updateCar = [&](Vehicle* car) {
+        carEntry = GetTrainCarEntry(*car, *this, rideEntry);
         if (carEntry != nullptr)
         {
             UpdateTrackMotionPreUpdate(*car, *curRide, *rideEntry, carEntry);
         }
 
-        car->Sub6DBF3E();
+        car->Sub6DBF3E(carEntry);
 
         // Loc6DC0F7
         if (car->HasFlag(VehicleFlags::OnLiftHill))
         {
             _vehicleMotionTrackFlags |= VEHICLE_UPDATE_MOTION_TRACK_FLAG_VEHICLE_ON_LIFT_HILL;
         }
-        if (car->HasFlag(VehicleFlags::MoveSingleCar))
-        {
-            if (outStation != nullptr)
-                *outStation = _vehicleStationIndex.ToUnderlying();
-            return _vehicleMotionTrackFlags;
-        }
-        if (_vehicleVelocityF64E08 >= 0)
-        {
-            spriteId = car->next_vehicle_on_train;
-        }
-        else
-        {
-            if (car == gCurrentVehicle)
-            {
-                break;
-            }
-            spriteId = car->prev_vehicle_on_ride;
-        }
+        return !car->HasFlag(VehicleFlags::MoveSingleCar);
+    };
+
+    const bool completed = backwards ? std::all_of(cars.rbegin(), cars.rend(), updateCar)
+                                     : std::all_of(cars.begin(), cars.end(), updateCar);
+    if (!completed)
+    {
+        if (outStation != nullptr)
+            *outStation = _vehicleStationIndex.ToUnderlying();
+        return _vehicleMotionTrackFlags;
     }
-    // Loc6DC144
-    vehicle = gCurrentVehicle;
 
-    carEntry = vehicle->Entry();
+    // Loc6DC144
+    carEntry = Entry();
     // eax
     int32_t totalAcceleration = 0;
     // ebp
     int32_t totalMass = 0;
     // ebx
-    int32_t numVehicles = 0;
+    const auto numVehicles = static_cast<int32_t>(cars.size());
 
-    for (; vehicle != nullptr; vehicle = GetEntity<Vehicle>(vehicle->next_vehicle_on_train))
+    for (const auto* car : cars)
     {
-        numVehicles++;
-        totalMass += vehicle->mass;
-        totalAcceleration += vehicle->acceleration;
+        totalMass += car->mass;
+        totalAcceleration += car->acceleration;
     }
 
-    vehicle = gCurrentVehicle;
+    Vehicle* vehicle = this;
     int32_t newAcceleration = (totalAcceleration / numVehicles) * 21;
     if (newAcceleration < 0)
     {
@@ -288,7 +288,7 @@ private:
     void CableLiftUpdateDeparting();
     void CableLiftUpdateTravelling();
     void CableLiftUpdateArriving();
-    void Sub6DBF3E();
+    void Sub6DBF3E(const CarEntry* carEntry);
     void UpdateMeasurements();
     void UpdateMovingToEndOfStation();
     void UpdateWaitingForPassengers();
@@ -280,7 +280,8 @@ void ScenarioAutosaveCheck()
             break;
     }
 
-    if (shouldSave)
+    // Retried every tick until the previous autosave has been written.
+    if (shouldSave && !ScenarioIsAutosaveInProgress())
     {
         gLastAutoSaveUpdate = kAutosavePause;
         GameAutosave();
@@ -173,6 +173,10 @@ uint32_t ScenarioRandMax(uint32_t max);
 
 ResultWithMessage ScenarioPrepareForSave(OpenRCT2::GameState_t& gameState);
 int32_t ScenarioSave(OpenRCT2::GameState_t& gameState, u8string_view path, int32_t flags);
+// Serialises the park straight away, compressing and writing the file is done in the background.
+bool ScenarioAutosave(OpenRCT2::GameState_t& gameState, u8string_view path);
+bool ScenarioIsAutosaveInProgress();
+void ScenarioWaitForAutosave();
 void ScenarioFailure(OpenRCT2::GameState_t& gameState);
 void ScenarioSuccess(OpenRCT2::GameState_t& gameState);
 void ScenarioSuccessSubmitName(OpenRCT2::GameState_t& gameState, const char* name);
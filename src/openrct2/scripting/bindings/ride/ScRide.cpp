@@ -14,6 +14,7 @@
 #    include "../../../Context.h"
 #    include "../../../ride/Ride.h"
 #    include "../../../ride/RideData.h"
+#    include "../../../ride/RideOccupancy.h"
 #    include "../../Duktape.hpp"
 #    include "../../ScriptEngine.h"
 #    include "../object/ScObject.hpp"
@@ -341,6 +342,7 @@ namespace OpenRCT2::Scripting
         if (ride != nullptr)
         {
             ride->ratings.excitement = value;
+            RideOccupancy::InvalidateTallRides();
         }
     }
 
@@ -17,6 +17,7 @@
 #    include "../../../object/LargeSceneryEntry.h"
 #    include "../../../ride/Track.h"
 #    include "../../../world/Footpath.h"
+#    include "../../../world/Map.h"
 #    include "../../../world/Scenery.h"
 #    include "../../../world/Surface.h"
 #    include "../../Duktape.hpp"
@@ -80,6 +81,16 @@ namespace OpenRCT2::Scripting
         return DukValue::take_from_stack(ctx);
     }
 
+    static void RecordElementsChanged(const CoordsXY& coords)
+    {
+        for (const auto* element = MapGetFirstElementAt(coords); element != nullptr;)
+        {
+            MapRecordTileElementChanged(element);
+            if ((element++)->IsLastForTile())
+                break;
+        }
+    }
+
     void ScTile::data_set(DukValue value)
     {
         ThrowIfGameStateNotMutable();
@@ -90,6 +101,9 @@ namespace OpenRCT2::Scripting
             duk_size_t dataLen{};
             auto data = duk_get_buffer_data(ctx, -1, &dataLen);
             auto numElements = dataLen / sizeof(TileElement);
+
+            // Listeners filter by element type, so the elements that are overwritten are recorded too.
+            RecordElementsChanged(_coords);
             if (numElements == 0)
             {
                 MapSetTileElement(TileCoordsXY(_coords), nullptr);
@@ -125,7 +139,9 @@ namespace OpenRCT2::Scripting
                     first[numElements - 1].SetLastForTile(true);
                 }
             }
+            RecordElementsChanged(_coords);
             MapInvalidateTileFull(_coords);
+            MapInvalidateElementCaches();
         }
     }
 
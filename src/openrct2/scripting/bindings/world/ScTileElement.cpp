@@ -20,6 +20,7 @@
 #    include "../../../ride/RideData.h"
 #    include "../../../ride/Track.h"
 #    include "../../../world/Footpath.h"
+#    include "../../../world/Map.h"
 #    include "../../../world/Scenery.h"
 #    include "../../../world/Surface.h"
 #    include "../../../world/tile_element/BannerElement.h"
@@ -2149,7 +2150,9 @@ namespace OpenRCT2::Scripting
 
     void ScTileElement::Invalidate()
     {
+        MapRecordTileElementChanged(_element);
         MapInvalidateTileFull(_coords);
+        MapInvalidateElementCaches();
     }
 
     const LargeSceneryElement* ScTileElement::GetOtherLargeSceneryElement(
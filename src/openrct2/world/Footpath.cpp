@@ -37,7 +37,9 @@
 #include "Map.h"
 #include "MapAnimation.h"
 #include "Surface.h"
+#include "TileChanges.h"
 #include "TileElement.h"
+#include "TileElementsView.h"
 #include "tile_element/BannerElement.h"
 #include "tile_element/EntranceElement.h"
 #include "tile_element/Slope.h"
@@ -45,6 +47,7 @@
 
 #include <bit>
 #include <iterator>
+#include <optional>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::TrackMetaData;
@@ -1249,6 +1252,7 @@ void PathElement::SetSloped(bool isSloped)
     Flags2 &= ~FOOTPATH_ELEMENT_FLAGS2_IS_SLOPED;
     if (isSloped)
         Flags2 |= FOOTPATH_ELEMENT_FLAGS2_IS_SLOPED;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 bool PathElement::HasJunctionRailings() const
@@ -1271,6 +1275,7 @@ Direction PathElement::GetSlopeDirection() const
 void PathElement::SetSlopeDirection(Direction newSlope)
 {
     SlopeDirection = newSlope;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 bool PathElement::IsQueue() const
@@ -1283,6 +1288,7 @@ void PathElement::SetIsQueue(bool isQueue)
     Type &= ~FOOTPATH_ELEMENT_TYPE_FLAG_IS_QUEUE;
     if (isQueue)
         Type |= FOOTPATH_ELEMENT_TYPE_FLAG_IS_QUEUE;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 bool PathElement::HasQueueBanner() const
@@ -1339,6 +1345,7 @@ void PathElement::SetIsBlockedByVehicle(bool isBlocked)
 void PathElement::SetStationIndex(::StationIndex newStationIndex)
 {
     StationIndex = newStationIndex;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 bool PathElement::IsWide() const
@@ -1571,6 +1578,24 @@ static TileElement* FootpathCanBeWide(const CoordsXYZ& footpathPos)
     return nullptr;
 }
 
+// Returns which of the first 64 paths on the tile are wide, or nothing if the tile has more paths.
+static std::optional<uint64_t> FootpathGetWideFlags(const CoordsXY& footpathPos)
+{
+    uint64_t wideFlags = 0;
+    size_t index = 0;
+    for (auto* pathElement : TileElementsView<PathElement>(footpathPos))
+    {
+        if (index >= 64)
+            return std::nullopt;
+        if (pathElement->IsWide())
+            wideFlags |= 1ULL << index;
+        index++;
+    }
+    return wideFlags;
+}
+
+static void FootpathSetWideFlags(const CoordsXY& footpathPos);
+
 /**
  *
  *  rct2: 0x006A87BB
@@ -1580,6 +1605,20 @@ void FootpathUpdatePathWideFlags(const CoordsXY& footpathPos)
     if (MapIsLocationAtEdge(footpathPos))
         return;
 
+    // The flags are cleared and set again, usually to what they were before.
+    const auto wideFlags = FootpathGetWideFlags(footpathPos);
+    FootpathSetWideFlags(footpathPos);
+    const auto newWideFlags = FootpathGetWideFlags(footpathPos);
+    if (!wideFlags.has_value() || !newWideFlags.has_value() || *wideFlags != *newWideFlags)
+    {
+        // Wide flags are set on every path now and then, so only a change is recorded.
+        TileChanges::Record(TileCoordsXY{ footpathPos }, TileElementType::Path, TileChanges::ChangeKind::Modified);
+        MapInvalidateElementCaches();
+    }
+}
+
+static void FootpathSetWideFlags(const CoordsXY& footpathPos)
+{
     FootpathClearWide(footpathPos);
     /* Rather than clearing the wide flag of the following tiles and
      * checking the state of them later, leave them intact and assume
@@ -2266,6 +2305,7 @@ RideId PathElement::GetRideIndex() const
 void PathElement::SetRideIndex(RideId newRideIndex)
 {
     rideIndex = newRideIndex;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 uint8_t PathElement::GetAdditionStatus() const
@@ -2287,6 +2327,7 @@ void PathElement::SetEdges(uint8_t newEdges)
 {
     EdgesAndCorners &= ~FOOTPATH_PROPERTIES_EDGES_EDGES_MASK;
     EdgesAndCorners |= (newEdges & FOOTPATH_PROPERTIES_EDGES_EDGES_MASK);
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 uint8_t PathElement::GetCorners() const
@@ -2298,6 +2339,7 @@ void PathElement::SetCorners(uint8_t newCorners)
 {
     EdgesAndCorners &= ~FOOTPATH_PROPERTIES_EDGES_CORNERS_MASK;
     EdgesAndCorners |= (newCorners << 4);
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 uint8_t PathElement::GetEdgesAndCorners() const
@@ -2308,6 +2350,7 @@ uint8_t PathElement::GetEdgesAndCorners() const
 void PathElement::SetEdgesAndCorners(uint8_t newEdgesAndCorners)
 {
     EdgesAndCorners = newEdgesAndCorners;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 bool PathElement::IsLevelCrossing(const CoordsXY& coords) const
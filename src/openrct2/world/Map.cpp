@@ -38,6 +38,7 @@
 #include "../object/SmallSceneryEntry.h"
 #include "../object/TerrainSurfaceObject.h"
 #include "../profiling/Profiling.h"
+#include "../ride/Ride.h"
 #include "../ride/RideConstruction.h"
 #include "../ride/RideData.h"
 #include "../ride/Track.h"
@@ -55,6 +56,7 @@
 #include "Park.h"
 #include "Scenery.h"
 #include "Surface.h"
+#include "TileChanges.h"
 #include "TileElementsView.h"
 #include "TileInspector.h"
 #include "tile_element/BannerElement.h"
@@ -62,8 +64,12 @@
 #include "tile_element/Slope.h"
 #include "tile_element/TrackElement.h"
 
+#include <algorithm>
+#include <array>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <optional>
 
 using namespace OpenRCT2;
 
@@ -110,6 +116,41 @@ static size_t _tileElementsInUse;
 static size_t _tileElementsInUseStash;
 static TileCoordsXY _mapSizeStash;
 
+// Tiles outside of the stored map that were temporarily given elements, such as for the track piece previews.
+static std::vector<std::pair<TileCoordsXY, TileElement*>> _tilesOutsideIndex;
+
+// The tile each slot of the tile element array belongs to. Runs of slots that are no longer used by any tile are kept
+// in lists by their length so inserts can reuse them rather than append, a free slot directly after a tile lets that
+// tile grow in place. The lists are not updated when a tile grows into one of their slots, blocks are therefore checked
+// again before use.
+struct TileElementSlots
+{
+    struct Block
+    {
+        uint32_t Start{};
+        uint32_t Length{};
+    };
+
+    static constexpr uint32_t kFreeSlot = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t kLargestSizeClass = 16;
+
+    std::vector<uint32_t> Tiles;
+    std::array<std::vector<Block>, kLargestSizeClass + 1> FreeBlocks;
+    size_t NumFree{};
+
+    // Set while the map is being compacted, slots before the cursor have been compacted already.
+    bool Compacting{};
+    size_t CompactionCursor{};
+};
+
+static TileElementSlots _slots;
+static TileElementSlots _slotsStash;
+
+// The map is only compacted once this many slots are free and they make up a quarter of the array.
+static constexpr size_t kCompactionMinFreeElements = 0x4000;
+// Number of slots a compaction step looks at or moves, so each tick only does a small part of the work.
+static constexpr size_t kCompactionSlotsPerStep = 0x1000;
+
 void StashMap()
 {
     auto& gameState = GetGameState();
@@ -117,6 +158,9 @@ void StashMap()
     _tileElementsStash = std::move(gameState.TileElements);
     _mapSizeStash = gameState.MapSize;
     _tileElementsInUseStash = _tileElementsInUse;
+    _slotsStash = std::move(_slots);
+    TileChanges::RecordAllTilesChanged();
+    MapInvalidateElementCaches();
 }
 
 void UnstashMap()
@@ -126,6 +170,9 @@ void UnstashMap()
     gameState.TileElements = std::move(_tileElementsStash);
     gameState.MapSize = _mapSizeStash;
     _tileElementsInUse = _tileElementsInUseStash;
+    _slots = std::move(_slotsStash);
+    TileChanges::RecordAllTilesChanged();
+    MapInvalidateElementCaches();
 }
 
 CoordsXY GetMapSizeUnits()
@@ -149,12 +196,39 @@ const std::vector<TileElement>& GetTileElements()
     return GetGameState().TileElements;
 }
 
-void SetTileElements(GameState_t& gameState, std::vector<TileElement>&& tileElements)
+static void StoreTileElements(GameState_t& gameState, std::vector<TileElement>&& tileElements, const TileCoordsXY& size)
 {
     gameState.TileElements = std::move(tileElements);
-    _tileIndex = TilePointerIndex<TileElement>(
-        kMaximumMapSizeTechnical, gameState.TileElements.data(), gameState.TileElements.size());
-    _tileElementsInUse = gameState.TileElements.size();
+    _tileIndex = TilePointerIndex<TileElement>(size, gameState.TileElements.data(), gameState.TileElements.size());
+
+    _slots = {};
+    _slots.Tiles.assign(gameState.TileElements.size(), TileElementSlots::kFreeSlot);
+    for (int32_t y = 0; y < size.y; y++)
+    {
+        for (int32_t x = 0; x < size.x; x++)
+        {
+            const auto* element = _tileIndex.GetFirstElementAt({ x, y });
+            if (element == nullptr)
+                continue;
+
+            auto slot = static_cast<size_t>(element - gameState.TileElements.data());
+            do
+            {
+                _slots.Tiles[slot++] = static_cast<uint32_t>(y * size.x + x);
+            } while (!(element++)->IsLastForTile());
+        }
+    }
+    _slots.NumFree = std::count(_slots.Tiles.begin(), _slots.Tiles.end(), TileElementSlots::kFreeSlot);
+    _tileElementsInUse = gameState.TileElements.size() - _slots.NumFree;
+
+    // Elements moved even when the tiles did not change, which matters to caches that point at them.
+    TileChanges::RecordAllTilesChanged();
+    MapInvalidateElementCaches();
+}
+
+void SetTileElements(GameState_t& gameState, std::vector<TileElement>&& tileElements)
+{
+    StoreTileElements(gameState, std::move(tileElements), gameState.MapSize);
 }
 
 static TileElement GetDefaultSurfaceElement()
@@ -174,13 +248,49 @@ static TileElement GetDefaultSurfaceElement()
     return el;
 }
 
+// Copies the tiles of the index into a layout for a map of the given size, tiles not covered by the index get a default
+// surface element.
+static std::vector<TileElement> GetTileElementsForSize(
+    TilePointerIndex<TileElement>& index, const TileCoordsXY& size, size_t capacity)
+{
+    std::vector<TileElement> newElements;
+    newElements.reserve(std::max(MIN_TILE_ELEMENTS, capacity));
+    for (int32_t y = 0; y < size.y; y++)
+    {
+        for (int32_t x = 0; x < size.x; x++)
+        {
+            const auto coords = TileCoordsXY{ x, y };
+            const auto* element = index.Contains(coords) ? index.GetFirstElementAt(coords) : nullptr;
+            if (element == nullptr)
+            {
+                newElements.push_back(GetDefaultSurfaceElement());
+            }
+            else
+            {
+                do
+                {
+                    newElements.push_back(*element);
+                } while (!(element++)->IsLastForTile());
+            }
+        }
+    }
+    return newElements;
+}
+
+void SetTileElements(GameState_t& gameState, std::vector<TileElement>&& tileElements, const TileCoordsXY& layoutSize)
+{
+    auto layout = TilePointerIndex<TileElement>(layoutSize, tileElements.data(), tileElements.size());
+    StoreTileElements(gameState, GetTileElementsForSize(layout, gameState.MapSize, 0), gameState.MapSize);
+}
+
 std::vector<TileElement> GetReorganisedTileElementsWithoutGhosts()
 {
     std::vector<TileElement> newElements;
     newElements.reserve(std::max(MIN_TILE_ELEMENTS, GetGameState().TileElements.size()));
-    for (int32_t y = 0; y < kMaximumMapSizeTechnical; y++)
+    const auto size = _tileIndex.GetSize();
+    for (int32_t y = 0; y < size.y; y++)
     {
-        for (int32_t x = 0; x < kMaximumMapSizeTechnical; x++)
+        for (int32_t x = 0; x < size.x; x++)
         {
             auto oldSize = newElements.size();
 
@@ -212,32 +322,116 @@ std::vector<TileElement> GetReorganisedTileElementsWithoutGhosts()
     return newElements;
 }
 
-static void ReorganiseTileElements(GameState_t& gameState, size_t capacity)
+static size_t GetFreeBlockSizeClass(size_t length)
 {
-    ContextSetCurrentCursor(CursorID::ZZZ);
+    return std::min(length, TileElementSlots::kLargestSizeClass);
+}
 
-    std::vector<TileElement> newElements;
-    newElements.reserve(std::max(MIN_TILE_ELEMENTS, capacity));
-    for (int32_t y = 0; y < kMaximumMapSizeTechnical; y++)
+static uint32_t GetSlotTile(const TileCoordsXY& coords)
+{
+    return static_cast<uint32_t>(coords.y * _tileIndex.GetSize().x + coords.x);
+}
+
+// Elements that are not part of the tile element array, such as those of the track previews, have no slot.
+static std::optional<size_t> GetElementSlot(const TileElement* element)
+{
+    const auto& tileElements = GetGameState().TileElements;
+    if (tileElements.empty() || element < tileElements.data() || element >= tileElements.data() + tileElements.size())
+        return std::nullopt;
+    return static_cast<size_t>(element - tileElements.data());
+}
+
+static TileCoordsXY GetSlotCoords(size_t slot)
+{
+    const auto tile = _slots.Tiles[slot];
+    const auto width = static_cast<uint32_t>(_tileIndex.GetSize().x);
+    return { static_cast<int32_t>(tile % width), static_cast<int32_t>(tile / width) };
+}
+
+void MapRecordTileElementChanged(const TileElement* element)
+{
+    const auto slot = GetElementSlot(element);
+    if (slot.has_value() && _slots.Tiles[*slot] != TileElementSlots::kFreeSlot)
     {
-        for (int32_t x = 0; x < kMaximumMapSizeTechnical; x++)
+        TileChanges::Record(GetSlotCoords(*slot), element->GetType(), TileChanges::ChangeKind::Modified);
+    }
+}
+
+static bool IsFreeBlockValid(const TileElementSlots::Block& block)
+{
+    const auto& tiles = _slots.Tiles;
+    if (block.Start + block.Length > tiles.size())
+        return false;
+    return std::all_of(tiles.begin() + block.Start, tiles.begin() + block.Start + block.Length, [](uint32_t tile) {
+        return tile == TileElementSlots::kFreeSlot;
+    });
+}
+
+static void AddFreeBlock(size_t start, size_t length)
+{
+    std::fill_n(_slots.Tiles.begin() + start, length, TileElementSlots::kFreeSlot);
+    _slots.NumFree += length;
+
+    // A single slot is only of use to the tile in front of it.
+    if (length >= 2)
+    {
+        _slots.FreeBlocks[GetFreeBlockSizeClass(length)].push_back(
+            { static_cast<uint32_t>(start), static_cast<uint32_t>(length) });
+    }
+}
+
+// Finds a free block of at least the given length, dropping blocks that have been taken since they were added.
+static std::optional<std::pair<size_t, size_t>> FindFreeBlock(size_t length)
+{
+    for (auto sizeClass = GetFreeBlockSizeClass(length); sizeClass <= TileElementSlots::kLargestSizeClass; sizeClass++)
+    {
+        auto& blocks = _slots.FreeBlocks[sizeClass];
+        for (auto i = blocks.size(); i-- > 0;)
         {
-            const auto* element = MapGetFirstElementAt(TileCoordsXY{ x, y });
-            if (element == nullptr)
+            if (!IsFreeBlockValid(blocks[i]))
             {
-                newElements.push_back(GetDefaultSurfaceElement());
+                blocks[i] = blocks.back();
+                blocks.pop_back();
             }
-            else
+            else if (blocks[i].Length >= length)
             {
-                do
-                {
-                    newElements.push_back(*element);
-                } while (!(element++)->IsLastForTile());
+                return std::make_pair(sizeClass, i);
             }
         }
     }
+    return std::nullopt;
+}
 
-    SetTileElements(gameState, std::move(newElements));
+static TileElement* TakeFreeBlock(size_t length, uint32_t tile)
+{
+    const auto found = FindFreeBlock(length);
+    if (!found.has_value())
+        return nullptr;
+
+    auto& blocks = _slots.FreeBlocks[found->first];
+    const auto block = blocks[found->second];
+    blocks[found->second] = blocks.back();
+    blocks.pop_back();
+
+    std::fill_n(_slots.Tiles.begin() + block.Start, length, tile);
+    _slots.NumFree -= length;
+
+    // The rest of the block stays free, the first slot of it being room for the new tile to grow into.
+    const auto remaining = block.Length - length;
+    if (remaining >= 2)
+    {
+        _slots.FreeBlocks[GetFreeBlockSizeClass(remaining)].push_back(
+            { static_cast<uint32_t>(block.Start + length), static_cast<uint32_t>(remaining) });
+    }
+    return &GetGameState().TileElements[block.Start];
+}
+
+static void ReorganiseTileElements(GameState_t& gameState, size_t capacity)
+{
+    ContextSetCurrentCursor(CursorID::ZZZ);
+
+    const auto size = _tileIndex.GetSize();
+    StoreTileElements(gameState, GetTileElementsForSize(_tileIndex, size, capacity), size);
 }
 
 static void ReorganiseTileElements(size_t capacity)
@@ -252,6 +446,100 @@ void ReorganiseTileElements()
     ReorganiseTileElements(gameState, gameState.TileElements.size());
 }
 
+void ResizeTileElements(const TileCoordsXY& size)
+{
+    if (size == _tileIndex.GetSize())
+        return;
+
+    auto& gameState = GetGameState();
+    StoreTileElements(gameState, GetTileElementsForSize(_tileIndex, size, gameState.TileElements.size()), size);
+}
+
+static void RecordTileElements(const TileCoordsXY& tilePos, const TileElement* element, TileChanges::ChangeKind kind);
+
+// Slides the tiles after the cursor down over the unused slots in front of them, keeping their order.
+void MapCompactTileElementsStep()
+{
+    auto& gameState = GetGameState();
+    auto& tileElements = gameState.TileElements;
+    if (!_slots.Compacting)
+    {
+        const auto numFree = _slots.NumFree;
+        if (numFree < kCompactionMinFreeElements || numFree * 4 < tileElements.size())
+            return;
+
+        _slots.Compacting = true;
+        _slots.CompactionCursor = 0;
+    }
+
+    auto& tiles = _slots.Tiles;
+    // Removing the last elements of the array may have moved the end before the cursor.
+    auto slot = std::min(_slots.CompactionCursor, tiles.size());
+    size_t budget = kCompactionSlotsPerStep;
+    bool moved = false;
+    while (budget > 0)
+    {
+        while (slot < tiles.size() && tiles[slot] != TileElementSlots::kFreeSlot && budget > 0)
+        {
+            slot++;
+            budget--;
+        }
+        const auto gapStart = slot;
+        while (slot < tiles.size() && tiles[slot] == TileElementSlots::kFreeSlot)
+        {
+            slot++;
+        }
+
+        if (slot == tiles.size())
+        {
+            // Everything after the gap has been moved down, release the unused slots at the end.
+            _slots.NumFree -= tiles.size() - gapStart;
+            tileElements.resize(gapStart);
+            tiles.resize(gapStart);
+            for (auto& blocks : _slots.FreeBlocks)
+            {
+                std::erase_if(blocks, [](const TileElementSlots::Block& block) { return !IsFreeBlockValid(block); });
+            }
+            _slots.Compacting = false;
+            break;
+        }
+        if (gapStart == slot)
+        {
+            break;
+        }
+
+        const auto tile = tiles[slot];
+        const auto coords = GetSlotCoords(slot);
+        size_t length = 0;
+        while (slot + length < tiles.size() && tiles[slot + length] == tile)
+        {
+            length++;
+        }
+
+        // Caches that point at the elements have to forget them, as if the tile was removed and inserted again.
+        RecordTileElements(coords, &tileElements[slot], TileChanges::ChangeKind::Removed);
+        std::copy_n(tileElements.begin() + slot, length, tileElements.begin() + gapStart);
+        std::fill_n(tiles.begin() + gapStart, length, tile);
+        for (auto i = std::max(gapStart + length, slot); i < slot + length; i++)
+        {
+            tileElements[i].BaseHeight = MAX_ELEMENT_HEIGHT;
+            tiles[i] = TileElementSlots::kFreeSlot;
+        }
+        _tileIndex.SetTile(coords, &tileElements[gapStart]);
+        RecordTileElements(coords, &tileElements[gapStart], TileChanges::ChangeKind::Inserted);
+        moved = true;
+
+        slot = gapStart + length;
+        budget -= std::min(budget, length);
+    }
+    _slots.CompactionCursor = slot;
+
+    if (moved)
+    {
+        MapInvalidateElementCaches();
+    }
+}
+
 static bool MapCheckFreeElementsAndReorganise(size_t numElementsOnTile, size_t numNewElements)
 {
     // Check hard cap on num in use tiles (this would be the size of _tileElements immediately after a reorg)
@@ -263,7 +551,7 @@ static bool MapCheckFreeElementsAndReorganise(size_t numElementsOnTile, size_t n
     auto& gameState = GetGameState();
     auto totalElementsRequired = numElementsOnTile + numNewElements;
     auto freeElements = gameState.TileElements.capacity() - gameState.TileElements.size();
-    if (freeElements >= totalElementsRequired)
+    if (freeElements >= totalElementsRequired || FindFreeBlock(totalElementsRequired).has_value())
     {
         return true;
     }
@@ -348,13 +636,24 @@ static bool IsTileLocationValid(const TileCoordsXY& coords)
     return is_x_valid && is_y_valid;
 }
 
-TileElement* MapGetFirstElementAt(const TileCoordsXY& tilePos)
+static TileElement* GetFirstElementOutsideIndex(const TileCoordsXY& tilePos)
 {
     if (!IsTileLocationValid(tilePos))
     {
         LOG_VERBOSE("Trying to access element outside of range");
         return nullptr;
     }
+    auto it = std::find_if(
+        _tilesOutsideIndex.begin(), _tilesOutsideIndex.end(), [&tilePos](const auto& tile) { return tile.first == tilePos; });
+    return it != _tilesOutsideIndex.end() ? it->second : nullptr;
+}
+
+TileElement* MapGetFirstElementAt(const TileCoordsXY& tilePos)
+{
+    if (!_tileIndex.Contains(tilePos))
+    {
+        return GetFirstElementOutsideIndex(tilePos);
+    }
     return _tileIndex.GetFirstElementAt(tilePos);
 }
 
@@ -406,6 +705,22 @@ TileElement* MapGetFirstTileElementWithBaseHeightBetween(const TileCoordsXYRange
     return nullptr;
 }
 
+void MapInvalidateElementCaches()
+{
+    TileChanges::Publish();
+}
+
+static void RecordTileElements(const TileCoordsXY& tilePos, const TileElement* element, TileChanges::ChangeKind kind)
+{
+    if (element == nullptr)
+        return;
+
+    do
+    {
+        TileChanges::Record(tilePos, element->GetType(), kind);
+    } while (!(element++)->IsLastForTile());
+}
+
 void MapSetTileElement(const TileCoordsXY& tilePos, TileElement* elements)
 {
     if (!MapIsLocationValid(tilePos.ToCoordsXY()))
@@ -413,7 +728,31 @@ void MapSetTileElement(const TileCoordsXY& tilePos, TileElement* elements)
         LOG_ERROR("Trying to access element outside of range");
         return;
     }
+    if (!_tileIndex.Contains(tilePos))
+    {
+        // Nothing derived from the map covers these tiles.
+        std::erase_if(_tilesOutsideIndex, [&tilePos](const auto& tile) { return tile.first == tilePos; });
+        if (elements != nullptr)
+        {
+            _tilesOutsideIndex.emplace_back(tilePos, elements);
+        }
+        return;
+    }
+
+    auto* previousElements = _tileIndex.GetFirstElementAt(tilePos);
     _tileIndex.SetTile(tilePos, elements);
+
+    // Elements that are not part of the map are swapped in temporarily, such as to draw the track construction preview,
+    // and swapped out again before anything reads the caches.
+    const auto isTemporary = [](const TileElement* tileElements) {
+        return tileElements != nullptr && !GetElementSlot(tileElements).has_value();
+    };
+    if (isTemporary(previousElements) || isTemporary(elements))
+        return;
+
+    RecordTileElements(tilePos, previousElements, TileChanges::ChangeKind::Removed);
+    RecordTileElements(tilePos, elements, TileChanges::ChangeKind::Inserted);
+    MapInvalidateElementCaches();
 }
 
 SurfaceElement* MapGetSurfaceElementAt(const TileCoordsXY& coords)
@@ -461,14 +800,14 @@ BannerElement* MapGetBannerElementAt(const CoordsXYZ& bannerPos, uint8_t positio
  */
 void MapInit(const TileCoordsXY& size)
 {
-    auto numTiles = kMaximumMapSizeTechnical * kMaximumMapSizeTechnical;
+    auto numTiles = static_cast<size_t>(size.x) * size.y;
 
     auto& gameState = GetGameState();
+    gameState.MapSize = size;
     SetTileElements(gameState, std::vector<TileElement>(numTiles, GetDefaultSurfaceElement()));
 
     gameState.GrassSceneryTileLoopPosition = 0;
     gameState.WidePathTileLoopPosition = {};
-    gameState.MapSize = size;
     MapRemoveOutOfRangeElements();
     ClearMapAnimations();
 
@@ -530,10 +869,12 @@ void MapCountRemainingLandRights()
 void MapStripGhostFlagFromElements()
 {
     auto& gameState = GetGameState();
+    TileChanges::RecordAllTilesChanged();
     for (auto& element : gameState.TileElements)
     {
         element.SetGhost(false);
     }
+    MapInvalidateElementCaches();
 }
 
 /**
@@ -1024,6 +1365,13 @@ bool MapIsLocationAtEdge(const CoordsXY& loc)
  */
 void TileElementRemove(TileElement* tileElement)
 {
+    const auto slot = GetElementSlot(tileElement);
+    if (slot.has_value())
+    {
+        TileChanges::Record(GetSlotCoords(*slot), tileElement->GetType(), TileChanges::ChangeKind::Removed);
+        MapInvalidateElementCaches();
+    }
+
     // Replace Nth element by (N+1)th element.
     // This loop will make tileElement point to the old last element position,
     // after copy it to it's new position
@@ -1040,9 +1388,20 @@ void TileElementRemove(TileElement* tileElement)
     tileElement->BaseHeight = MAX_ELEMENT_HEIGHT;
     _tileElementsInUse--;
     auto& gameState = GetGameState();
+    if (!slot.has_value())
+    {
+        return;
+    }
     if (tileElement == &gameState.TileElements.back())
     {
         gameState.TileElements.pop_back();
+        _slots.Tiles.pop_back();
+    }
+    else
+    {
+        // Left as room for the tile to grow back into.
+        _slots.Tiles[tileElement - gameState.TileElements.data()] = TileElementSlots::kFreeSlot;
+        _slots.NumFree++;
     }
 }
 
@@ -1151,7 +1510,9 @@ void MapInvalidateSelectionRect()
 static size_t CountElementsOnTile(const CoordsXY& loc)
 {
     size_t count = 0;
-    auto* element = _tileIndex.GetFirstElementAt(TileCoordsXY(loc));
+    auto* element = MapGetFirstElementAt(loc);
+    if (element == nullptr)
+        return count;
     do
     {
         count++;
@@ -1159,21 +1520,78 @@ static size_t CountElementsOnTile(const CoordsXY& loc)
     return count;
 }
 
-static TileElement* AllocateTileElements(size_t numElementsOnTile, size_t numNewElements)
+static TileElement* AllocateTileElements(size_t numElementsOnTile, size_t numNewElements, uint32_t tile)
 {
+    auto totalElementsRequired = numElementsOnTile + numNewElements;
+    if (_tileElementsInUse + numNewElements <= MAX_TILE_ELEMENTS)
+    {
+        auto* block = TakeFreeBlock(totalElementsRequired, tile);
+        if (block != nullptr)
+        {
+            _tileElementsInUse += numNewElements;
+            return block;
+        }
+    }
+
     if (!MapCheckFreeElementsAndReorganise(numElementsOnTile, numNewElements))
     {
         LOG_ERROR("Cannot insert new element");
         return nullptr;
     }
 
+    // The check may have found a free block rather than room at the end.
+    auto* block = TakeFreeBlock(totalElementsRequired, tile);
+    if (block != nullptr)
+    {
+        _tileElementsInUse += numNewElements;
+        return block;
+    }
+
     auto& gameState = GetGameState();
     auto oldSize = gameState.TileElements.size();
-    gameState.TileElements.resize(gameState.TileElements.size() + numElementsOnTile + numNewElements);
+    gameState.TileElements.resize(oldSize + totalElementsRequired);
+    _slots.Tiles.resize(oldSize + totalElementsRequired, tile);
     _tileElementsInUse += numNewElements;
+
+    // Leave a slot after the tile for it to grow into if that does not require more capacity.
+    if (gameState.TileElements.capacity() > gameState.TileElements.size())
+    {
+        gameState.TileElements.emplace_back().BaseHeight = MAX_ELEMENT_HEIGHT;
+        _slots.Tiles.push_back(TileElementSlots::kFreeSlot);
+        _slots.NumFree++;
+    }
     return &gameState.TileElements[oldSize];
 }
 
+// Takes the slot after the elements of a tile if it is free, so the tile can grow without being moved.
+static bool GrowTileInPlace(const TileElement* firstElement, size_t numElementsOnTile, uint32_t tile)
+{
+    const auto firstSlot = GetElementSlot(firstElement);
+    if (!firstSlot.has_value() || _tileElementsInUse + 1 > MAX_TILE_ELEMENTS)
+        return false;
+
+    auto& tileElements = GetGameState().TileElements;
+    const auto next = *firstSlot + numElementsOnTile;
+    if (next == tileElements.size())
+    {
+        if (tileElements.capacity() == tileElements.size())
+            return false;
+        tileElements.emplace_back();
+        _slots.Tiles.push_back(tile);
+    }
+    else if (_slots.Tiles[next] == TileElementSlots::kFreeSlot)
+    {
+        _slots.Tiles[next] = tile;
+        _slots.NumFree--;
+    }
+    else
+    {
+        return false;
+    }
+    _tileElementsInUse++;
+    return true;
+}
+
 /**
  *
  *  rct2: 0x0068B1F6
@@ -1181,70 +1599,74 @@ static TileElement* AllocateTileElements(size_t numElementsOnTile, size_t numNew
 TileElement* TileElementInsert(const CoordsXYZ& loc, int32_t occupiedQuadrants, TileElementType type)
 {
     const auto& tileLoc = TileCoordsXYZ(loc);
-
-    auto numElementsOnTileOld = CountElementsOnTile(loc);
-    auto* newTileElement = AllocateTileElements(numElementsOnTileOld, 1);
-    auto* originalTileElement = _tileIndex.GetFirstElementAt(tileLoc);
-    if (newTileElement == nullptr)
+    if (!_tileIndex.Contains(tileLoc))
     {
+        LOG_ERROR("Cannot insert new element outside of the map");
         return nullptr;
     }
 
-    // Set tile index pointer to point to new element block
-    _tileIndex.SetTile(tileLoc, newTileElement);
+    TileChanges::Record(tileLoc, type, TileChanges::ChangeKind::Inserted);
+    MapInvalidateElementCaches();
 
-    bool isLastForTile = false;
-    if (originalTileElement == nullptr)
-    {
-        isLastForTile = true;
-    }
-    else
+    const auto tile = GetSlotTile(tileLoc);
+    auto numElementsOnTile = CountElementsOnTile(loc);
+    auto* tileElements = _tileIndex.GetFirstElementAt(tileLoc);
+    if (tileElements == nullptr || !GrowTileInPlace(tileElements, numElementsOnTile, tile))
     {
-        // Copy all elements that are below the insert height
-        while (loc.z >= originalTileElement->GetBaseZ())
+        auto* newTileElements = AllocateTileElements(numElementsOnTile, 1, tile);
+        if (newTileElements == nullptr)
         {
-            // Copy over map element
-            *newTileElement = *originalTileElement;
-            originalTileElement->BaseHeight = MAX_ELEMENT_HEIGHT;
-            originalTileElement++;
-            newTileElement++;
+            return nullptr;
+        }
 
-            if ((newTileElement - 1)->IsLastForTile())
+        // Allocating may have reorganised the map
+        auto* originalTileElements = _tileIndex.GetFirstElementAt(tileLoc);
+        if (originalTileElements != nullptr)
+        {
+            std::copy_n(originalTileElements, numElementsOnTile, newTileElements);
+            for (size_t i = 0; i < numElementsOnTile; i++)
             {
-                // No more elements above the insert element
-                (newTileElement - 1)->SetLastForTile(false);
-                isLastForTile = true;
-                break;
+                originalTileElements[i].BaseHeight = MAX_ELEMENT_HEIGHT;
+            }
+            const auto originalSlot = GetElementSlot(originalTileElements);
+            if (originalSlot.has_value())
+            {
+                AddFreeBlock(*originalSlot, numElementsOnTile);
             }
         }
+
+        // Set tile index pointer to point to new element block
+        _tileIndex.SetTile(tileLoc, newTileElements);
+        tileElements = newTileElements;
     }
 
-    // Insert new map element
-    auto* insertedElement = newTileElement;
-    newTileElement->Type = 0;
-    newTileElement->SetType(type);
-    newTileElement->SetBaseZ(loc.z);
-    newTileElement->Flags = 0;
-    newTileElement->SetLastForTile(isLastForTile);
-    newTileElement->SetOccupiedQuadrants(occupiedQuadrants);
-    newTileElement->SetClearanceZ(loc.z);
-    newTileElement->Owner = 0;
-    std::memset(&newTileElement->Pad05, 0, sizeof(newTileElement->Pad05));
-    std::memset(&newTileElement->Pad08, 0, sizeof(newTileElement->Pad08));
-    newTileElement++;
-
-    // Insert rest of map elements above insert height
-    if (!isLastForTile)
+    // Make room for the new element above all elements at or below the insert height
+    size_t insertIndex = 0;
+    while (insertIndex < numElementsOnTile && loc.z >= tileElements[insertIndex].GetBaseZ())
     {
-        do
-        {
-            // Copy over map element
-            *newTileElement = *originalTileElement;
-            originalTileElement->BaseHeight = MAX_ELEMENT_HEIGHT;
-            originalTileElement++;
-            newTileElement++;
-        } while (!((newTileElement - 1)->IsLastForTile()));
+        insertIndex++;
     }
+    std::move_backward(
+        tileElements + insertIndex, tileElements + numElementsOnTile, tileElements + numElementsOnTile + 1);
+
+    bool isLastForTile = insertIndex == numElementsOnTile;
+    if (isLastForTile && insertIndex > 0)
+    {
+        tileElements[insertIndex - 1].SetLastForTile(false);
+    }
+
+    // Insert new map element
+    auto* insertedElement = &tileElements[insertIndex];
+    // The type is set directly as the insert itself was recorded already.
+    insertedElement->Type = static_cast<uint8_t>((EnumValue(type) << 2) & kTileElementTypeMask);
+    insertedElement->SetBaseZ(loc.z);
+    insertedElement->Flags = 0;
+    insertedElement->SetLastForTile(isLastForTile);
+    insertedElement->SetOccupiedQuadrants(occupiedQuadrants);
+    insertedElement->SetClearanceZ(loc.z);
+    insertedElement->Owner = 0;
+    std::memset(&insertedElement->Pad05, 0, sizeof(insertedElement->Pad05));
+    std::memset(&insertedElement->Pad08, 0, sizeof(insertedElement->Pad08));
 
     return insertedElement;
 }
@@ -1318,9 +1740,10 @@ void MapRemoveOutOfRangeElements()
     bool buildState = gameState.Cheats.BuildInPauseMode;
     gameState.Cheats.BuildInPauseMode = true;
 
-    for (int32_t y = MAXIMUM_MAP_SIZE_BIG - kCoordsXYStep; y >= 0; y -= kCoordsXYStep)
+    const auto storedSize = _tileIndex.GetSize().ToCoordsXY();
+    for (int32_t y = storedSize.y - kCoordsXYStep; y >= 0; y -= kCoordsXYStep)
     {
-        for (int32_t x = MAXIMUM_MAP_SIZE_BIG - kCoordsXYStep; x >= 0; x -= kCoordsXYStep)
+        for (int32_t x = storedSize.x - kCoordsXYStep; x >= 0; x -= kCoordsXYStep)
         {
             if (x == 0 || y == 0 || x >= mapSizeMax.x || y >= mapSizeMax.y)
             {
@@ -1383,7 +1806,7 @@ static void MapExtendBoundarySurfaceExtendTile(const SurfaceElement& sourceTile,
 void MapExtendBoundarySurfaceY()
 {
     auto y = GetGameState().MapSize.y - 2;
-    for (auto x = 0; x < kMaximumMapSizeTechnical; x++)
+    for (auto x = 0; x < _tileIndex.GetSize().x; x++)
     {
         auto existingTileElement = MapGetSurfaceElementAt(TileCoordsXY{ x, y - 1 });
         auto newTileElement = MapGetSurfaceElementAt(TileCoordsXY{ x, y });
@@ -1403,7 +1826,7 @@ void MapExtendBoundarySurfaceY()
 void MapExtendBoundarySurfaceX()
 {
     auto x = GetGameState().MapSize.x - 2;
-    for (auto y = 0; y < kMaximumMapSizeTechnical; y++)
+    for (auto y = 0; y < _tileIndex.GetSize().y; y++)
     {
         auto existingTileElement = MapGetSurfaceElementAt(TileCoordsXY{ x - 1, y });
         auto newTileElement = MapGetSurfaceElementAt(TileCoordsXY{ x, y });
@@ -1870,9 +2293,10 @@ bool MapSurfaceIsBlocked(const CoordsXY& mapCoords)
 /* Clears all map elements, to be used before generating a new map */
 void MapClearAllElements()
 {
-    for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_BIG; y += kCoordsXYStep)
+    const auto storedSize = _tileIndex.GetSize().ToCoordsXY();
+    for (int32_t y = 0; y < storedSize.y; y += kCoordsXYStep)
     {
-        for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_BIG; x += kCoordsXYStep)
+        for (int32_t x = 0; x < storedSize.x; x += kCoordsXYStep)
         {
             ClearElementsAt({ x, y });
         }
@@ -2210,9 +2634,9 @@ void ShiftMap(const TileCoordsXY& amount)
 
     // Tile elements
     auto newElements = std::vector<TileElement>();
-    for (int32_t y = 0; y < kMaximumMapSizeTechnical; y++)
+    for (int32_t y = 0; y < gameState.MapSize.y; y++)
     {
-        for (int32_t x = 0; x < kMaximumMapSizeTechnical; x++)
+        for (int32_t x = 0; x < gameState.MapSize.x; x++)
         {
             auto srcX = x - amount.x;
             auto srcY = y - amount.y;
@@ -116,9 +116,17 @@ namespace OpenRCT2
     struct GameState_t;
 }
 
+// The tile elements are stored tile by tile, row by row, for the tiles of the map only.
 void ReorganiseTileElements();
+// Lays the tile elements out for a map of the given size, added tiles get a default surface. The map size is not changed.
+void ResizeTileElements(const TileCoordsXY& size);
+// Once too many tile elements are left unused by inserts and removals, moves a few tiles per call to close the gaps.
+void MapCompactTileElementsStep();
 const std::vector<TileElement>& GetTileElements();
 void SetTileElements(OpenRCT2::GameState_t& gameState, std::vector<TileElement>&& tileElements);
+// Takes tile elements laid out for a map of layoutSize and keeps the tiles that are within the map.
+void SetTileElements(
+    OpenRCT2::GameState_t& gameState, std::vector<TileElement>&& tileElements, const TileCoordsXY& layoutSize);
 void StashMap();
 void UnstashMap();
 std::vector<TileElement> GetReorganisedTileElementsWithoutGhosts();
@@ -132,6 +140,9 @@ TileElement* MapGetFirstElementAt(const TileCoordsXY& tilePos);
 TileElement* MapGetNthElementAt(const CoordsXY& coords, int32_t n);
 TileElement* MapGetFirstTileElementWithBaseHeightBetween(const TileCoordsXYRangedZ& loc, TileElementType type);
 void MapSetTileElement(const TileCoordsXY& tilePos, TileElement* elements);
+// Publishes the recorded tile changes so the caches derived from the tile elements drop what the changes affect, needs
+// calling after elements were modified outside of game actions before anything reads those caches.
+void MapInvalidateElementCaches();
 int32_t MapHeightFromSlope(const CoordsXY& coords, int32_t slopeDirection, bool isSloped);
 BannerElement* MapGetBannerElementAt(const CoordsXYZ& bannerPos, uint8_t direction);
 SurfaceElement* MapGetSurfaceElementAt(const TileCoordsXY& coords);
@@ -162,6 +173,8 @@ int16_t TileElementHeight(const CoordsXY& loc);
 int16_t TileElementHeight(const CoordsXYZ& loc, uint8_t slope);
 int16_t TileElementWaterHeight(const CoordsXY& loc);
 void TileElementRemove(TileElement* tileElement);
+// Records a change to an element of the map for TileChanges, elements that are not part of the map are ignored.
+void MapRecordTileElementChanged(const TileElement* element);
 TileElement* TileElementInsert(const CoordsXYZ& loc, int32_t occupiedQuadrants, TileElementType type);
 
 template<typename T = TileElement> T* MapGetFirstTileElementWithBaseHeightBetween(const TileCoordsXYRangedZ& loc)
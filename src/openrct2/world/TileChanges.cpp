@@ -0,0 +1,162 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TileChanges.h"
+
+#include "../GameState.h"
+#include "../profiling/Profiling.h"
+#include "Map.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace OpenRCT2::TileChanges
+{
+    struct Subscription
+    {
+        uint32_t Cookie{};
+        Listener Function;
+    };
+
+    static ChangeSet _pending;
+    static ChangeSet _published;
+    // One bit per tile of the map at the time of the first change, dropped whenever all tiles change as that is also
+    // what happens when the map is resized.
+    static std::vector<bool> _dirtyTiles;
+    static TileCoordsXY _dirtyTilesSize;
+    static std::vector<Subscription> _subscriptions;
+    static uint32_t _nextCookie = 1;
+    static uint32_t _recordCount;
+    static bool _publishing;
+
+    static bool IsTileInRange(const TileCoordsXY& coords)
+    {
+        return coords.x >= 0 && coords.y >= 0 && coords.x < _dirtyTilesSize.x && coords.y < _dirtyTilesSize.y;
+    }
+
+    static size_t GetTileIndex(const TileCoordsXY& coords)
+    {
+        return static_cast<size_t>(coords.y) * _dirtyTilesSize.x + coords.x;
+    }
+
+    void Record(const TileCoordsXY& coords, TileElementType elementType, ChangeKind kind)
+    {
+        _recordCount++;
+        if (_pending.AllTilesChanged || coords.x < 0 || coords.y < 0)
+            return;
+
+        // Setting up an element changes several of its fields in a row, which only needs to be recorded once.
+        auto& changes = _pending.Changes;
+        if (kind == ChangeKind::Modified && !changes.empty() && changes.back().Coords == coords
+            && changes.back().ElementType == elementType)
+        {
+            return;
+        }
+
+        if (_dirtyTiles.empty())
+        {
+            const auto mapSize = GetGameState().MapSize;
+            _dirtyTilesSize = { std::max(mapSize.x, coords.x + 1), std::max(mapSize.y, coords.y + 1) };
+            _dirtyTiles.resize(static_cast<size_t>(_dirtyTilesSize.x) * _dirtyTilesSize.y);
+        }
+        else if (!IsTileInRange(coords))
+        {
+            // Only if the map grew without all tiles being recorded as changed, treat it as such.
+            RecordAllTilesChanged();
+            return;
+        }
+        _dirtyTiles[GetTileIndex(coords)] = true;
+        changes.push_back({ coords, elementType, kind });
+    }
+
+    void RecordAllTilesChanged()
+    {
+        _recordCount++;
+        _pending.Changes.clear();
+        _pending.AllTilesChanged = true;
+        _dirtyTiles.clear();
+        _dirtyTiles.shrink_to_fit();
+        _dirtyTilesSize = {};
+    }
+
+    bool IsTileDirty(const TileCoordsXY& coords)
+    {
+        if (_pending.AllTilesChanged)
+            return true;
+        if (_dirtyTiles.empty() || !IsTileInRange(coords))
+            return false;
+        return _dirtyTiles[GetTileIndex(coords)];
+    }
+
+    const ChangeSet& GetPending()
+    {
+        return _pending;
+    }
+
+    uint32_t GetRecordCount()
+    {
+        return _recordCount;
+    }
+
+    void Publish()
+    {
+        PROFILED_FUNCTION();
+
+        if (_publishing || (!_pending.AllTilesChanged && _pending.Changes.empty()))
+            return;
+
+        // Changes made by the listeners go into the next set.
+        std::swap(_pending, _published);
+        for (const auto& change : _published.Changes)
+        {
+            _dirtyTiles[GetTileIndex(change.Coords)] = false;
+        }
+
+        // Listeners may subscribe or unsubscribe while being called. Removals only clear the listener until all have been
+        // called, so no listener is skipped, and listeners that subscribe are called from the next set on.
+        _publishing = true;
+        const auto numSubscriptions = _subscriptions.size();
+        for (size_t i = 0; i < numSubscriptions; i++)
+        {
+            if (_subscriptions[i].Function == nullptr)
+                continue;
+
+            const auto listener = _subscriptions[i].Function;
+            listener(_published);
+        }
+        _publishing = false;
+        std::erase_if(_subscriptions, [](const Subscription& subscription) { return subscription.Function == nullptr; });
+
+        _published.Changes.clear();
+        _published.AllTilesChanged = false;
+    }
+
+    uint32_t Subscribe(Listener listener)
+    {
+        const auto cookie = _nextCookie++;
+        _subscriptions.push_back({ cookie, std::move(listener) });
+        return cookie;
+    }
+
+    void Unsubscribe(uint32_t cookie)
+    {
+        if (_publishing)
+        {
+            for (auto& subscription : _subscriptions)
+            {
+                if (subscription.Cookie == cookie)
+                {
+                    subscription.Function = nullptr;
+                }
+            }
+            return;
+        }
+        std::erase_if(_subscriptions, [cookie](const Subscription& subscription) { return subscription.Cookie == cookie; });
+    }
+} // namespace OpenRCT2::TileChanges
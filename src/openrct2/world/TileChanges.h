@@ -0,0 +1,65 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "Location.hpp"
+#include "tile_element/TileElementType.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * Keeps track of which tiles had elements inserted, removed or modified, so code that derives data from the map can
+ * update only what changed rather than scan every tile. The changes are collected by the map functions and handed to
+ * the listeners by MapInvalidateElementCaches, which runs after every game action and every insert or removal, and at
+ * the end of every tick, or every frame while the game is paused.
+ */
+namespace OpenRCT2::TileChanges
+{
+    enum class ChangeKind : uint8_t
+    {
+        Inserted,
+        Removed,
+        Modified,
+    };
+
+    struct Change
+    {
+        TileCoordsXY Coords;
+        TileElementType ElementType{};
+        ChangeKind Kind{};
+    };
+
+    struct ChangeSet
+    {
+        // Set when all tile elements were replaced, such as when a park is loaded. No other changes are kept then.
+        bool AllTilesChanged{};
+        std::vector<Change> Changes;
+    };
+
+    using Listener = std::function<void(const ChangeSet&)>;
+
+    void Record(const TileCoordsXY& coords, TileElementType elementType, ChangeKind kind);
+    void RecordAllTilesChanged();
+
+    // Whether the tile has changed since the changes were last published.
+    bool IsTileDirty(const TileCoordsXY& coords);
+    const ChangeSet& GetPending();
+
+    // Increases with every recorded change, including the ones merged into the change before.
+    uint32_t GetRecordCount();
+
+    // Hands the pending changes to the listeners and starts collecting a new set, does nothing when called by a listener.
+    void Publish();
+
+    uint32_t Subscribe(Listener listener);
+    void Unsubscribe(uint32_t cookie);
+} // namespace OpenRCT2::TileChanges
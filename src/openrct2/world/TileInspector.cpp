@@ -67,6 +67,8 @@ namespace OpenRCT2::TileInspector
 
         // Swap their memory
         std::swap(*firstElement, *secondElement);
+        MapRecordTileElementChanged(firstElement);
+        MapRecordTileElementChanged(secondElement);
 
         // Swap the 'last map element for tile' flag if either one of them was last
         if ((firstElement)->IsLastForTile() || (secondElement)->IsLastForTile())
@@ -18,20 +18,25 @@
 template<typename T> class TilePointerIndex
 {
     std::vector<T*> TilePointers;
-    uint16_t MapSize{};
+    TileCoordsXY Size{};
 
 public:
     TilePointerIndex() = default;
 
     explicit TilePointerIndex(const uint16_t mapSize, T* tileElements, size_t count)
+        : TilePointerIndex(TileCoordsXY{ mapSize, mapSize }, tileElements, count)
     {
-        MapSize = mapSize;
-        TilePointers.reserve(MapSize * MapSize);
+    }
+
+    explicit TilePointerIndex(const TileCoordsXY& size, T* tileElements, size_t count)
+    {
+        Size = size;
+        TilePointers.reserve(static_cast<size_t>(Size.x) * Size.y);
 
         size_t index = 0;
-        for (size_t y = 0; y < MapSize; y++)
+        for (int32_t y = 0; y < Size.y; y++)
         {
-            for (size_t x = 0; x < MapSize; x++)
+            for (int32_t x = 0; x < Size.x; x++)
             {
                 assert(index < count);
                 TilePointers.emplace_back(&tileElements[index]);
@@ -43,13 +48,23 @@ public:
         }
     }
 
+    TileCoordsXY GetSize() const
+    {
+        return Size;
+    }
+
+    bool Contains(TileCoordsXY coords) const
+    {
+        return coords.x >= 0 && coords.y >= 0 && coords.x < Size.x && coords.y < Size.y;
+    }
+
     T* GetFirstElementAt(TileCoordsXY coords)
     {
-        return TilePointers[coords.x + (coords.y * MapSize)];
+        return TilePointers[coords.x + (coords.y * Size.x)];
     }
 
     void SetTile(TileCoordsXY coords, T* tileElement)
     {
-        TilePointers[coords.x + (coords.y * MapSize)] = tileElement;
+        TilePointers[coords.x + (coords.y * Size.x)] = tileElement;
     }
 };
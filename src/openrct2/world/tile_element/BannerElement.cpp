@@ -4,6 +4,7 @@
 #include "../../object/ObjectEntryManager.h"
 #include "../../object/ObjectManager.h"
 #include "../Banner.h"
+#include "../Map.h"
 
 Banner* BannerElement::GetBanner() const
 {
@@ -28,6 +29,7 @@ BannerIndex BannerElement::GetIndex() const
 void BannerElement::SetIndex(BannerIndex newIndex)
 {
     index = newIndex;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 uint8_t BannerElement::GetPosition() const
@@ -38,6 +40,7 @@ uint8_t BannerElement::GetPosition() const
 void BannerElement::SetPosition(uint8_t newPosition)
 {
     position = newPosition;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 uint8_t BannerElement::GetAllowedEdges() const
@@ -49,9 +52,11 @@ void BannerElement::SetAllowedEdges(uint8_t newEdges)
 {
     AllowedEdges &= ~0b00001111;
     AllowedEdges |= (newEdges & 0b00001111);
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 void BannerElement::ResetAllowedEdges()
 {
     AllowedEdges |= 0b00001111;
+    MapRecordTileElementChanged(as<TileElement>());
 }
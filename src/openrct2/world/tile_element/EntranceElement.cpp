@@ -15,6 +15,7 @@
 #include "../../object/FootpathSurfaceObject.h"
 #include "../../object/ObjectManager.h"
 #include "../Entrance.h"
+#include "../Map.h"
 
 // rct2: 0x0097B974
 static constexpr uint16_t EntranceDirections[] = {
@@ -31,6 +32,7 @@ uint8_t EntranceElement::GetEntranceType() const
 void EntranceElement::SetEntranceType(uint8_t newType)
 {
     entranceType = newType;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 RideId EntranceElement::GetRideIndex() const
@@ -41,6 +43,7 @@ RideId EntranceElement::GetRideIndex() const
 void EntranceElement::SetRideIndex(RideId newRideIndex)
 {
     rideIndex = newRideIndex;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 StationIndex EntranceElement::GetStationIndex() const
@@ -51,6 +54,7 @@ StationIndex EntranceElement::GetStationIndex() const
 void EntranceElement::SetStationIndex(StationIndex newStationIndex)
 {
     stationIndex = newStationIndex;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 uint8_t EntranceElement::GetSequenceIndex() const
@@ -62,6 +66,7 @@ void EntranceElement::SetSequenceIndex(uint8_t newSequenceIndex)
 {
     SequenceIndex &= ~0xF;
     SequenceIndex |= (newSequenceIndex & 0xF);
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 bool EntranceElement::HasLegacyPathEntry() const
@@ -21,8 +21,14 @@ TileElementType TileElementBase::GetType() const
 
 void TileElementBase::SetType(TileElementType newType)
 {
+    // Listeners filter by element type, so they need to hear about the element losing its old type as well.
+    if (GetType() != newType)
+    {
+        MapRecordTileElementChanged(static_cast<TileElement*>(this));
+    }
     this->Type &= ~kTileElementTypeMask;
     this->Type |= ((EnumValue(newType) << 2) & kTileElementTypeMask);
+    MapRecordTileElementChanged(static_cast<TileElement*>(this));
 }
 
 Direction TileElementBase::GetDirection() const
@@ -34,6 +40,7 @@ void TileElementBase::SetDirection(Direction direction)
 {
     this->Type &= ~kTileElementDirectionMask;
     this->Type |= (direction & kTileElementDirectionMask);
+    MapRecordTileElementChanged(static_cast<TileElement*>(this));
 }
 
 Direction TileElementBase::GetDirectionWithOffset(uint8_t offset) const
@@ -65,6 +72,7 @@ void TileElementBase::SetInvisible(bool on)
         Flags |= TILE_ELEMENT_FLAG_INVISIBLE;
     else
         Flags &= ~TILE_ELEMENT_FLAG_INVISIBLE;
+    MapRecordTileElementChanged(static_cast<TileElement*>(this));
 }
 
 bool TileElementBase::IsGhost() const
@@ -82,6 +90,7 @@ void TileElementBase::SetGhost(bool isGhost)
     {
         this->Flags &= ~TILE_ELEMENT_FLAG_GHOST;
     }
+    MapRecordTileElementChanged(static_cast<TileElement*>(this));
 }
 
 void TileElementBase::Remove()
@@ -98,6 +107,7 @@ void TileElementBase::SetOccupiedQuadrants(uint8_t quadrants)
 {
     Flags &= ~kTileElementOccupiedQuadrantsMask;
     Flags |= (quadrants & kTileElementOccupiedQuadrantsMask);
+    MapRecordTileElementChanged(static_cast<TileElement*>(this));
 }
 
 int32_t TileElementBase::GetBaseZ() const
@@ -108,6 +118,7 @@ int32_t TileElementBase::GetBaseZ() const
 void TileElementBase::SetBaseZ(int32_t newZ)
 {
     BaseHeight = (newZ / kCoordsZStep);
+    MapRecordTileElementChanged(static_cast<TileElement*>(this));
 }
 
 int32_t TileElementBase::GetClearanceZ() const
@@ -118,6 +129,7 @@ int32_t TileElementBase::GetClearanceZ() const
 void TileElementBase::SetClearanceZ(int32_t newZ)
 {
     ClearanceHeight = (newZ / kCoordsZStep);
+    MapRecordTileElementChanged(static_cast<TileElement*>(this));
 }
 
 uint8_t TileElementBase::GetOwner() const
@@ -129,6 +141,7 @@ void TileElementBase::SetOwner(uint8_t newOwner)
 {
     Owner &= ~OWNER_MASK;
     Owner |= (newOwner & OWNER_MASK);
+    MapRecordTileElementChanged(static_cast<TileElement*>(this));
 }
 
 const SurfaceElement* TileElementBase::AsSurface() const
@@ -12,6 +12,7 @@
 #include "../../GameState.h"
 #include "../../ride/RideData.h"
 #include "../../ride/Track.h"
+#include "../Map.h"
 
 using namespace OpenRCT2;
 
@@ -129,6 +130,7 @@ OpenRCT2::TrackElemType TrackElement::GetTrackType() const
 void TrackElement::SetTrackType(OpenRCT2::TrackElemType newType)
 {
     TrackType = newType;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 ride_type_t TrackElement::GetRideType() const
@@ -139,6 +141,7 @@ ride_type_t TrackElement::GetRideType() const
 void TrackElement::SetRideType(const ride_type_t rideType)
 {
     RideType = rideType;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 uint8_t TrackElement::GetSequenceIndex() const
@@ -149,6 +152,7 @@ uint8_t TrackElement::GetSequenceIndex() const
 void TrackElement::SetSequenceIndex(uint8_t newSequenceIndex)
 {
     URide.Sequence = newSequenceIndex;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 StationIndex TrackElement::GetStationIndex() const
@@ -159,6 +163,7 @@ StationIndex TrackElement::GetStationIndex() const
 void TrackElement::SetStationIndex(StationIndex newStationIndex)
 {
     URide.stationIndex = newStationIndex;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 uint8_t TrackElement::GetDoorAState() const
@@ -191,6 +196,7 @@ RideId TrackElement::GetRideIndex() const
 void TrackElement::SetRideIndex(RideId newRideIndex)
 {
     RideIndex = newRideIndex;
+    MapRecordTileElementChanged(as<TileElement>());
 }
 
 uint8_t TrackElement::GetColourScheme() const
@@ -0,0 +1,499 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+/**
+ * Runs the parks in the test data for a fixed number of ticks and measures the simulation, saving, loading and
+ * optionally rendering them. The results can be written to a JSON file and compared against an earlier run.
+ */
+
+#include "TestData.h"
+
+#include <openrct2/Context.h>
+#include <openrct2/GameState.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/core/Console.hpp>
+#include <openrct2/core/FileSystem.hpp>
+#include <openrct2/core/Json.hpp>
+#include <openrct2/core/MemoryStream.h>
+#include <openrct2/core/Path.hpp>
+#include <openrct2/core/TickArena.h>
+#include <openrct2/drawing/NewDrawing.h>
+#include <openrct2/entity/EntityRegistry.h>
+#include <openrct2/interface/Screenshot.h>
+#include <openrct2/park/ParkFile.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <malloc.h>
+#    include <windows.h>
+// windows.h has to be included before psapi.h
+#    include <psapi.h>
+#else
+#    include <sys/resource.h>
+#endif
+
+using namespace OpenRCT2;
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr int8_t kRenderZoomLevels[] = { 0, 1, 2, 3 };
+
+static std::atomic<uint64_t> _allocations{};
+
+// Count every allocation made by the game while benchmarking, in all forms of operator new.
+static void* CountedAllocate(size_t size) noexcept
+{
+    _allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+static void* CountedAllocate(size_t size, std::align_val_t alignment) noexcept
+{
+    _allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto align = std::max(static_cast<size_t>(alignment), sizeof(void*));
+#ifdef _WIN32
+    return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    void* ptr = nullptr;
+    return posix_memalign(&ptr, align, size == 0 ? 1 : size) == 0 ? ptr : nullptr;
+#endif
+}
+
+static void CountedFree(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+static void CountedFree(void* ptr, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+template<typename... TArgs> static void* CountedAllocateOrThrow(size_t size, TArgs... args)
+{
+    if (auto* ptr = CountedAllocate(size, args...))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size)
+{
+    return CountedAllocateOrThrow(size);
+}
+
+void* operator new[](size_t size)
+{
+    return CountedAllocateOrThrow(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return CountedAllocateOrThrow(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return CountedAllocateOrThrow(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+    CountedFree(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+    CountedFree(ptr, alignment);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t alignment) noexcept
+{
+    CountedFree(ptr, alignment);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t alignment) noexcept
+{
+    CountedFree(ptr, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    CountedFree(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    CountedFree(ptr, alignment);
+}
+
+struct BenchmarkOptions
+{
+    uint32_t Ticks = 1000;
+    std::vector<std::string> Parks;
+    bool Render = false;
+    std::string OutputPath;
+    std::string BaselinePath;
+    double TolerancePercent = 10.0;
+    bool AssertNoAllocations = false;
+};
+
+static double GetElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static uint64_t GetPeakResidentSetKiB()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.PeakWorkingSetSize / 1024;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#    ifdef __APPLE__
+    // macOS reports bytes instead of kibibytes.
+    return usage.ru_maxrss / 1024;
+#    else
+    return usage.ru_maxrss;
+#    endif
+#endif
+}
+
+static std::vector<std::string> GetParkNames(const BenchmarkOptions& options)
+{
+    if (!options.Parks.empty())
+        return options.Parks;
+
+    std::vector<std::string> names;
+    for (const auto& entry : fs::directory_iterator(fs::u8path(Path::Combine(TestData::GetBasePath(), u8"parks"))))
+    {
+        if (entry.is_regular_file())
+        {
+            names.push_back(entry.path().filename().u8string());
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+static bool BenchmarkPark(IContext& context, const std::string& name, const BenchmarkOptions& options, json_t& result)
+{
+    if (!context.LoadParkFromFile(TestData::GetParkPath(name)))
+    {
+        Console::Error::WriteLine("Unable to load %s", name.c_str());
+        return false;
+    }
+
+    // The first half of the run warms up caches and the tick arena, the second half is the steady state.
+    const auto steadyTicks = options.Ticks - options.Ticks / 2;
+    uint64_t allocations = 0;
+    uint64_t steadyAllocations = 0;
+    uint64_t maxSteadyTickAllocations = 0;
+    const auto simulateStart = Clock::now();
+    for (uint32_t i = 0; i < options.Ticks; i++)
+    {
+        const auto allocationsBefore = _allocations.load(std::memory_order_relaxed);
+        gameStateUpdateLogic();
+        const auto tickAllocations = _allocations.load(std::memory_order_relaxed) - allocationsBefore;
+        allocations += tickAllocations;
+        if (i >= options.Ticks / 2)
+        {
+            steadyAllocations += tickAllocations;
+            maxSteadyTickAllocations = std::max(maxSteadyTickAllocations, tickAllocations);
+        }
+    }
+    const auto simulateMs = GetElapsedMs(simulateStart);
+
+    result["ticks_per_second"] = options.Ticks * 1000.0 / std::max(simulateMs, 0.001);
+    result["ms_per_tick"] = simulateMs / options.Ticks;
+    result["allocations_per_tick"] = static_cast<double>(allocations) / options.Ticks;
+    result["steady_allocations_per_tick"] = static_cast<double>(steadyAllocations) / steadyTicks;
+    result["max_steady_tick_allocations"] = maxSteadyTickAllocations;
+    result["tick_arena_kib"] = TickArena::GetCapacity() / 1024;
+    // The same build always ends up with the same entities, a different checksum means the simulation changed.
+    result["checksum"] = GetAllEntitiesChecksum().ToString();
+
+    MemoryStream stream;
+    const auto saveStart = Clock::now();
+    ParkFileExporter().Export(GetGameState(), stream);
+    result["save_ms"] = GetElapsedMs(saveStart);
+    result["park_file_bytes"] = stream.GetLength();
+
+    stream.SetPosition(0);
+    const auto loadStart = Clock::now();
+    if (!context.LoadParkFromStream(&stream, "benchmark.park"))
+    {
+        Console::Error::WriteLine("Unable to load %s after saving it", name.c_str());
+        return false;
+    }
+    result["load_ms"] = GetElapsedMs(loadStart);
+
+    if (options.Render)
+    {
+        gScreenFlags = SCREEN_FLAGS_PLAYING;
+        for (auto zoom : kRenderZoomLevels)
+        {
+            const auto renderStart = Clock::now();
+            ScreenshotRenderGiant(ZoomLevel{ zoom }, 0);
+            result["render_ms"]["zoom" + std::to_string(zoom)] = GetElapsedMs(renderStart);
+        }
+    }
+    return true;
+}
+
+static void PrintResult(const std::string& name, const json_t& result)
+{
+    Console::WriteLine(
+        "%-40s %10.0f ticks/s %8.3f ms/tick %10.1f allocs/tick %8.1f steady allocs/tick %8.2f ms save %8.2f ms load",
+        name.c_str(), result["ticks_per_second"].get<double>(), result["ms_per_tick"].get<double>(),
+        result["allocations_per_tick"].get<double>(), result["steady_allocations_per_tick"].get<double>(),
+        result["save_ms"].get<double>(), result["load_ms"].get<double>());
+    if (result.contains("render_ms"))
+    {
+        for (const auto& [zoom, ms] : result["render_ms"].items())
+        {
+            Console::WriteLine("%-40s %10.2f ms/frame at %s", "", ms.get<double>(), zoom.c_str());
+        }
+    }
+}
+
+/**
+ * Compares a measurement against the baseline, returns false if it got worse by more than the tolerance.
+ */
+static bool CompareValue(
+    const std::string& name, const std::string& metric, double value, double baseline, bool higherIsBetter,
+    double tolerancePercent)
+{
+    if (baseline <= 0)
+        return true;
+
+    const auto changePercent = (value - baseline) * 100.0 / baseline;
+    const auto regressed = higherIsBetter ? changePercent < -tolerancePercent : changePercent > tolerancePercent;
+    if (regressed)
+    {
+        Console::Error::WriteLine(
+            "%s: %s regressed by %.1f%% (%.3f, baseline %.3f)", name.c_str(), metric.c_str(), std::abs(changePercent), value,
+            baseline);
+    }
+    return !regressed;
+}
+
+static bool CompareWithBaseline(const json_t& results, const json_t& baseline, double tolerancePercent)
+{
+    if (!baseline.is_object() || baseline.value("ticks", 0u) != results["ticks"].get<uint32_t>())
+    {
+        Console::Error::WriteLine("The baseline ran a different number of ticks, results are not comparable.");
+        return false;
+    }
+
+    bool passed = true;
+    const auto baselineParks = baseline.value("parks", json_t::object());
+    for (const auto& [name, result] : results["parks"].items())
+    {
+        if (!baselineParks.contains(name))
+            continue;
+
+        const auto& base = baselineParks[name];
+        if (base.value("checksum", "") != result["checksum"].get<std::string>())
+        {
+            Console::WriteLine("%s: simulation result differs from the baseline", name.c_str());
+        }
+
+        passed &= CompareValue(
+            name, "ticks/s", result["ticks_per_second"].get<double>(), base.value("ticks_per_second", 0.0), true,
+            tolerancePercent);
+        for (const auto* metric : { "allocations_per_tick", "steady_allocations_per_tick", "save_ms", "load_ms" })
+        {
+            passed &= CompareValue(
+                name, metric, result[metric].get<double>(), base.value(metric, 0.0), false, tolerancePercent);
+        }
+
+        const auto baseRender = base.value("render_ms", json_t::object());
+        if (result.contains("render_ms"))
+        {
+            for (const auto& [zoom, ms] : result["render_ms"].items())
+            {
+                passed &= CompareValue(
+                    name, "render " + zoom, ms.get<double>(), baseRender.value(zoom, 0.0), false, tolerancePercent);
+            }
+        }
+    }
+
+    passed &= CompareValue(
+        "process", "peak RSS", results["peak_rss_kib"].get<double>(), baseline.value("peak_rss_kib", 0.0), false,
+        tolerancePercent);
+    return passed;
+}
+
+static bool ParseOptions(int argc, const char** argv, BenchmarkOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--render")
+            options.Render = true;
+        else if (arg == "--ticks" && hasValue)
+            options.Ticks = std::max(std::atoi(argv[++i]), 1);
+        else if (arg == "--park" && hasValue)
+            options.Parks.emplace_back(argv[++i]);
+        else if (arg == "--output" && hasValue)
+            options.OutputPath = argv[++i];
+        else if (arg == "--baseline" && hasValue)
+            options.BaselinePath = argv[++i];
+        else if (arg == "--assert-no-allocations")
+            options.AssertNoAllocations = true;
+        else if (arg == "--tolerance" && hasValue)
+            options.TolerancePercent = std::atof(argv[++i]);
+        else
+        {
+            Console::WriteLine(
+                "Usage: OpenRCT2Benchmarks [--ticks <n>] [--park <file>]... [--render] [--output <json>] "
+                "[--baseline <json>] [--tolerance <percent>] [--assert-no-allocations]");
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, const char** argv)
+{
+    BenchmarkOptions options;
+    if (!ParseOptions(argc, argv, options))
+        return EXIT_FAILURE;
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = !options.Render;
+
+    auto context = CreateContext();
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXIT_FAILURE;
+    }
+    if (options.Render)
+    {
+        DrawingEngineInit();
+    }
+
+    json_t results;
+    results["ticks"] = options.Ticks;
+    results["parks"] = json_t::object();
+    bool allocationFree = true;
+    for (const auto& name : GetParkNames(options))
+    {
+        json_t result;
+        if (BenchmarkPark(*context, name, options, result))
+        {
+            PrintResult(name, result);
+            const auto maxTickAllocations = result["max_steady_tick_allocations"].get<uint64_t>();
+            if (options.AssertNoAllocations && maxTickAllocations != 0)
+            {
+                Console::Error::WriteLine(
+                    "%s: a steady state tick made %llu heap allocations", name.c_str(),
+                    static_cast<unsigned long long>(maxTickAllocations));
+                allocationFree = false;
+            }
+            results["parks"][name] = std::move(result);
+        }
+    }
+    const auto peakResidentSet = GetPeakResidentSetKiB();
+    results["peak_rss_kib"] = peakResidentSet;
+    Console::WriteLine("Peak resident set: %llu KiB", static_cast<unsigned long long>(peakResidentSet));
+
+    if (options.Render)
+    {
+        DrawingEngineDispose();
+    }
+
+    if (!options.OutputPath.empty())
+    {
+        Json::WriteToFile(options.OutputPath, results);
+    }
+
+    if (!allocationFree)
+        return EXIT_FAILURE;
+
+    if (!options.BaselinePath.empty())
+    {
+        const auto baseline = Json::ReadFromFile(options.BaselinePath);
+        if (!CompareWithBaseline(results, baseline, options.TolerancePercent))
+            return EXIT_FAILURE;
+        Console::WriteLine("No regressions against %s", options.BaselinePath.c_str());
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,270 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/entity/EntityList.h>
+#include <openrct2/entity/EntityRegistry.h>
+#include <openrct2/entity/Guest.h>
+#include <openrct2/entity/Litter.h>
+#include <limits>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class EntityRegistryTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ResetAllEntities();
+    }
+
+    void TearDown() override
+    {
+        ResetAllEntities();
+    }
+};
+
+TEST_F(EntityRegistryTest, MemoryGrowsWithUse)
+{
+    ASSERT_EQ(GetEntityMemoryUsage(), 0u);
+
+    ASSERT_NE(CreateEntity<Guest>(), nullptr);
+    ASSERT_EQ(GetEntityMemoryUsage(), EntityPool::kChunkSize * sizeof(Guest));
+
+    // Each pool's slots are sized for its own entity type.
+    ASSERT_NE(CreateEntity<Litter>(), nullptr);
+    ASSERT_EQ(GetEntityMemoryUsage(), EntityPool::kChunkSize * (sizeof(Guest) + sizeof(Litter)));
+
+    ResetAllEntities();
+    ASSERT_EQ(GetEntityMemoryUsage(), 0u);
+}
+
+TEST_F(EntityRegistryTest, EntitiesDoNotMove)
+{
+    std::vector<Guest*> guests;
+    for (size_t i = 0; i < 3 * EntityPool::kChunkSize; i++)
+    {
+        auto* guest = CreateEntity<Guest>();
+        ASSERT_NE(guest, nullptr);
+        guests.push_back(guest);
+    }
+
+    for (auto* guest : guests)
+    {
+        ASSERT_EQ(GetEntity<Guest>(guest->Id), guest);
+    }
+
+    // Entities are visited in id order, which is also the order their slots were handed out in.
+    size_t index = 0;
+    for (auto* guest : EntityList<Guest>())
+    {
+        ASSERT_EQ(guest, guests[index++]);
+    }
+    ASSERT_EQ(index, guests.size());
+}
+
+TEST_F(EntityRegistryTest, RemovedEntityIsFree)
+{
+    auto* litter = CreateEntity<Litter>();
+    ASSERT_NE(litter, nullptr);
+    const auto id = litter->Id;
+
+    EntityRemove(litter);
+    ASSERT_EQ(static_cast<EntityBase*>(litter)->Type, EntityType::Null);
+    ASSERT_EQ(GetEntity(id), nullptr);
+
+    // The lowest free id and slot are reused.
+    auto* next = CreateEntity<Litter>();
+    ASSERT_EQ(next->Id, id);
+    ASSERT_EQ(next, litter);
+}
+
+TEST_F(EntityRegistryTest, LowestFreeSlotIsReused)
+{
+    std::vector<Litter*> litter;
+    for (int32_t i = 0; i < 8; i++)
+    {
+        litter.push_back(CreateEntity<Litter>());
+        ASSERT_NE(litter.back(), nullptr);
+    }
+
+    // Free slots in an order unrelated to their position.
+    for (auto i : { 5, 1, 6, 3 })
+    {
+        EntityRemove(litter[i]);
+    }
+    for (auto i : { 1, 3, 5, 6 })
+    {
+        auto* next = CreateEntity<Litter>();
+        ASSERT_EQ(next, litter[i]);
+    }
+}
+
+TEST_F(EntityRegistryTest, ModifyWhileIterating)
+{
+    for (int32_t i = 0; i < 6; i++)
+    {
+        ASSERT_NE(CreateEntity<Litter>(), nullptr);
+    }
+
+    // Remove every entity after visiting it and the one following it, create a new one on every other step.
+    std::vector<EntityId> visited;
+    int32_t step = 0;
+    for (auto* litter : EntityList<Litter>())
+    {
+        visited.push_back(litter->Id);
+        const auto id = litter->Id;
+        EntityRemove(litter);
+
+        auto* following = GetEntity<Litter>(EntityId::FromUnderlying(id.ToUnderlying() + 1));
+        if (following != nullptr)
+        {
+            EntityRemove(following);
+        }
+        if (step++ % 2 == 0)
+        {
+            ASSERT_NE(CreateEntity<Litter>(), nullptr);
+        }
+    }
+
+    // Created entities reuse the lowest free id, which is behind the current one.
+    const std::vector<EntityId> expected = {
+        EntityId::FromUnderlying(0),
+        EntityId::FromUnderlying(2),
+        EntityId::FromUnderlying(4),
+    };
+    ASSERT_EQ(visited, expected);
+    ASSERT_EQ(GetEntityListCount(EntityType::Litter), 2);
+}
+
+TEST_F(EntityRegistryTest, SpatialIndex)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int32_t> tile(1, 4);
+    std::vector<Litter*> litter;
+    for (int32_t i = 0; i < 200; i++)
+    {
+        litter.push_back(CreateEntity<Litter>());
+        ASSERT_NE(litter.back(), nullptr);
+    }
+
+    for (int32_t iteration = 0; iteration < 20; iteration++)
+    {
+        for (auto*& entity : litter)
+        {
+            if (entity == nullptr)
+            {
+                entity = CreateEntity<Litter>();
+            }
+            else if (tile(rng) == 1)
+            {
+                EntityRemove(entity);
+                entity = nullptr;
+                continue;
+            }
+            entity->SetLocation(TileCoordsXYZ{ tile(rng), tile(rng), 0 }.ToCoordsXYZ());
+        }
+        UpdateEntitiesSpatialIndex();
+
+        for (int32_t x = 1; x <= 4; x++)
+        {
+            for (int32_t y = 1; y <= 4; y++)
+            {
+                const auto pos = TileCoordsXY{ x, y }.ToCoordsXY();
+                std::vector<EntityId> expected;
+                for (auto* entity : EntityList<Litter>())
+                {
+                    if (TileCoordsXY(entity->GetLocation()) == TileCoordsXY{ x, y })
+                    {
+                        expected.push_back(entity->Id);
+                    }
+                }
+
+                std::vector<EntityId> actual;
+                for (auto* entity : EntityTileList<Litter>(pos))
+                {
+                    actual.push_back(entity->Id);
+                }
+                ASSERT_EQ(actual, expected);
+            }
+        }
+    }
+}
+
+TEST_F(EntityRegistryTest, RadiusQueries)
+{
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int32_t> coord(0, 40 * 2);
+    std::uniform_int_distribution<int32_t> percent(0, 99);
+    for (int32_t i = 0; i < 300; i++)
+    {
+        auto* litter = CreateEntity<Litter>();
+        ASSERT_NE(litter, nullptr);
+        // Coarse positions give plenty of equal distances, some litter stays without a location.
+        if (percent(rng) >= 5)
+        {
+            litter->SetLocation({ coord(rng) * 16, coord(rng) * 16, 0 });
+        }
+    }
+    UpdateEntitiesSpatialIndex();
+
+    // Move some litter without updating the index, like entities moving during a tick.
+    for (auto* litter : EntityList<Litter>())
+    {
+        if (percent(rng) < 20)
+        {
+            litter->SetLocation({ coord(rng) * 16, coord(rng) * 16, 0 });
+        }
+    }
+
+    const auto distanceTo = [](const CoordsXY& pos) {
+        return [pos](const Litter& litter) -> std::optional<uint32_t> {
+            if (litter.x == kLocationNull)
+                return std::nullopt;
+            return std::abs(litter.x - pos.x) + std::abs(litter.y - pos.y);
+        };
+    };
+
+    for (int32_t query = 0; query < 200; query++)
+    {
+        const CoordsXY pos{ coord(rng) * 16, coord(rng) * 16 };
+        const auto radius = percent(rng) * 4;
+
+        std::vector<EntityId> expected;
+        for (auto* litter : EntityList<Litter>())
+        {
+            if (litter->x != kLocationNull && std::abs(litter->x - pos.x) <= radius && std::abs(litter->y - pos.y) <= radius)
+            {
+                expected.push_back(litter->Id);
+            }
+        }
+        std::vector<EntityId> actual;
+        ForEachEntityInRadius<Litter>(pos, radius, [&](Litter* litter) { actual.push_back(litter->Id); });
+        ASSERT_EQ(actual, expected);
+
+        for (auto maxDistance : { static_cast<uint32_t>(radius), std::numeric_limits<uint32_t>::max() })
+        {
+            Litter* nearest = nullptr;
+            uint32_t nearestDistance = maxDistance;
+            for (auto* litter : EntityList<Litter>())
+            {
+                const auto distance = distanceTo(pos)(*litter);
+                if (distance.has_value() && (nearest == nullptr ? *distance <= maxDistance : *distance < nearestDistance))
+                {
+                    nearest = litter;
+                    nearestDistance = *distance;
+                }
+            }
+            ASSERT_EQ(FindNearestEntity<Litter>(pos, maxDistance, distanceTo(pos)), nearest);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/entity/EntityRegistry.h>
+#include <vector>
+
+using namespace OpenRCT2;
+
+static std::vector<EntitiesChecksum> SimulatePark(IContext& context, uint32_t ticks)
+{
+    context.LoadParkFromFile(TestData::GetParkPath("bpb.sv6"));
+
+    std::vector<EntitiesChecksum> checksums;
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        gameStateUpdateLogic();
+        checksums.push_back(GetAllEntitiesChecksum());
+    }
+    return checksums;
+}
+
+TEST(EntityUpdateTest, FastForwardMatchesNormal)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    auto context = CreateContext();
+    ASSERT_TRUE(context->Initialise());
+
+    constexpr uint32_t kTicks = 1000;
+    const auto normal = SimulatePark(*context, kTicks);
+    gFastForward = true;
+    const auto fastForward = SimulatePark(*context, kTicks);
+    gFastForward = false;
+
+    for (uint32_t i = 0; i < kTicks; i++)
+    {
+        ASSERT_EQ(normal[i].raw, fastForward[i].raw) << "diverged at tick " << i;
+    }
+}
+
+TEST(EntityUpdateTest, ParallelMatchesSerial)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    auto context = CreateContext();
+    ASSERT_TRUE(context->Initialise());
+
+    constexpr uint32_t kTicks = 1000;
+    const auto serial = SimulatePark(*context, kTicks);
+    EntitySetUpdateMode(EntityUpdateMode::Parallel);
+    const auto parallel = SimulatePark(*context, kTicks);
+    EntitySetUpdateMode(EntityUpdateMode::Serial);
+
+    for (uint32_t i = 0; i < kTicks; i++)
+    {
+        ASSERT_EQ(serial[i].raw, parallel[i].raw) << "diverged at tick " << i;
+    }
+}
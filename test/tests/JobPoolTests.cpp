@@ -0,0 +1,78 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+#include <atomic>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <openrct2/core/JobPool.h>
+#include <vector>
+
+// Larger than the capacity of all queues combined to exercise the inline fallback.
+constexpr size_t TEST_TASK_COUNT = 20000;
+
+TEST(JobPoolTest, AddTaskJoin)
+{
+    JobPool pool(4);
+    std::atomic<size_t> counter{ 0 };
+    for (size_t i = 0; i < TEST_TASK_COUNT; i++)
+    {
+        pool.AddTask([&counter]() { counter++; });
+    }
+    size_t reports = 0;
+    pool.Join([&reports]() { reports++; });
+    ASSERT_EQ(counter, TEST_TASK_COUNT);
+    ASSERT_GT(reports, 0u);
+    ASSERT_EQ(pool.CountPending(), 0u);
+    ASSERT_EQ(pool.CountProcessing(), 0u);
+}
+
+TEST(JobPoolTest, TaskGroups)
+{
+    JobPool pool(4);
+    JobPool::TaskGroup groupA;
+    JobPool::TaskGroup groupB;
+    std::atomic<size_t> counterA{ 0 };
+    std::atomic<size_t> counterB{ 0 };
+    for (size_t i = 0; i < 1000; i++)
+    {
+        pool.AddTask(groupA, [&counterA]() { counterA++; });
+        pool.AddTask(groupB, [&counterB]() { counterB++; });
+    }
+    pool.Wait(groupA);
+    ASSERT_EQ(counterA, 1000u);
+    ASSERT_EQ(groupA.CountPending(), 0u);
+    pool.Wait(groupB);
+    ASSERT_EQ(counterB, 1000u);
+}
+
+TEST(JobPoolTest, NestedParallelFor)
+{
+    JobPool pool(4);
+    std::vector<uint32_t> values(64 * 256);
+    pool.ParallelFor(0, 64, 1, [&](size_t outer) {
+        pool.ParallelFor(0, 256, 16, [&](size_t inner) { values[outer * 256 + inner] = static_cast<uint32_t>(outer + inner); });
+    });
+
+    uint64_t expected = 0;
+    for (size_t outer = 0; outer < 64; outer++)
+    {
+        for (size_t inner = 0; inner < 256; inner++)
+        {
+            expected += outer + inner;
+        }
+    }
+    ASSERT_EQ(std::accumulate(values.begin(), values.end(), uint64_t{ 0 }), expected);
+}
+
+TEST(JobPoolTest, SingleThread)
+{
+    JobPool pool(1);
+    std::atomic<size_t> counter{ 0 };
+    pool.ParallelFor(0, 1000, 8, [&counter](size_t) { counter++; });
+    ASSERT_EQ(counter, 1000u);
+}
@@ -0,0 +1,153 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/actions/MapChangeSizeAction.h>
+#include <openrct2/core/MemoryStream.h>
+#include <openrct2/park/ParkFile.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/TileElement.h>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class MapSizeTests : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        ASSERT_TRUE(_context->Initialise());
+
+        ASSERT_TRUE(GetContext()->LoadParkFromFile(TestData::GetParkPath("tile-element-tests.sv6")));
+        GameLoadInit();
+    }
+
+    void TearDown() override
+    {
+        _context.reset();
+    }
+
+    static size_t CountTiles()
+    {
+        size_t count = 0;
+        for (const auto& element : GetTileElements())
+        {
+            if (element.IsLastForTile())
+                count++;
+        }
+        return count;
+    }
+
+    static std::vector<TileElement> GetElementsAt(const TileCoordsXY& coords)
+    {
+        std::vector<TileElement> elements;
+        const auto* element = MapGetFirstElementAt(coords);
+        if (element == nullptr)
+            return elements;
+        do
+        {
+            elements.push_back(*element);
+        } while (!(element++)->IsLastForTile());
+        return elements;
+    }
+
+    static bool ElementsEqual(const std::vector<TileElement>& a, const std::vector<TileElement>& b)
+    {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(TileElement)) == 0;
+    }
+
+private:
+    std::unique_ptr<IContext> _context;
+};
+
+TEST_F(MapSizeTests, OnlyTilesOfTheMapAreStored)
+{
+    const auto mapSize = GetGameState().MapSize;
+    ASSERT_LT(mapSize.x, kMaximumMapSizeTechnical);
+
+    EXPECT_EQ(CountTiles(), static_cast<size_t>(mapSize.x) * mapSize.y);
+    EXPECT_NE(MapGetFirstElementAt(TileCoordsXY{ mapSize.x - 1, mapSize.y - 1 }), nullptr);
+    EXPECT_EQ(MapGetFirstElementAt(TileCoordsXY{ mapSize.x, 0 }), nullptr);
+    EXPECT_EQ(MapGetFirstElementAt(TileCoordsXY{ 0, mapSize.y }), nullptr);
+    EXPECT_EQ(TileElementInsert<SurfaceElement>(TileCoordsXYZ{ mapSize.x, 0, 14 }.ToCoordsXYZ(), 0b0000), nullptr);
+}
+
+TEST_F(MapSizeTests, TilesOutsideTheMapCanBeSetTemporarily)
+{
+    const auto outside = TileCoordsXY{ GetGameState().MapSize.x + 4, 4 };
+    TileElement element{};
+    element.SetLastForTile(true);
+
+    MapSetTileElement(outside, &element);
+    EXPECT_EQ(MapGetFirstElementAt(outside), &element);
+    MapSetTileElement(outside, nullptr);
+    EXPECT_EQ(MapGetFirstElementAt(outside), nullptr);
+}
+
+TEST_F(MapSizeTests, ChangingTheSizeKeepsTheMap)
+{
+    auto& gameState = GetGameState();
+    const auto mapSize = gameState.MapSize;
+    const auto inside = TileCoordsXY{ mapSize.x / 2, mapSize.y / 2 };
+    const auto before = GetElementsAt(inside);
+
+    auto grow = MapChangeSizeAction({ mapSize.x + 10, mapSize.y + 20 });
+    ASSERT_EQ(GameActions::ExecuteNested(&grow).Error, GameActions::Status::Ok);
+    EXPECT_EQ(gameState.MapSize, TileCoordsXY(mapSize.x + 10, mapSize.y + 20));
+    EXPECT_EQ(CountTiles(), static_cast<size_t>(mapSize.x + 10) * (mapSize.y + 20));
+    EXPECT_NE(MapGetSurfaceElementAt(TileCoordsXY{ mapSize.x + 9, mapSize.y + 19 }), nullptr);
+    EXPECT_TRUE(ElementsEqual(GetElementsAt(inside), before));
+
+    auto shrink = MapChangeSizeAction(mapSize);
+    ASSERT_EQ(GameActions::ExecuteNested(&shrink).Error, GameActions::Status::Ok);
+    EXPECT_EQ(gameState.MapSize, mapSize);
+    EXPECT_EQ(CountTiles(), static_cast<size_t>(mapSize.x) * mapSize.y);
+    EXPECT_EQ(MapGetFirstElementAt(TileCoordsXY{ mapSize.x, 0 }), nullptr);
+    EXPECT_TRUE(ElementsEqual(GetElementsAt(inside), before));
+}
+
+TEST_F(MapSizeTests, SavedTilesLoadBack)
+{
+    const auto mapSize = GetGameState().MapSize;
+    std::vector<std::vector<TileElement>> before;
+    for (int32_t y = 0; y < mapSize.y; y++)
+    {
+        for (int32_t x = 0; x < mapSize.x; x++)
+        {
+            before.push_back(GetElementsAt({ x, y }));
+        }
+    }
+
+    MemoryStream stream;
+    ParkFileExporter().Export(GetGameState(), stream);
+    stream.SetPosition(0);
+    ASSERT_TRUE(GetContext()->LoadParkFromStream(&stream, "map-size.park"));
+
+    ASSERT_EQ(GetGameState().MapSize, mapSize);
+    EXPECT_EQ(CountTiles(), before.size());
+    size_t index = 0;
+    for (int32_t y = 0; y < mapSize.y; y++)
+    {
+        for (int32_t x = 0; x < mapSize.x; x++)
+        {
+            EXPECT_TRUE(ElementsEqual(GetElementsAt({ x, y }), before[index++])) << "x = " << x << ", y = " << y;
+        }
+    }
+}
@@ -0,0 +1,141 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <limits>
+#include <openrct2/core/MemoryStream.h>
+#include <openrct2/core/OrcaStream.hpp>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+static constexpr uint32_t kNumChunks = 8;
+
+static void WriteChunks(MemoryStream& stream, uint32_t compression)
+{
+    OrcaStream os(stream, OrcaStream::Mode::WRITING);
+    os.GetHeader().Compression = compression;
+    for (uint32_t id = 0; id < kNumChunks; id++)
+    {
+        os.ReadWriteChunk(id, [id](OrcaStream::ChunkStream& cs) {
+            std::vector<uint32_t> values(1000 * (id + 1), id);
+            cs.ReadWriteVector(values, [&cs](uint32_t& value) { cs.ReadWrite(value); });
+            std::string name = "Chunk " + std::to_string(id);
+            cs.ReadWrite(name);
+        });
+    }
+}
+
+static void ExpectChunksReadBack(MemoryStream& stream, uint32_t compression)
+{
+    stream.SetPosition(0);
+    OrcaStream os(stream, OrcaStream::Mode::READING);
+    EXPECT_EQ(os.GetHeader().Compression, compression);
+
+    // Read the chunks in a different order than they were written in.
+    for (uint32_t i = 0; i < kNumChunks; i++)
+    {
+        const auto id = (i * 3) % kNumChunks;
+        auto found = os.ReadWriteChunk(id, [id](OrcaStream::ChunkStream& cs) {
+            std::vector<uint32_t> values;
+            cs.ReadWriteVector(values, [&cs](uint32_t& value) { cs.ReadWrite(value); });
+            EXPECT_EQ(values, std::vector<uint32_t>(1000 * (id + 1), id));
+            std::string name;
+            cs.ReadWrite(name);
+            EXPECT_EQ(name, "Chunk " + std::to_string(id));
+        });
+        EXPECT_TRUE(found);
+    }
+    EXPECT_FALSE(os.ReadWriteChunk(kNumChunks, [](OrcaStream::ChunkStream&) {}));
+}
+
+TEST(OrcaStreamTests, ChunksCompressedSeparatelyReadBack)
+{
+    MemoryStream stream;
+    WriteChunks(stream, OrcaStream::COMPRESSION_GZIP_CHUNKS);
+    ExpectChunksReadBack(stream, OrcaStream::COMPRESSION_GZIP_CHUNKS);
+}
+
+TEST(OrcaStreamTests, ChunksCompressedTogetherReadBack)
+{
+    MemoryStream stream;
+    WriteChunks(stream, OrcaStream::COMPRESSION_GZIP);
+    ExpectChunksReadBack(stream, OrcaStream::COMPRESSION_GZIP);
+}
+
+TEST(OrcaStreamTests, PrefetchedChunksReadBack)
+{
+    MemoryStream stream;
+    WriteChunks(stream, OrcaStream::COMPRESSION_GZIP_CHUNKS);
+    stream.SetPosition(0);
+
+    OrcaStream os(stream, OrcaStream::Mode::READING);
+    os.PrefetchChunks();
+    auto found = os.ReadWriteChunk(kNumChunks - 1, [](OrcaStream::ChunkStream& cs) {
+        std::vector<uint32_t> values;
+        cs.ReadWriteVector(values, [&cs](uint32_t& value) { cs.ReadWrite(value); });
+        EXPECT_EQ(values.size(), 1000u * kNumChunks);
+    });
+    EXPECT_TRUE(found);
+}
+
+TEST(OrcaStreamTests, CopiedChunksMatchCompressedWrite)
+{
+    MemoryStream compressed;
+    WriteChunks(compressed, OrcaStream::COMPRESSION_GZIP_CHUNKS);
+
+    MemoryStream uncompressed;
+    WriteChunks(uncompressed, OrcaStream::COMPRESSION_NONE);
+    uncompressed.SetPosition(0);
+
+    MemoryStream copied;
+    {
+        OrcaStream src(uncompressed, OrcaStream::Mode::READING);
+        OrcaStream dst(copied, OrcaStream::Mode::WRITING);
+        src.CopyChunksTo(dst);
+    }
+
+    ASSERT_EQ(copied.GetLength(), compressed.GetLength());
+    EXPECT_EQ(std::memcmp(copied.GetData(), compressed.GetData(), compressed.GetLength()), 0);
+    ExpectChunksReadBack(copied, OrcaStream::COMPRESSION_GZIP_CHUNKS);
+}
+
+static void ExpectInvalidChunkTable(const std::vector<uint8_t>& data)
+{
+    MemoryStream stream(data.data(), data.size());
+    EXPECT_THROW({ OrcaStream os(stream, OrcaStream::Mode::READING); }, IOException);
+}
+
+TEST(OrcaStreamTests, InvalidChunkTablesAreRejected)
+{
+    MemoryStream stream;
+    WriteChunks(stream, OrcaStream::COMPRESSION_GZIP_CHUNKS);
+
+    // The header is followed by the chunk table, then the compressed length of each chunk.
+    constexpr size_t kHeaderSize = 64;
+    constexpr size_t kChunkEntrySize = 20;
+    constexpr size_t kLengthsOffset = kHeaderSize + kNumChunks * kChunkEntrySize;
+
+    const auto* begin = static_cast<const uint8_t*>(stream.GetData());
+    const std::vector<uint8_t> data(begin, begin + stream.GetLength());
+    ExpectInvalidChunkTable(std::vector<uint8_t>(data.begin(), data.end() - 16));
+
+    const auto corruptValue = [&data](size_t offset, uint64_t value) {
+        auto corrupted = data;
+        std::memcpy(corrupted.data() + offset, &value, sizeof(value));
+        ExpectInvalidChunkTable(corrupted);
+    };
+    corruptValue(kLengthsOffset, std::numeric_limits<uint64_t>::max() - 8);
+    corruptValue(kLengthsOffset + sizeof(uint64_t), data.size());
+    // Offset and length of the first chunk.
+    corruptValue(kHeaderSize + 4, std::numeric_limits<uint64_t>::max() - 8);
+    corruptValue(kHeaderSize + 12, std::numeric_limits<uint64_t>::max());
+}
@@ -0,0 +1,325 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <limits>
+#include <memory>
+#include <openrct2/Context.h>
+#include <openrct2/GameState.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/core/JobPool.h>
+#include <openrct2/paint/Paint.Sort.h>
+#include <openrct2/paint/Paint.h>
+#include <openrct2/platform/Platform.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/TileElement.h>
+#include <random>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class PaintArrangeTest : public testing::Test
+{
+protected:
+    std::unique_ptr<PaintSession> _session;
+    std::vector<PaintStruct> _structs;
+    JobPool _jobs{ 4 };
+
+    void Reset(uint8_t rotation, size_t capacity)
+    {
+        _session = std::make_unique<PaintSession>();
+        _session->CurrentRotation = rotation;
+        _session->QuadrantBackIndex = std::numeric_limits<uint32_t>::max();
+        _session->QuadrantFrontIndex = 0;
+        _structs.clear();
+        // Quadrants point into the vector so it must not reallocate.
+        _structs.reserve(capacity);
+    }
+
+    void Add(const PaintStructBoundBox& bounds)
+    {
+        auto& ps = _structs.emplace_back();
+        ps.Bounds = bounds;
+        PaintSessionAddPSToQuadrant(*_session, &ps);
+    }
+
+    std::vector<const PaintStruct*> Arrange(void (*arrangeFn)(PaintSessionCore&, JobPool*), JobPool* jobs)
+    {
+        // Sorting modifies the quadrant lists, run it on a copy.
+        auto session = std::make_unique<PaintSessionCore>(*_session);
+        std::vector<PaintStruct*> next;
+        for (auto& ps : _structs)
+        {
+            next.push_back(ps.NextQuadrantEntry);
+        }
+
+        arrangeFn(*session, jobs);
+
+        std::vector<const PaintStruct*> order;
+        for (auto* ps = session->PaintHead; ps != nullptr; ps = ps->NextQuadrantEntry)
+        {
+            order.push_back(ps);
+        }
+
+        for (size_t i = 0; i < _structs.size(); i++)
+        {
+            _structs[i].NextQuadrantEntry = next[i];
+            _structs[i].SortFlags = 0;
+        }
+        return order;
+    }
+
+    void CompareDrawOrder()
+    {
+        if (_structs.empty())
+        {
+            return;
+        }
+
+        const auto reference = Arrange(
+            [](PaintSessionCore& session, JobPool*) { PaintSessionArrangeReference(session); }, nullptr);
+        ASSERT_EQ(reference.size(), _structs.size());
+
+        const auto sequential = Arrange(PaintSessionArrange, nullptr);
+        ASSERT_EQ(sequential, reference);
+
+        const auto parallel = Arrange(PaintSessionArrange, &_jobs);
+        ASSERT_EQ(parallel, reference);
+    }
+};
+
+TEST_F(PaintArrangeTest, Empty)
+{
+    Reset(0, 0);
+    PaintSessionArrange(*_session, &_jobs);
+    ASSERT_EQ(_session->PaintHead, nullptr);
+}
+
+TEST_F(PaintArrangeTest, RandomBoundingBoxes)
+{
+    std::mt19937 rng(1234);
+    for (uint8_t rotation = 0; rotation < 4; rotation++)
+    {
+        for (int32_t iteration = 0; iteration < 50; iteration++)
+        {
+            const auto count = std::uniform_int_distribution<size_t>(1, 2000)(rng);
+            // Sparse positions leave empty quadrants between the structs.
+            const auto spread = std::uniform_int_distribution<int32_t>(1, 64)(rng) * kCoordsXYStep;
+            std::uniform_int_distribution<int32_t> position(0, spread);
+            std::uniform_int_distribution<int32_t> size(0, 48);
+            std::uniform_int_distribution<int32_t> height(0, 255);
+
+            Reset(rotation, count);
+            for (size_t i = 0; i < count; i++)
+            {
+                const auto x = position(rng) + kCoordsXYStep * 32;
+                const auto y = position(rng) + kCoordsXYStep * 32;
+                const auto z = height(rng);
+                Add({ x, y, z, x + size(rng), y + size(rng), z + size(rng) });
+            }
+            CompareDrawOrder();
+        }
+    }
+}
+
+TEST_F(PaintArrangeTest, ConcurrentColumns)
+{
+    struct Column
+    {
+        PaintSessionCore Session{};
+        std::vector<PaintStruct> Structs;
+        std::vector<PaintStruct*> Next;
+        std::vector<const PaintStruct*> Expected;
+
+        void Restore()
+        {
+            for (size_t i = 0; i < Structs.size(); i++)
+            {
+                Structs[i].NextQuadrantEntry = Next[i];
+                Structs[i].SortFlags = 0;
+            }
+        }
+
+        std::vector<const PaintStruct*> Arrange(JobPool* jobs)
+        {
+            Restore();
+            auto session = Session;
+            if (jobs != nullptr)
+            {
+                PaintSessionArrange(session, jobs);
+            }
+            else
+            {
+                PaintSessionArrangeReference(session);
+            }
+
+            std::vector<const PaintStruct*> order;
+            for (auto* ps = session.PaintHead; ps != nullptr; ps = ps->NextQuadrantEntry)
+            {
+                order.push_back(ps);
+            }
+            return order;
+        }
+    };
+
+    // More columns than workers, so a worker waiting for the sort jobs of one column picks up other columns.
+    constexpr size_t kNumColumns = 8;
+    constexpr size_t kNumStructs = 4000;
+    JobPool jobs{ 2 };
+
+    std::mt19937 rng(4321);
+    std::uniform_int_distribution<int32_t> position(0, 64 * kCoordsXYStep);
+    std::uniform_int_distribution<int32_t> size(0, 48);
+    std::uniform_int_distribution<int32_t> height(0, 255);
+
+    std::vector<std::unique_ptr<Column>> columns;
+    for (size_t c = 0; c < kNumColumns; c++)
+    {
+        auto& column = *columns.emplace_back(std::make_unique<Column>());
+        auto session = std::make_unique<PaintSession>();
+        session->CurrentRotation = static_cast<uint8_t>(c % 4);
+        session->QuadrantBackIndex = std::numeric_limits<uint32_t>::max();
+        session->QuadrantFrontIndex = 0;
+        column.Structs.resize(kNumStructs);
+        for (auto& ps : column.Structs)
+        {
+            const auto x = position(rng) + kCoordsXYStep * 32;
+            const auto y = position(rng) + kCoordsXYStep * 32;
+            const auto z = height(rng);
+            ps.Bounds = { x, y, z, x + size(rng), y + size(rng), z + size(rng) };
+            PaintSessionAddPSToQuadrant(*session, &ps);
+        }
+        column.Session = *session;
+        for (const auto& ps : column.Structs)
+        {
+            column.Next.push_back(ps.NextQuadrantEntry);
+        }
+        column.Expected = column.Arrange(nullptr);
+        ASSERT_EQ(column.Expected.size(), kNumStructs);
+    }
+
+    for (int32_t round = 0; round < 20; round++)
+    {
+        std::vector<std::vector<const PaintStruct*>> orders(kNumColumns);
+        for (size_t c = 0; c < kNumColumns; c++)
+        {
+            jobs.AddTask([&column = *columns[c], &order = orders[c], &jobs]() { order = column.Arrange(&jobs); });
+        }
+        jobs.Join();
+
+        for (size_t c = 0; c < kNumColumns; c++)
+        {
+            ASSERT_EQ(orders[c], columns[c]->Expected);
+        }
+    }
+}
+
+TEST_F(PaintArrangeTest, FindFunctions)
+{
+    std::vector<PaintSortFindFunc> findFunctions;
+    if (Platform::SSE41Available())
+    {
+        findFunctions.push_back(PaintSortFindSse4_1);
+    }
+    if (Platform::AVX2Available())
+    {
+        findFunctions.push_back(PaintSortFindAvx2);
+    }
+
+    std::mt19937 rng(5678);
+    std::uniform_int_distribution<int32_t> position(-64, 64);
+    std::uniform_int_distribution<int32_t> size(0, 32);
+    std::uniform_int_distribution<int32_t> flags(0, 15);
+
+    constexpr int32_t count = 67;
+    std::vector<int32_t> x(count), y(count), z(count), xEnd(count), yEnd(count), zEnd(count);
+    std::vector<uint8_t> sortFlags(count);
+    const PaintSortBounds bounds = { x.data(), y.data(), z.data(), xEnd.data(), yEnd.data(), zEnd.data(), sortFlags.data() };
+    for (int32_t iteration = 0; iteration < 1000; iteration++)
+    {
+        for (int32_t i = 0; i < count; i++)
+        {
+            x[i] = position(rng);
+            y[i] = position(rng);
+            z[i] = position(rng);
+            xEnd[i] = x[i] + size(rng);
+            yEnd[i] = y[i] + size(rng);
+            zEnd[i] = z[i] + size(rng);
+            const auto flag = flags(rng);
+            sortFlags[i] = flag == 0 ? PaintSortFlags::OutsideQuadrant : (flag & 1 ? PaintSortFlags::Neighbour : 0);
+        }
+        PaintStructBoundBox initialBBox = { position(rng), position(rng), position(rng), 0, 0, 0 };
+        initialBBox.x_end = initialBBox.x + size(rng);
+        initialBBox.y_end = initialBBox.y + size(rng);
+        initialBBox.z_end = initialBBox.z + size(rng);
+
+        const auto begin = std::uniform_int_distribution<int32_t>(0, count)(rng);
+        for (uint8_t rotation = 0; rotation < 4; rotation++)
+        {
+            const auto expected = PaintSortFindScalar(bounds, begin, count, initialBBox, rotation);
+            for (auto findFn : findFunctions)
+            {
+                ASSERT_EQ(findFn(bounds, begin, count, initialBBox, rotation), expected);
+            }
+        }
+    }
+}
+
+TEST_F(PaintArrangeTest, TestPark)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    auto context = CreateContext();
+    ASSERT_TRUE(context->Initialise());
+    GetContext()->LoadParkFromFile(TestData::GetParkPath("bpb.sv6"));
+
+    // Headless sessions do not generate any images, use the tile elements of diagonal strips of the park
+    // as they would be seen by a viewport column.
+    const auto mapSize = GetGameState().MapSize;
+    for (uint8_t rotation = 0; rotation < 4; rotation++)
+    {
+        for (int32_t strip = -mapSize.x; strip < mapSize.y; strip += 7)
+        {
+            std::vector<PaintStructBoundBox> bounds;
+            for (int32_t x = 0; x < mapSize.x; x++)
+            {
+                for (int32_t y = 0; y < mapSize.y; y++)
+                {
+                    const auto diagonal = (rotation & 1) ? x + y - mapSize.x : y - x;
+                    if (diagonal < strip || diagonal > strip + 1)
+                    {
+                        continue;
+                    }
+
+                    const auto* element = MapGetFirstElementAt(TileCoordsXY{ x, y });
+                    if (element == nullptr)
+                    {
+                        continue;
+                    }
+                    do
+                    {
+                        const auto pos = TileCoordsXY{ x, y }.ToCoordsXY();
+                        bounds.push_back({ pos.x, pos.y, element->GetBaseZ(), pos.x + kCoordsXYStep - 1,
+                                           pos.y + kCoordsXYStep - 1, element->GetClearanceZ() });
+                    } while (!(element++)->IsLastForTile());
+                }
+            }
+
+            Reset(rotation, bounds.size());
+            for (const auto& bbox : bounds)
+            {
+                Add(bbox);
+            }
+            CompareDrawOrder();
+        }
+    }
+}
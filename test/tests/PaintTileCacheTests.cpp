@@ -0,0 +1,284 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <algorithm>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/Context.h>
+#include <openrct2/GameState.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/interface/Viewport.h>
+#include <openrct2/paint/Paint.TileCache.h>
+#include <openrct2/paint/Paint.h>
+#include <openrct2/profiling/Profiling.h>
+#include <openrct2/util/Math.hpp>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/TileElement.h>
+#include <openrct2/world/TileElementsView.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+static constexpr uint32_t kViewFlags[] = {
+    VIEWPORT_FLAG_NONE,
+    VIEWPORT_FLAG_UNDERGROUND_INSIDE | VIEWPORT_FLAG_HIDE_VEGETATION,
+    VIEWPORT_FLAG_INVISIBLE_PATHS | VIEWPORT_FLAG_LAND_HEIGHTS,
+};
+
+// Paint structs of different sessions can not be compared directly, describe everything but the pointers to other
+// paint structs instead.
+static void DescribePaintStruct(std::vector<std::string>& painted, const PaintStruct* ps, int32_t depth)
+{
+    for (; ps != nullptr; ps = ps->Children, depth++)
+    {
+        std::ostringstream description;
+        description << depth << ": image " << ps->image_id.ToUInt32() << " bounds " << ps->Bounds.x << "," << ps->Bounds.y
+                    << "," << ps->Bounds.z << " - " << ps->Bounds.x_end << "," << ps->Bounds.y_end << ","
+                    << ps->Bounds.z_end << " at " << ps->ScreenPos.x << "," << ps->ScreenPos.y << " tile "
+                    << ps->MapPos.x << "," << ps->MapPos.y << " element " << ps->Element << " entity " << ps->Entity
+                    << " interaction " << static_cast<int32_t>(ps->InteractionItem);
+        for (const auto* attached = ps->Attached; attached != nullptr; attached = attached->NextEntry)
+        {
+            description << " attached " << attached->image_id.ToUInt32() << "/" << attached->ColourImageId.ToUInt32()
+                        << " at " << attached->RelativePos.x << "," << attached->RelativePos.y << " masked "
+                        << attached->IsMasked;
+        }
+        painted.push_back(description.str());
+    }
+}
+
+static uint64_t GetTileCacheHits()
+{
+    Profiling::EndFrame();
+    for (const auto* counter : Profiling::GetCounters())
+    {
+        if (std::strcmp(counter->GetName(), "Paint tile cache hits") == 0)
+        {
+            return counter->GetLastFrameValue();
+        }
+    }
+    return 0;
+}
+
+class PaintTileCacheTest : public testing::Test
+{
+protected:
+    static std::unique_ptr<IContext> _context;
+    static TileCoordsXY _pathTile;
+
+    static void SetUpTestCase()
+    {
+        // Images are only added with graphics loaded, without them there would be nothing to cache.
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = false;
+        _context = CreateContext();
+        ASSERT_TRUE(_context->Initialise());
+        ASSERT_TRUE(_context->LoadParkFromFile(TestData::GetParkPath("bpb.sv6")));
+
+        // Any path near the middle of the park, the tiles around it have plenty of scenery and rides.
+        const auto mapSize = GetGameState().MapSize;
+        for (int32_t y = mapSize.y / 2; y < mapSize.y && _pathTile.IsNull(); y++)
+        {
+            for (int32_t x = mapSize.x / 2; x < mapSize.x && _pathTile.IsNull(); x++)
+            {
+                if (FindPath({ x, y }) != nullptr)
+                {
+                    _pathTile = { x, y };
+                }
+            }
+        }
+    }
+
+    static PathElement* FindPath(const TileCoordsXY& tile)
+    {
+        for (auto* path : TileElementsView<PathElement>(tile.ToCoordsXY()))
+        {
+            return path;
+        }
+        return nullptr;
+    }
+
+    static void TearDownTestCase()
+    {
+        _context = nullptr;
+        gOpenRCT2NoGraphics = true;
+    }
+
+    void SetUp() override
+    {
+        ASSERT_FALSE(_pathTile.IsNull());
+
+        // The cache is only used by sessions of a game that is drawn to the screen.
+        gOpenRCT2Headless = false;
+        Profiling::Enable();
+    }
+
+    void TearDown() override
+    {
+        Profiling::Disable();
+        gOpenRCT2Headless = true;
+    }
+
+    static std::vector<std::string> Paint(uint8_t rotation, ZoomLevel zoom, uint32_t viewFlags, bool useTileCache)
+    {
+        // Paint the area around the path tile in viewport columns, like ViewportRender does.
+        constexpr int32_t kSize = 1024;
+        const auto* pathElement = MapGetFirstElementAt(_pathTile);
+        const auto centre = Translate3DTo2DWithZ(
+            rotation, CoordsXYZ{ _pathTile.ToCoordsXY().ToTileCentre(), pathElement->GetBaseZ() });
+
+        DrawPixelInfo dpi{};
+        dpi.x = zoom.ApplyInversedTo(centre.x - kSize / 2);
+        dpi.y = zoom.ApplyInversedTo(centre.y - kSize / 2);
+        dpi.width = zoom.ApplyInversedTo(kSize);
+        dpi.height = zoom.ApplyInversedTo(kSize);
+        dpi.zoom_level = zoom;
+
+        std::vector<std::string> painted;
+        const int32_t columnWidth = zoom.ApplyInversedTo(kCoordsXYStep);
+        for (int32_t x = Floor2(dpi.x, columnWidth); x < dpi.x + dpi.width; x += columnWidth)
+        {
+            auto columnDpi = dpi;
+            columnDpi.x = std::max(x, dpi.x);
+            columnDpi.width = std::min(x + columnWidth, dpi.x + dpi.width) - columnDpi.x;
+
+            auto* session = PaintSessionAlloc(columnDpi, viewFlags, rotation);
+            PaintTileCacheBeginSession(*session);
+            EXPECT_TRUE(session->UseTileCache);
+            session->UseTileCache = useTileCache;
+
+            PaintSessionGenerate(*session);
+            PaintSessionArrange(*session);
+            for (const auto* ps = session->PaintHead; ps != nullptr; ps = ps->NextQuadrantEntry)
+            {
+                DescribePaintStruct(painted, ps, 0);
+            }
+            PaintSessionFree(session);
+        }
+        return painted;
+    }
+
+    static std::vector<std::string> Pick(uint8_t rotation, ZoomLevel zoom, uint32_t viewFlags, bool useTileCache)
+    {
+        // Query pixels around the path tile with single pixel sessions, like GetMapCoordinatesFromPosWindow does.
+        constexpr int32_t kSize = 128;
+        constexpr int32_t kStep = 9;
+        const auto* pathElement = MapGetFirstElementAt(_pathTile);
+        const auto centre = Translate3DTo2DWithZ(
+            rotation, CoordsXYZ{ _pathTile.ToCoordsXY().ToTileCentre(), pathElement->GetBaseZ() });
+
+        std::vector<std::string> picked;
+        for (int32_t y = -kSize / 2; y < kSize / 2; y += kStep)
+        {
+            for (int32_t x = -kSize / 2; x < kSize / 2; x += kStep)
+            {
+                DrawPixelInfo dpi{};
+                dpi.x = zoom.ApplyInversedTo(centre.x) + x;
+                dpi.y = zoom.ApplyInversedTo(centre.y) + y;
+                dpi.width = 1;
+                dpi.height = 1;
+                dpi.zoom_level = zoom;
+
+                auto* session = PaintSessionAlloc(dpi, viewFlags, rotation);
+                PaintTileCacheBeginSession(*session);
+                EXPECT_TRUE(session->UseTileCache);
+                session->UseTileCache = useTileCache;
+
+                PaintSessionGenerate(*session);
+                PaintSessionArrange(*session);
+                for (const auto* ps = session->PaintHead; ps != nullptr; ps = ps->NextQuadrantEntry)
+                {
+                    DescribePaintStruct(picked, ps, 0);
+                }
+
+                const auto info = SetInteractionInfoFromPaintSession(session, viewFlags, 0xFFFF);
+                std::ostringstream description;
+                description << "picked " << x << "," << y << ": " << static_cast<int32_t>(info.interactionType) << " at "
+                            << info.Loc.x << "," << info.Loc.y << " element " << info.Element << " entity " << info.Entity;
+                picked.push_back(description.str());
+                PaintSessionFree(session);
+            }
+        }
+        return picked;
+    }
+
+    // Paints every combination of rotation, zoom and view flags from the cache and without it.
+    template<typename TPaint> static void CompareWithFreshPaint(TPaint&& paint)
+    {
+        for (uint8_t rotation = 0; rotation < 4; rotation++)
+        {
+            for (auto zoom : { ZoomLevel{ 0 }, ZoomLevel{ 1 }, ZoomLevel{ 2 } })
+            {
+                for (auto viewFlags : kViewFlags)
+                {
+                    const auto fresh = paint(rotation, zoom, viewFlags, false);
+                    ASSERT_FALSE(fresh.empty());
+                    ASSERT_EQ(paint(rotation, zoom, viewFlags, true), fresh)
+                        << "rotation " << static_cast<int32_t>(rotation) << " zoom "
+                        << static_cast<int32_t>(static_cast<int8_t>(zoom)) << " flags " << viewFlags;
+                }
+            }
+        }
+    }
+};
+
+std::unique_ptr<IContext> PaintTileCacheTest::_context;
+TileCoordsXY PaintTileCacheTest::_pathTile{ kCoordsNull, kCoordsNull };
+
+TEST_F(PaintTileCacheTest, ReplayMatchesFreshPaint)
+{
+    // The first pass records the tiles, the second one replays them.
+    CompareWithFreshPaint(Paint);
+    GetTileCacheHits();
+    CompareWithFreshPaint(Paint);
+    ASSERT_GT(GetTileCacheHits(), 0u);
+}
+
+TEST_F(PaintTileCacheTest, ReplayAfterTileEdits)
+{
+    CompareWithFreshPaint(Paint);
+
+    // Modified through a setter, which only records the change for the next publish.
+    auto* path = FindPath(_pathTile);
+    path->SetEdges(path->GetEdges() ^ 0b0101);
+    MapInvalidateElementCaches();
+    CompareWithFreshPaint(Paint);
+
+    // Modified directly and invalidated like game actions do, the neighbouring surfaces show the new edges.
+    const auto neighbour = _pathTile + TileCoordsXY{ 1, 0 };
+    auto* surface = MapGetSurfaceElementAt(neighbour);
+    ASSERT_NE(surface, nullptr);
+    surface->SetBaseZ(surface->GetBaseZ() + 2 * kCoordsZStep);
+    surface->SetClearanceZ(surface->GetClearanceZ() + 2 * kCoordsZStep);
+    MapInvalidateTileFull(neighbour.ToCoordsXY());
+    CompareWithFreshPaint(Paint);
+
+    GetTileCacheHits();
+    CompareWithFreshPaint(Paint);
+    ASSERT_GT(GetTileCacheHits(), 0u);
+}
+
+TEST_F(PaintTileCacheTest, PickingMatchesFreshPaint)
+{
+    // Moving across the same pixels again replays the tiles of the earlier queries.
+    CompareWithFreshPaint(Pick);
+    GetTileCacheHits();
+    CompareWithFreshPaint(Pick);
+    ASSERT_GT(GetTileCacheHits(), 0u);
+
+    auto* path = FindPath(_pathTile);
+    path->SetEdges(path->GetEdges() ^ 0b1010);
+    MapInvalidateElementCaches();
+    CompareWithFreshPaint(Pick);
+}
@@ -9,14 +9,18 @@
 #include <memory>
 #include <openrct2/Context.h>
 #include <openrct2/Game.h>
+#include <openrct2/GameState.h>
 #include <openrct2/OpenRCT2.h>
 #include <openrct2/ParkImporter.h>
 #include <openrct2/core/String.hpp>
 #include <openrct2/platform/Platform.h>
 #include <openrct2/world/Footpath.h>
 #include <openrct2/world/Map.h>
+#include <openrct2/world/TileElementsView.h>
 #include <ostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -252,3 +256,144 @@ INSTANTIATE_TEST_SUITE_P(
         SimplePathfindingScenario("PathWithFences", { 11, 6, 14 }, 10000),
         SimplePathfindingScenario("PathWithCliff", { 7, 17, 14 }, 10000)),
     SimplePathfindingScenario::ToName);
+
+class FootpathGraphTest : public PathfindingTestBase
+{
+protected:
+    void TearDown() override
+    {
+        PathFinding::SetFootpathGraphEnabled(true);
+    }
+
+    static Direction ChooseDirection(
+        const TileCoordsXYZ& pos, const TileCoordsXYZ& goal, bool graphEnabled, bool ignoreForeignQueues, RideId rideId)
+    {
+        PathFinding::SetFootpathGraphEnabled(graphEnabled);
+        auto* peep = Guest::Generate(pos.ToCoordsXYZ().ToTileCentre());
+        peep->OutsideOfPark = false;
+        const auto direction = PathFinding::ChooseDirection(pos, goal, *peep, ignoreForeignQueues, rideId);
+        PeepEntityRemove(peep);
+        return direction;
+    }
+};
+
+TEST_F(FootpathGraphTest, ChoosesSameDirectionsAsTileSearch)
+{
+    std::vector<std::pair<TileCoordsXYZ, RideId>> goals;
+    for (auto& ride : GetRideManager())
+    {
+        const auto entrance = ride.GetStation().Entrance;
+        if (!entrance.IsNull())
+        {
+            goals.emplace_back(
+                TileCoordsXYZ(
+                    entrance.x - TileDirectionDelta[entrance.direction].x,
+                    entrance.y - TileDirectionDelta[entrance.direction].y, entrance.z),
+                ride.id);
+        }
+    }
+    ASSERT_FALSE(goals.empty());
+
+    const auto mapSize = GetGameState().MapSize;
+    size_t searches = 0;
+    for (int32_t x = 0; x < mapSize.x; x++)
+    {
+        for (int32_t y = 0; y < mapSize.y; y++)
+        {
+            for (auto* pathElement : TileElementsView<PathElement>(TileCoordsXY{ x, y }.ToCoordsXY()))
+            {
+                const TileCoordsXYZ pos{ x, y, pathElement->BaseHeight };
+                for (const auto& [goal, rideId] : goals)
+                {
+                    for (bool ignoreForeignQueues : { false, true })
+                    {
+                        const auto expected = ChooseDirection(pos, goal, false, ignoreForeignQueues, rideId);
+                        const auto actual = ChooseDirection(pos, goal, true, ignoreForeignQueues, rideId);
+                        ASSERT_EQ(actual, expected) << "from " << pos << " to " << goal;
+                        searches++;
+                    }
+                }
+            }
+        }
+    }
+    ASSERT_GT(searches, 0u);
+}
+
+class DirectionCacheTest : public PathfindingTestBase
+{
+protected:
+    void TearDown() override
+    {
+        PathFinding::SetDirectionCacheEnabled(true);
+        PathFinding::ResetDirectionCacheStats();
+    }
+
+    static Direction ChooseDirection(const TileCoordsXYZ& pos, const TileCoordsXYZ& goal, RideId rideId)
+    {
+        auto* peep = Guest::Generate(pos.ToCoordsXYZ().ToTileCentre());
+        peep->OutsideOfPark = false;
+        const auto direction = PathFinding::ChooseDirection(pos, goal, *peep, false, rideId);
+        PeepEntityRemove(peep);
+        return direction;
+    }
+};
+
+TEST_F(DirectionCacheTest, CachedDirectionsMatchSearch)
+{
+    std::vector<std::pair<TileCoordsXYZ, RideId>> goals;
+    for (auto& ride : GetRideManager())
+    {
+        const auto entrance = ride.GetStation().Entrance;
+        if (!entrance.IsNull())
+        {
+            goals.emplace_back(
+                TileCoordsXYZ(
+                    entrance.x - TileDirectionDelta[entrance.direction].x,
+                    entrance.y - TileDirectionDelta[entrance.direction].y, entrance.z),
+                ride.id);
+        }
+    }
+    ASSERT_FALSE(goals.empty());
+
+    PathFinding::ResetDirectionCacheStats();
+    const auto mapSize = GetGameState().MapSize;
+    for (int32_t x = 0; x < mapSize.x; x++)
+    {
+        for (int32_t y = 0; y < mapSize.y; y++)
+        {
+            for (auto* pathElement : TileElementsView<PathElement>(TileCoordsXY{ x, y }.ToCoordsXY()))
+            {
+                const TileCoordsXYZ pos{ x, y, pathElement->BaseHeight };
+                for (const auto& [goal, rideId] : goals)
+                {
+                    PathFinding::SetDirectionCacheEnabled(false);
+                    const auto expected = ChooseDirection(pos, goal, rideId);
+
+                    // The first search fills the cache, the second is answered from it.
+                    PathFinding::SetDirectionCacheEnabled(true);
+                    ASSERT_EQ(ChooseDirection(pos, goal, rideId), expected) << "from " << pos << " to " << goal;
+                    ASSERT_EQ(ChooseDirection(pos, goal, rideId), expected) << "from " << pos << " to " << goal;
+                }
+            }
+        }
+    }
+
+    const auto stats = PathFinding::GetDirectionCacheStats();
+    ASSERT_GT(stats.Hits, 0u);
+    ASSERT_EQ(stats.Hits, stats.Misses);
+
+    // Changes to elements the search does not read keep the cached directions.
+    const auto& [goal, rideId] = goals.front();
+    auto* surfaceElement = MapGetSurfaceElementAt(goal.ToCoordsXY());
+    ASSERT_NE(surfaceElement, nullptr);
+    surfaceElement->SetOwner(surfaceElement->GetOwner());
+    MapInvalidateElementCaches();
+    ASSERT_GT(PathFinding::GetDirectionCacheStats().Entries, 0u);
+
+    // Editing a path forgets every cached direction.
+    auto* pathElement = MapGetPathElementAt(goal);
+    ASSERT_NE(pathElement, nullptr);
+    pathElement->SetEdges(pathElement->GetEdges());
+    MapInvalidateElementCaches();
+    ASSERT_EQ(PathFinding::GetDirectionCacheStats().Entries, 0u);
+}
@@ -0,0 +1,133 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/actions/RideFreezeRatingAction.h>
+#include <openrct2/ride/Ride.h>
+#include <openrct2/ride/RideOccupancy.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/TileElementsView.h>
+#include <openrct2/world/tile_element/TrackElement.h>
+
+using namespace OpenRCT2;
+
+static RideOccupancy::RideSet GetRidesNearByScan(const TileCoordsXY& centre, int32_t radius)
+{
+    RideOccupancy::RideSet rides;
+    for (int32_t y = centre.y - radius; y <= centre.y + radius; y++)
+    {
+        for (int32_t x = centre.x - radius; x <= centre.x + radius; x++)
+        {
+            if (x < 0 || y < 0 || x >= kMaximumMapSizeTechnical || y >= kMaximumMapSizeTechnical)
+                continue;
+
+            for (auto* trackElement : TileElementsView<TrackElement>(TileCoordsXY{ x, y }.ToCoordsXY()))
+            {
+                auto rideIndex = trackElement->GetRideIndex();
+                if (!rideIndex.IsNull())
+                {
+                    rides[rideIndex.ToUnderlying()] = true;
+                }
+            }
+        }
+    }
+    return rides;
+}
+
+static RideOccupancy::RideSet GetTallRidesByScan()
+{
+    RideOccupancy::RideSet rides;
+    for (auto& ride : GetRideManager())
+    {
+        if (ride.highest_drop_height > 66 || ride.ratings.excitement >= RIDE_RATING(8, 00))
+        {
+            rides[ride.id.ToUnderlying()] = true;
+        }
+    }
+    return rides;
+}
+
+static RideOccupancy::RideSet GetTallRides()
+{
+    RideOccupancy::RideSet rides;
+    RideOccupancy::AddTallRides(rides);
+    return rides;
+}
+
+static void CheckRidesNear(int32_t mapSize)
+{
+    constexpr int32_t kRadius = 10;
+    for (int32_t y = -kRadius - 2; y < mapSize + kRadius + 2; y += 3)
+    {
+        for (int32_t x = -kRadius - 2; x < mapSize + kRadius + 2; x += 3)
+        {
+            const TileCoordsXY centre{ x, y };
+            RideOccupancy::RideSet rides;
+            RideOccupancy::AddRidesNear(rides, centre, kRadius);
+            ASSERT_EQ(rides.data(), GetRidesNearByScan(centre, kRadius).data()) << "at " << x << ", " << y;
+        }
+    }
+}
+
+TEST(RideOccupancyTest, RidesNearMatchTileScan)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    auto context = CreateContext();
+    ASSERT_TRUE(context->Initialise());
+    ASSERT_TRUE(context->LoadParkFromFile(TestData::GetParkPath("bpb.sv6")));
+
+    const auto mapSize = GetMapSizeUnits().x / kCoordsXYStep + 1;
+    CheckRidesNear(mapSize);
+
+    // Rebuilt blocks must give the same answer.
+    RideOccupancy::Invalidate();
+    CheckRidesNear(mapSize);
+
+    // Moving a piece of track to another ride only forgets its own block, which has to pick up the change.
+    TrackElement* trackElement = nullptr;
+    for (int32_t y = 0; y < mapSize && trackElement == nullptr; y++)
+    {
+        for (int32_t x = 0; x < mapSize && trackElement == nullptr; x++)
+        {
+            for (auto* element : TileElementsView<TrackElement>(TileCoordsXY{ x, y }.ToCoordsXY()))
+            {
+                trackElement = element;
+                break;
+            }
+        }
+    }
+    ASSERT_NE(trackElement, nullptr);
+    trackElement->SetRideIndex(RideId::FromUnderlying(Limits::kMaxRidesInPark - 1));
+    MapInvalidateElementCaches();
+    CheckRidesNear(mapSize);
+
+    ASSERT_EQ(GetTallRides().data(), GetTallRidesByScan().data());
+
+    // Raising the excitement of a ride has to be picked up without touching any tile.
+    Ride* calmRide = nullptr;
+    for (auto& ride : GetRideManager())
+    {
+        if (!GetTallRides()[ride.id.ToUnderlying()])
+        {
+            calmRide = &ride;
+            break;
+        }
+    }
+    ASSERT_NE(calmRide, nullptr);
+    auto freezeAction = RideFreezeRatingAction(calmRide->id, RideRatingType::Excitement, RIDE_RATING(9, 00));
+    ASSERT_EQ(GameActions::Execute(&freezeAction).Error, GameActions::Status::Ok);
+    ASSERT_TRUE(GetTallRides()[calmRide->id.ToUnderlying()]);
+    ASSERT_EQ(GetTallRides().data(), GetTallRidesByScan().data());
+}
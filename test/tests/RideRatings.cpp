@@ -20,7 +20,9 @@
 #include <openrct2/platform/Platform.h>
 #include <openrct2/ride/Ride.h>
 #include <openrct2/ride/RideData.h>
+#include <openrct2/world/Map.h>
 #include <string>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -35,6 +37,16 @@ protected:
         }
     }
 
+    void CalculateRatingsForAllRidesInBatch()
+    {
+        std::vector<RideId> rides;
+        for (const auto& ride : GetRideManager())
+        {
+            rides.push_back(ride.id);
+        }
+        RideRatingsUpdateRides(rides);
+    }
+
     void DumpRatings()
     {
         for (const auto& ride : GetRideManager())
@@ -53,7 +65,7 @@ protected:
         return line;
     }
 
-    void TestRatings(const u8string& parkFile, uint16_t expectedRideCount)
+    void TestRatings(const u8string& parkFile, uint16_t expectedRideCount, bool batch = false)
     {
         const auto parkFilePath = TestData::GetParkPath(parkFile);
         const auto ratingsDataPath = Path::Combine(TestData::GetBasePath(), u8"ratings", parkFile + u8".txt");
@@ -74,7 +86,10 @@ protected:
         // Check ride count to check load was successful
         ASSERT_EQ(RideGetCount(), expectedRideCount);
 
-        CalculateRatingsForAllRides();
+        if (batch)
+            CalculateRatingsForAllRidesInBatch();
+        else
+            CalculateRatingsForAllRides();
 
         // Check ride ratings
         int expI = 0;
@@ -103,3 +118,84 @@ TEST_F(RideRatings, EverythingPark)
 {
     TestRatings("EverythingPark.park", 529);
 }
+
+TEST_F(RideRatings, bpbBatch)
+{
+    TestRatings("bpb.sv6", 134, true);
+}
+
+TEST_F(RideRatings, EverythingParkBatch)
+{
+    TestRatings("EverythingPark.park", 529, true);
+}
+
+TEST_F(RideRatings, TrackGraphMatchesTileScan)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    auto context = CreateContext();
+    ASSERT_TRUE(context->Initialise());
+    GetContext()->LoadParkFromFile(TestData::GetParkPath("bpb.sv6"));
+
+    // Copies of track elements are never remembered, which gives the result of scanning the tiles.
+    const auto mapSize = GetMapSizeUnits();
+    size_t connections = 0;
+    // The second pass is answered from the connections remembered during the first.
+    for (int32_t pass = 0; pass < 2; pass++)
+    {
+        for (int32_t x = 0; x < mapSize.x; x += kCoordsXYStep)
+        {
+            for (int32_t y = 0; y < mapSize.y; y += kCoordsXYStep)
+            {
+                auto* tileElement = MapGetFirstElementAt(CoordsXY{ x, y });
+                if (tileElement == nullptr)
+                    continue;
+                do
+                {
+                    if (tileElement->GetType() != TileElementType::Track)
+                        continue;
+
+                    auto copy = *tileElement;
+                    CoordsXYE expectedInput = { x, y, &copy };
+                    CoordsXYE expectedNext;
+                    int32_t expectedZ = 0;
+                    int32_t expectedDirection = 0;
+                    const bool expectedFound = TrackBlockGetNext(&expectedInput, &expectedNext, &expectedZ, &expectedDirection);
+
+                    CoordsXYE input = { x, y, tileElement };
+                    CoordsXYE next;
+                    int32_t z = 0;
+                    int32_t direction = 0;
+                    ASSERT_EQ(TrackBlockGetNext(&input, &next, &z, &direction), expectedFound);
+                    if (expectedFound)
+                    {
+                        ASSERT_EQ(next.element, expectedNext.element);
+                        ASSERT_EQ(next.x, expectedNext.x);
+                        ASSERT_EQ(next.y, expectedNext.y);
+                        ASSERT_EQ(z, expectedZ);
+                        ASSERT_EQ(direction, expectedDirection);
+                        connections++;
+                    }
+
+                    TrackBeginEnd expectedPrevious{};
+                    TrackBeginEnd previous{};
+                    const bool expectedPreviousFound = TrackBlockGetPrevious({ x, y, &copy }, &expectedPrevious);
+                    ASSERT_EQ(TrackBlockGetPrevious({ x, y, tileElement }, &previous), expectedPreviousFound);
+                    if (expectedPreviousFound)
+                    {
+                        ASSERT_EQ(previous.begin_element, expectedPrevious.begin_element);
+                        ASSERT_EQ(previous.begin_x, expectedPrevious.begin_x);
+                        ASSERT_EQ(previous.begin_y, expectedPrevious.begin_y);
+                        ASSERT_EQ(previous.begin_z, expectedPrevious.begin_z);
+                        ASSERT_EQ(previous.begin_direction, expectedPrevious.begin_direction);
+                        ASSERT_EQ(previous.end_x, expectedPrevious.end_x);
+                        ASSERT_EQ(previous.end_y, expectedPrevious.end_y);
+                        ASSERT_EQ(previous.end_direction, expectedPrevious.end_direction);
+                    }
+                } while (!(tileElement++)->IsLastForTile());
+            }
+        }
+    }
+    ASSERT_GT(connections, 0u);
+}
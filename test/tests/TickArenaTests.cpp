@@ -0,0 +1,69 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <openrct2/core/TickArena.h>
+
+using namespace OpenRCT2;
+
+static void FillVector(size_t count)
+{
+    TickVector<uint64_t> values;
+    for (size_t i = 0; i < count; i++)
+    {
+        values.push_back(i);
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        ASSERT_EQ(values[i], i);
+    }
+}
+
+TEST(TickArenaTest, ReusesMemoryBetweenTicks)
+{
+    TickArena::BeginTick();
+    FillVector(100000);
+    ASSERT_GT(TickArena::GetBytesUsed(), 0u);
+    TickArena::EndTick();
+    const auto capacity = TickArena::GetCapacity();
+
+    for (int32_t tick = 0; tick < 10; tick++)
+    {
+        TickArena::BeginTick();
+        ASSERT_EQ(TickArena::GetBytesUsed(), 0u);
+        FillVector(100000);
+        TickArena::EndTick();
+        ASSERT_EQ(TickArena::GetCapacity(), capacity);
+    }
+}
+
+TEST(TickArenaTest, AllocationsAreAligned)
+{
+    TickArena::BeginTick();
+    for (size_t alignment : { 1, 2, 8, 16, 64, 256 })
+    {
+        auto* ptr = TickArena::Allocate(3, alignment);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0u);
+        TickArena::Deallocate(ptr, alignment);
+    }
+    TickArena::EndTick();
+}
+
+TEST(TickArenaTest, UsesHeapOutsideOfTick)
+{
+    TickArena::BeginTick();
+    TickArena::EndTick();
+    const auto capacity = TickArena::GetCapacity();
+
+    ASSERT_FALSE(TickArena::IsInTick());
+    FillVector(100000);
+    ASSERT_EQ(TickArena::GetBytesUsed(), 0u);
+    ASSERT_EQ(TickArena::GetCapacity(), capacity);
+}
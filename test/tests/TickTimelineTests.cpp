@@ -0,0 +1,62 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/profiling/TickTimeline.h>
+
+using namespace OpenRCT2::Profiling;
+
+static void RecordTick(uint32_t tick)
+{
+    TickTimeline::BeginTick(tick);
+    TickTimeline::BeginPhase(TickTimeline::Phase::Date);
+    TickTimeline::BeginPhase(TickTimeline::Phase::Peeps);
+    TickTimeline::EndTick({ static_cast<uint16_t>(tick), 0, 0, 0 });
+}
+
+TEST(TickTimelineTest, KeepsLastTicksInOrder)
+{
+    TickTimeline::Start(3);
+    for (uint32_t tick = 0; tick < 5; tick++)
+    {
+        RecordTick(tick);
+    }
+    TickTimeline::Stop();
+
+    // Nothing is recorded after stopping.
+    RecordTick(5);
+
+    const auto records = TickTimeline::GetRecords();
+    ASSERT_EQ(records.size(), 3u);
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const auto& record = records[i];
+        ASSERT_EQ(record.Tick, i + 2);
+        ASSERT_EQ(record.Entities.Guests, i + 2);
+        ASSERT_GE(record.PhaseUs[static_cast<size_t>(TickTimeline::Phase::Peeps)], 0.0);
+        ASSERT_EQ(record.PhaseUs[static_cast<size_t>(TickTimeline::Phase::Vehicles)], 0.0);
+        if (i > 0)
+        {
+            ASSERT_GE(record.StartUs, records[i - 1].StartUs);
+        }
+    }
+}
+
+TEST(TickTimelineTest, TickWithoutEndIsReplaced)
+{
+    TickTimeline::Start(8);
+    TickTimeline::BeginTick(1);
+    TickTimeline::BeginPhase(TickTimeline::Phase::Network);
+    RecordTick(1);
+    TickTimeline::Stop();
+
+    const auto records = TickTimeline::GetRecords();
+    ASSERT_EQ(records.size(), 1u);
+    ASSERT_EQ(records[0].PhaseUs[static_cast<size_t>(TickTimeline::Phase::Network)], 0.0);
+}
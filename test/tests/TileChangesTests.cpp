@@ -0,0 +1,210 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/TileChanges.h>
+#include <openrct2/world/TileElement.h>
+#include <openrct2/world/tile_element/WallElement.h>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class TileChangesTests : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        ASSERT_TRUE(_context->Initialise());
+
+        ASSERT_TRUE(GetContext()->LoadParkFromFile(TestData::GetParkPath("tile-element-tests.sv6")));
+        GameLoadInit();
+        TileChanges::Publish();
+    }
+
+    void TearDown() override
+    {
+        _context.reset();
+    }
+
+private:
+    std::unique_ptr<IContext> _context;
+};
+
+TEST_F(TileChangesTests, LoadingChangesAllTiles)
+{
+    ASSERT_TRUE(GetContext()->LoadParkFromFile(TestData::GetParkPath("tile-element-tests.sv6")));
+    EXPECT_TRUE(TileChanges::GetPending().AllTilesChanged);
+    EXPECT_TRUE(TileChanges::IsTileDirty({ 1, 1 }));
+
+    TileChanges::Publish();
+    EXPECT_FALSE(TileChanges::GetPending().AllTilesChanged);
+    EXPECT_FALSE(TileChanges::IsTileDirty({ 1, 1 }));
+}
+
+TEST_F(TileChangesTests, InsertModifyAndRemoveAreRecorded)
+{
+    const auto coords = TileCoordsXY{ 10, 10 };
+    EXPECT_FALSE(TileChanges::IsTileDirty(coords));
+
+    std::vector<TileChanges::Change> received;
+    auto cookie = TileChanges::Subscribe([&received](const TileChanges::ChangeSet& changeSet) {
+        received.insert(received.end(), changeSet.Changes.begin(), changeSet.Changes.end());
+    });
+
+    auto* wall = TileElementInsert<WallElement>(TileCoordsXYZ{ coords, 100 }.ToCoordsXYZ(), 0b0001);
+    ASSERT_NE(wall, nullptr);
+    wall->SetDirection(2);
+    EXPECT_TRUE(TileChanges::IsTileDirty(coords));
+    EXPECT_FALSE(TileChanges::IsTileDirty({ 11, 10 }));
+
+    wall->SetBaseZ(101 * kCoordsZStep);
+    TileElementRemove(reinterpret_cast<TileElement*>(wall));
+    TileChanges::Unsubscribe(cookie);
+
+    // Inserts and removals are published straight away, together with anything recorded before them.
+    EXPECT_TRUE(TileChanges::GetPending().Changes.empty());
+    EXPECT_FALSE(TileChanges::IsTileDirty(coords));
+    ASSERT_EQ(received.size(), 3u);
+    EXPECT_EQ(received[0].Coords, coords);
+    EXPECT_EQ(received[0].ElementType, TileElementType::Wall);
+    EXPECT_EQ(received[0].Kind, TileChanges::ChangeKind::Inserted);
+    EXPECT_EQ(received[1].Coords, coords);
+    EXPECT_EQ(received[1].ElementType, TileElementType::Wall);
+    EXPECT_EQ(received[1].Kind, TileChanges::ChangeKind::Modified);
+    EXPECT_EQ(received[2].Coords, coords);
+    EXPECT_EQ(received[2].ElementType, TileElementType::Wall);
+    EXPECT_EQ(received[2].Kind, TileChanges::ChangeKind::Removed);
+}
+
+TEST_F(TileChangesTests, ChangingTheTypeRecordsBothTypes)
+{
+    const auto coords = TileCoordsXY{ 10, 10 };
+    auto* wall = TileElementInsert<WallElement>(TileCoordsXYZ{ coords, 100 }.ToCoordsXYZ(), 0b0001);
+    ASSERT_NE(wall, nullptr);
+    TileChanges::Publish();
+
+    wall->SetType(TileElementType::Banner);
+    const auto& changes = TileChanges::GetPending().Changes;
+    ASSERT_EQ(changes.size(), 2u);
+    EXPECT_EQ(changes[0].ElementType, TileElementType::Wall);
+    EXPECT_EQ(changes[1].ElementType, TileElementType::Banner);
+    TileElementRemove(reinterpret_cast<TileElement*>(wall));
+}
+
+TEST_F(TileChangesTests, PublishingFromAListenerIsIgnored)
+{
+    int32_t calls = 0;
+    auto cookie = TileChanges::Subscribe([&calls](const TileChanges::ChangeSet&) {
+        calls++;
+        auto* surface = MapGetSurfaceElementAt(TileCoordsXY{ 12, 12 });
+        surface->SetOwner(surface->GetOwner());
+        TileChanges::Publish();
+    });
+
+    auto* surface = MapGetSurfaceElementAt(TileCoordsXY{ 12, 12 });
+    ASSERT_NE(surface, nullptr);
+    surface->SetOwner(surface->GetOwner());
+    TileChanges::Publish();
+    EXPECT_EQ(calls, 1);
+    EXPECT_TRUE(TileChanges::IsTileDirty({ 12, 12 }));
+    TileChanges::Unsubscribe(cookie);
+}
+
+TEST_F(TileChangesTests, SwappingInTemporaryElementsIsNotRecorded)
+{
+    const auto coords = TileCoordsXY{ 10, 10 };
+    int32_t calls = 0;
+    auto cookie = TileChanges::Subscribe([&calls](const TileChanges::ChangeSet&) { calls++; });
+
+    auto* mapElements = MapGetFirstElementAt(coords);
+    ASSERT_NE(mapElements, nullptr);
+    TileElement temporaryElement{};
+    temporaryElement.SetType(TileElementType::Track);
+    temporaryElement.SetLastForTile(true);
+    MapSetTileElement(coords, &temporaryElement);
+    MapSetTileElement(coords, mapElements);
+    EXPECT_EQ(calls, 0);
+    EXPECT_FALSE(TileChanges::IsTileDirty(coords));
+
+    // Clearing a tile is a change to the map.
+    MapSetTileElement(coords, nullptr);
+    EXPECT_EQ(calls, 1);
+    MapSetTileElement(coords, mapElements);
+    EXPECT_EQ(calls, 2);
+    TileChanges::Unsubscribe(cookie);
+}
+
+TEST_F(TileChangesTests, ElementsOutsideTheMapAreNotRecorded)
+{
+    TileElement element{};
+    element.SetType(TileElementType::Path);
+    element.SetBaseZ(14 * kCoordsZStep);
+    EXPECT_TRUE(TileChanges::GetPending().Changes.empty());
+}
+
+TEST_F(TileChangesTests, ListenersReceivePublishedChanges)
+{
+    const auto coords = TileCoordsXY{ 12, 12 };
+    std::vector<TileChanges::Change> received;
+    auto cookie = TileChanges::Subscribe([&received](const TileChanges::ChangeSet& changeSet) {
+        received.insert(received.end(), changeSet.Changes.begin(), changeSet.Changes.end());
+    });
+
+    auto* surface = MapGetSurfaceElementAt(coords);
+    ASSERT_NE(surface, nullptr);
+    surface->SetOwner(surface->GetOwner());
+    TileChanges::Publish();
+
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0].Coords, coords);
+    EXPECT_EQ(received[0].ElementType, TileElementType::Surface);
+    EXPECT_EQ(received[0].Kind, TileChanges::ChangeKind::Modified);
+    EXPECT_FALSE(TileChanges::IsTileDirty(coords));
+
+    TileChanges::Unsubscribe(cookie);
+    surface->SetOwner(surface->GetOwner());
+    TileChanges::Publish();
+    EXPECT_EQ(received.size(), 1u);
+}
+
+TEST_F(TileChangesTests, UnsubscribingDuringPublishSkipsNoListener)
+{
+    uint32_t firstCookie = 0;
+    uint32_t secondCookie = 0;
+    int32_t firstCalls = 0;
+    int32_t secondCalls = 0;
+    firstCookie = TileChanges::Subscribe([&](const TileChanges::ChangeSet&) {
+        firstCalls++;
+        TileChanges::Unsubscribe(firstCookie);
+    });
+    secondCookie = TileChanges::Subscribe([&](const TileChanges::ChangeSet&) { secondCalls++; });
+
+    auto* surface = MapGetSurfaceElementAt(TileCoordsXY{ 12, 12 });
+    ASSERT_NE(surface, nullptr);
+    surface->SetOwner(surface->GetOwner());
+    TileChanges::Publish();
+    EXPECT_EQ(firstCalls, 1);
+    EXPECT_EQ(secondCalls, 1);
+
+    surface->SetOwner(surface->GetOwner());
+    TileChanges::Publish();
+    EXPECT_EQ(firstCalls, 1);
+    EXPECT_EQ(secondCalls, 2);
+    TileChanges::Unsubscribe(secondCookie);
+}
@@ -0,0 +1,189 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2024 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/TileElement.h>
+#include <openrct2/world/tile_element/WallElement.h>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class TileElementStorageTests : public testing::Test
+{
+protected:
+    // No element of the test park is this high.
+    static constexpr int32_t kInsertHeight = 250;
+
+    void SetUp() override
+    {
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        ASSERT_TRUE(_context->Initialise());
+
+        ASSERT_TRUE(GetContext()->LoadParkFromFile(TestData::GetParkPath("tile-element-tests.sv6")));
+        GameLoadInit();
+    }
+
+    void TearDown() override
+    {
+        _context.reset();
+    }
+
+    static std::vector<std::vector<TileElement>> GetAllTiles()
+    {
+        const auto mapSize = GetGameState().MapSize;
+        std::vector<std::vector<TileElement>> tiles;
+        for (int32_t y = 0; y < mapSize.y; y++)
+        {
+            for (int32_t x = 0; x < mapSize.x; x++)
+            {
+                auto& elements = tiles.emplace_back();
+                const auto* element = MapGetFirstElementAt(TileCoordsXY{ x, y });
+                do
+                {
+                    elements.push_back(*element);
+                } while (!(element++)->IsLastForTile());
+            }
+        }
+        return tiles;
+    }
+
+    static bool TilesEqual(const std::vector<std::vector<TileElement>>& a, const std::vector<std::vector<TileElement>>& b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (a[i].size() != b[i].size()
+                || std::memcmp(a[i].data(), b[i].data(), a[i].size() * sizeof(TileElement)) != 0)
+                return false;
+        }
+        return true;
+    }
+
+    static void RemoveInsertedElements(const TileCoordsXY& coords)
+    {
+        for (;;)
+        {
+            TileElement* inserted = nullptr;
+            auto* element = MapGetFirstElementAt(coords);
+            do
+            {
+                if (element->BaseHeight == kInsertHeight)
+                {
+                    inserted = element;
+                    break;
+                }
+            } while (!(element++)->IsLastForTile());
+
+            if (inserted == nullptr)
+                break;
+            TileElementRemove(inserted);
+        }
+    }
+
+private:
+    std::unique_ptr<IContext> _context;
+};
+
+TEST_F(TileElementStorageTests, InsertKeepsTileOrdered)
+{
+    const auto coords = TileCoordsXY{ 19, 18 };
+    const auto* surface = MapGetSurfaceElementAt(coords);
+    ASSERT_NE(surface, nullptr);
+
+    const auto before = GetAllTiles();
+    for (int32_t height : { kInsertHeight, static_cast<int32_t>(surface->BaseHeight), kInsertHeight })
+    {
+        ASSERT_NE(TileElementInsert<WallElement>(TileCoordsXYZ{ coords, height }.ToCoordsXYZ(), 0b0001), nullptr);
+    }
+
+    const auto* element = MapGetFirstElementAt(coords);
+    int32_t lastHeight = 0;
+    size_t count = 0;
+    do
+    {
+        EXPECT_GE(element->BaseHeight, lastHeight);
+        lastHeight = element->BaseHeight;
+        count++;
+    } while (!(element++)->IsLastForTile());
+
+    const auto tileIndex = static_cast<size_t>(coords.y) * GetGameState().MapSize.x + coords.x;
+    EXPECT_EQ(count, before[tileIndex].size() + 3);
+}
+
+TEST_F(TileElementStorageTests, TilesGrowIntoFreedSlots)
+{
+    const auto coords = TileCoordsXY{ 10, 10 };
+    const auto loc = TileCoordsXYZ{ coords, kInsertHeight }.ToCoordsXYZ();
+    const auto before = GetAllTiles();
+
+    // The first insert moves the tile, after that it reuses the slots it leaves behind.
+    ASSERT_NE(TileElementInsert<WallElement>(loc, 0b0001), nullptr);
+    RemoveInsertedElements(coords);
+    const auto size = GetTileElements().size();
+    for (int32_t i = 0; i < 1000; i++)
+    {
+        ASSERT_NE(TileElementInsert<WallElement>(loc, 0b0001), nullptr);
+        RemoveInsertedElements(coords);
+    }
+
+    EXPECT_EQ(GetTileElements().size(), size);
+    EXPECT_TRUE(TilesEqual(GetAllTiles(), before));
+}
+
+TEST_F(TileElementStorageTests, FragmentedMapIsCompacted)
+{
+    const auto mapSize = GetGameState().MapSize;
+    const auto before = GetAllTiles();
+    const auto size = GetTileElements().size();
+
+    // Each round moves some of the tiles to the end of the array, leaving their old slots unused.
+    while (GetTileElements().size() < size * 2 + 0x4000)
+    {
+        for (int32_t y = 0; y < mapSize.y; y++)
+        {
+            for (int32_t x = 0; x < mapSize.x; x++)
+            {
+                const auto loc = TileCoordsXYZ{ x, y, kInsertHeight }.ToCoordsXYZ();
+                ASSERT_NE(TileElementInsert<WallElement>(loc, 0b0001), nullptr);
+            }
+        }
+    }
+    for (int32_t y = 0; y < mapSize.y; y++)
+    {
+        for (int32_t x = 0; x < mapSize.x; x++)
+        {
+            RemoveInsertedElements({ x, y });
+        }
+    }
+    EXPECT_TRUE(TilesEqual(GetAllTiles(), before));
+    EXPECT_GT(GetTileElements().size(), size);
+
+    // Each step only moves a few tiles, the map stays intact in between.
+    MapCompactTileElementsStep();
+    EXPECT_TRUE(TilesEqual(GetAllTiles(), before));
+
+    for (int32_t step = 0; step < 100000 && GetTileElements().size() > size; step++)
+    {
+        MapCompactTileElementsStep();
+    }
+    EXPECT_EQ(GetTileElements().size(), size);
+    EXPECT_TRUE(TilesEqual(GetAllTiles(), before));
+}